@@ -1,8 +1,10 @@
 #include "src/Application.h"
+#include "src/Headless.h"
 #include <iostream>
 
-//TODO REMOVE HEADLESS MODE 
-//REQUIRE SDL TO RUN
+//usage: SharpboyPlusPlus [--headless <rom.gb> [frames] [perf.jsonl]] [--trace <trace.sbt>] [--alloc-free-after <warmup frames>]
+//headless mode runs without sdl and dumps the performance counters as json lines
+//--trace also works with the ui, it starts on the first rom loaded, --alloc-free-after is headless only
 
 int main(int argc, char* argv[]) {
 	const std::string art = R"ART(+----------------------------------------------------------------------------------------------+
@@ -16,7 +18,35 @@ int main(int argc, char* argv[]) {
 )ART";
 
 	std::cout << art << std::endl;
+
+	//pull out the named options, what is left is positional
+	std::vector<std::string> arguments = std::vector<std::string>();
+	std::string trace_file_name = "";
+	int64_t alloc_free_after = -1;
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--trace" && i + 1 < argc) {
+			trace_file_name = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--alloc-free-after" && i + 1 < argc) {
+			alloc_free_after = std::stoll(argv[++i]);
+		}
+		else {
+			arguments.push_back(argv[i]);
+		}
+	}
+
+	if (arguments.size() >= 2 && arguments[0] == "--headless") {
+		uint64_t frames = arguments.size() >= 3 ? std::stoull(arguments[2]) : 0;
+		std::string output_file_name = arguments.size() >= 4 ? arguments[3] : "";
+		return run_headless(arguments[1], frames, output_file_name, trace_file_name, alloc_free_after);
+	}
 	
+	//the allocation check only means something without the frontend's own allocations in the way
+	if (alloc_free_after >= 0) {
+		printf("[SB] --alloc-free-after needs --headless\n");
+		return -1;
+	}
+
 	std::shared_ptr<Application> app = std::make_shared<Application>();
 	
 	if (!app->is_app_running()) {
@@ -24,5 +54,8 @@ int main(int argc, char* argv[]) {
 	}
 
 	app->set_application_pointer(app);
+	if (!trace_file_name.empty()) {
+		app->set_startup_trace(trace_file_name);
+	}
 	app->run();
 }
\ No newline at end of file
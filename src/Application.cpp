@@ -1,7 +1,13 @@
 #include "Application.h"
+#include <algorithm>
 
 Application::Application() {
-	init_main_SDL_components(sdl_running, &window, &renderer, &emu_texture, &debug_tilemap_texture);
+	init_main_SDL_components(sdl_running, &window, &renderer, &emu_texture, &debug_tilemap_texture, frame_format);
+
+	//never present faster than the display can show it
+	if (sdl_running) {
+		present_interval = std::chrono::nanoseconds((long long)(1000000000.0 / get_display_refresh_rate(&window)));
+	}
 }
 
 Application::~Application() {
@@ -36,8 +42,17 @@ void Application::create_new_emu_instance(const std::string& rom_file_name, cons
 		return;
 	}
 
+	instance->set_input_poller(&Application::poll_host_input, this);
+	host_buttons = button_NONE;
+
 	printf("[SB] Created new emulator instance successfully!\n");
 	emu_initialised = true;
+
+	//only the first rom is traced, later ones would overwrite the file
+	if (!startup_trace_file_name.empty()) {
+		start_instruction_trace(startup_trace_file_name);
+		startup_trace_file_name.clear();
+	}
 }
 
 void Application::close_emu_instance() {
@@ -65,23 +80,35 @@ void Application::start_new_rom() {
 
 void Application::run() {
 	const int GB_CPU_CLOCKSPEED = 4194304;
+	const int UI_SETTLE_FRAMES = 3; //imgui needs a couple of frames after input for hover/open states to catch up
+	const int IDLE_WAIT_MS = 250;
 	auto last_time = std::chrono::high_resolution_clock::now();
 
 	bool started_timing = false;
+	int ui_frames_left = UI_SETTLE_FRAMES;
+	timeline_set_thread_name("Main");
 
     while (sdl_running) {
-		//poll events for sdl
+		Timeline_scope host_frame_scope("Host Frame", "host");
+
+		//paused with nothing left to draw, sleep inside sdl until some input turns up
+		if (!emu_running && !frame_dirty && (ui_frames_left == 0 || imgui_hidden)) {
+			Timeline_scope idle_scope("Idle", "host");
+			SDL_WaitEventTimeout(nullptr, IDLE_WAIT_MS);
+		}
+
+		//poll events for sdl, any of them can change what the ui shows
         SDL_Event event;
-        poll_SDL_events(&event, self);
+        if (poll_SDL_events(&event, self)) {
+			ui_frames_left = UI_SETTLE_FRAMES;
+		}
         if (!sdl_running) break;
 
-		//clear background and render ui
-		clear_background(&renderer, 0, 0, 0, 255);
-        if (!imgui_hidden) {
-            draw_imgui(self, &debug_tilemap_texture);
-        }
-
         if (emu_running) {
+			//continuing after a break steps over the breakpoint that caused it
+			instance->resume_from_debug_break();
+			instance->sync_joypad();
+
 			if (!started_timing) {
 				started_timing = true;
 				last_time = std::chrono::high_resolution_clock::now();
@@ -91,6 +118,10 @@ void Application::run() {
 			auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time - last_time);
 
 			int cycles_to_execute = static_cast<int>((elapsed.count() * GB_CPU_CLOCKSPEED) / 1000000000);
+			auto emulation_start = std::chrono::steady_clock::now();
+			bool trace_emulation = timeline_is_recording();
+			uint64_t emulation_trace_start = trace_emulation ? timeline_now() : 0;
+			int cycles_requested = cycles_to_execute;
 
             while (cycles_to_execute > 0) {
 				int cycles = 0;
@@ -99,27 +130,69 @@ void Application::run() {
 
 				//update gb screen when a new frame is ready (on vblank)
 				if (instance->draw_ready()) {
-					update_gb_texture(&emu_texture, &renderer, self);
-					instance->reset_draw_ready();
+					add_host_time_since(perf_CPU, emulation_start);
+					hand_off_frame();
+					emulation_start = std::chrono::steady_clock::now();
 				}
 
 				last_time = current_time;
+
+				//stopped on a breakpoint/watchpoint, stay paused until continued from the debugger
+				if (instance->is_debug_break_pending()) {
+					emu_running = false;
+					break;
+				}
             }
 
-			//draw our gb texture every frame to avoid tearing
-			draw_gb_frame(&emu_texture, &renderer);
+			add_host_time_since(perf_CPU, emulation_start);
+			if (trace_emulation) {
+				timeline_add_span("Emulate", "emu", emulation_trace_start, timeline_now(), "cycles", cycles_requested);
+			}
+
+			//the debug windows show emulator state, which just moved on (or stopped on a break)
+			ui_frames_left = std::max(ui_frames_left, emu_running ? 1 : UI_SETTLE_FRAMES);
         }
 		else {
 			started_timing = false;
 		}
 
-		//render imgui for the main window (load/save rom etc)
-		if (!imgui_hidden) {
-			render_imgui(&renderer);
-		}
+		//only build a host frame once per display refresh, and only when the gb frame or the ui has changed
+		//the back buffer is undefined after a present, so a presented frame always has everything drawn in full
+		auto loop_time = std::chrono::steady_clock::now();
+		bool present_due = loop_time - last_present >= present_interval;
+		bool ui_drawn = !imgui_hidden && (ui_frames_left > 0 || frame_dirty);
+		if (present_due && (ui_drawn || frame_dirty)) {
+			if (ui_drawn) {
+				auto imgui_start = std::chrono::steady_clock::now();
+				Timeline_scope imgui_scope("draw_imgui", "frontend");
+				draw_imgui(self, &debug_tilemap_texture);
+				add_host_time_since(perf_IMGUI, imgui_start);
+				ui_frames_left = std::max(ui_frames_left - 1, 0);
+			}
+
+			//paused (break, pause button, stepping) still shows the last frame behind the debugger
+			clear_background(&renderer, 0, 0, 0, 255);
+			if (emu_initialised) {
+				draw_gb_frame(&emu_texture, &renderer);
+			}
+
+			//render imgui for the main window (load/save rom etc)
+			if (ui_drawn) {
+				auto imgui_start = std::chrono::steady_clock::now();
+				Timeline_scope imgui_scope("render_imgui", "frontend");
+				render_imgui(&renderer);
+				add_host_time_since(perf_IMGUI, imgui_start);
+			}
+
+			//present renderers
+			{
+				Timeline_scope present_scope("present_renderer", "frontend");
+				present_renderer(&renderer);
+			}
 
-		//present renderers
-		present_renderer(&renderer);
+			frame_dirty = false;
+			last_present = loop_time;
+		}
 
 		//delay for 1ms to sleep cpu a bit
 		std::this_thread::sleep_for(std::chrono::microseconds(100));
@@ -138,13 +211,66 @@ void Application::close() {
 //imgui + sdl helper functions
 void Application::toggle_imgui_shown() {
 	imgui_hidden = !imgui_hidden;
+
+	//hiding the ui has to present once without it, or its last frame stays on screen
+	frame_dirty = true;
+}
+
+void Application::mark_window_dirty() {
+	frame_dirty = true;
 }
 
-std::array<uint32_t, 160 * 144> Application::get_frame_buffer() {
-	return instance->get_frame_buffer();
+const std::array<byte, 160 * 144>& Application::get_shade_buffer() {
+	return instance->get_shade_buffer();
 }
 
-std::vector<std::string> Application::get_rom_file_names() {
+bool Application::take_dirty_lines(int& first_line, int& last_line) {
+	return instance->take_dirty_lines(first_line, last_line);
+}
+
+void Application::refresh_joypad(const bool& pump_events) {
+	if (instance == nullptr) {
+		return;
+	}
+
+	if (pump_events) {
+		SDL_PumpEvents();
+	}
+
+	byte buttons = read_host_buttons();
+	if (buttons == host_buttons) {
+		return;
+	}
+
+	if ((buttons & ~host_buttons) != 0 && !input_latency_pending) {
+		input_latency_pending = true;
+		input_press_frame = handed_off_frames;
+		input_press_buttons = buttons & ~host_buttons;
+		instance->take_joypad_read_buttons();
+	}
+
+	host_buttons = buttons;
+	instance->set_joypad_buttons(buttons);
+}
+
+const input_latency_stats& Application::get_input_latency() const {
+	return input_latency;
+}
+
+//called from inside the emulator on the guest's first JOYP read of a frame
+void Application::poll_host_input(void* context) {
+	((Application*)context)->refresh_joypad(true);
+}
+
+Frame_filter* Application::get_frame_filter() {
+	if (frame_filter_pipeline == nullptr) {
+		frame_filter_pipeline = std::make_unique<Frame_filter>();
+	}
+
+	return frame_filter_pipeline.get();
+}
+
+const std::vector<std::string>& Application::get_rom_file_names() {
 	return rom_file_names;
 }
 
@@ -172,10 +298,175 @@ void Application::refresh_rom_file_names() {
 	printf("[SHARPBOY]:: Success loading roms from %s.\n", rom_path);
 }
 
-const cpu_data& Application::get_cpu_data() {
+cpu_data Application::get_cpu_data() {
 	return instance->get_cpu_data();
 }
 
-std::array<uint32_t, 64> Application::get_tile_map_data(const int& index) {
-	return instance->get_next_tile(index);
-}
\ No newline at end of file
+cpu_engines Application::get_cpu_engine() {
+	return instance->get_cpu_engine();
+}
+
+void Application::set_cpu_engine(const cpu_engines& engine) {
+	instance->set_cpu_engine(engine);
+}
+
+const perf_stats& Application::get_perf_stats() {
+	return instance->get_perf_stats();
+}
+
+bool Application::start_instruction_trace(const std::string& file_name) {
+	return instance->start_instruction_trace(file_name);
+}
+
+void Application::stop_instruction_trace() {
+	instance->stop_instruction_trace();
+}
+
+bool Application::is_instruction_trace_running() {
+	return instance->is_instruction_trace_running();
+}
+
+void Application::set_startup_trace(const std::string& file_name) {
+	startup_trace_file_name = file_name;
+}
+
+void Application::add_breakpoint(const ushort& address, const int& bank) {
+	instance->add_breakpoint(address, bank);
+}
+
+void Application::remove_breakpoint(const int& index) {
+	instance->remove_breakpoint(index);
+}
+
+void Application::add_watchpoint(const ushort& address, const watch_access& access, const watch_conditions& condition, const byte& value) {
+	instance->add_watchpoint(address, access, condition, value);
+}
+
+void Application::remove_watchpoint(const int& index) {
+	instance->remove_watchpoint(index);
+}
+
+const Debugger* Application::get_debugger() {
+	return instance->get_debugger();
+}
+
+const std::vector<disassembly_line>& Application::get_disassembly(const ushort& address, const int& lines_before, const int& lines_after) {
+	return instance->get_disassembly(address, lines_before, lines_after);
+}
+
+const Memory_view& Application::refresh_memory_view() {
+	return instance->refresh_memory_view();
+}
+
+void Application::edit_memory(const ushort& address, const byte& value) {
+	instance->edit_memory(address, value);
+}
+
+//runs paused emulation forward by one instruction/scanline/frame, a break on the way ends the step early
+void Application::debug_step(const debug_step_modes& mode) {
+	//scanlines take 456 cycles, a frame 70224, anything past two frames means the lcd is off
+	const int MAX_STEP_CYCLES = 70224 * 2;
+
+	emu_running = false;
+	instance->resume_from_debug_break();
+
+	byte start_ly = instance->io_instant_read(io_LY);
+	int cycles = 0;
+	while (cycles < MAX_STEP_CYCLES) {
+		cycles += instance->run_next_instruction();
+
+		bool frame_done = instance->draw_ready();
+		if (frame_done) {
+			hand_off_frame();
+		}
+
+		if (instance->is_debug_break_pending() || mode == step_INSTRUCTION) {
+			break;
+		}
+		else if (mode == step_SCANLINE && instance->io_instant_read(io_LY) != start_ly) {
+			break;
+		}
+		else if (mode == step_FRAME && frame_done) {
+			break;
+		}
+	}
+}
+
+void Application::hand_off_frame() {
+	Timeline_scope vblank_scope("VBlank Handoff", "emu");
+
+	auto upload_start = std::chrono::steady_clock::now();
+	{
+		Timeline_scope upload_scope("update_gb_texture", "frontend");
+		handed_off_frames++;
+		bool screen_changed = update_gb_texture(&emu_texture, &renderer, self);
+		if (screen_changed) {
+			frame_dirty = true;
+		}
+
+		//the sample ends on the frame a guest JOYP read returned the pressed button, not on any screen change
+		if (input_latency_pending) {
+			uint64_t frames = handed_off_frames - input_press_frame;
+			bool press_read = (instance->take_joypad_read_buttons() & input_press_buttons) != 0;
+			if (press_read && frames <= INPUT_LATENCY_TIMEOUT_FRAMES) {
+				input_latency.last_frames = (int)frames;
+				input_latency.samples++;
+				input_latency.total_frames += frames;
+			}
+			input_latency_pending = press_read ? false : frames < INPUT_LATENCY_TIMEOUT_FRAMES;
+		}
+	}
+	add_host_time_since(perf_TEXTURE_UPLOAD, upload_start);
+
+	instance->reset_draw_ready();
+	instance->complete_perf_frame();
+}
+
+void Application::add_host_time_since(const perf_components& component, const std::chrono::steady_clock::time_point& start) {
+	if (instance == nullptr) {
+		return;
+	}
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+	instance->add_host_time(component, (uint64_t)elapsed.count());
+}
+
+bool Application::take_viewer_dirty_tiles(std::array<bool, TILE_CACHE_TILES>& dirty_tiles) {
+	return instance->take_viewer_dirty_tiles(dirty_tiles);
+}
+
+void Application::fill_tile_pixels(const int& index, uint32_t* pixels, const int& pitch) {
+	instance->fill_tile_pixels(index, pixels, pitch);
+}
+
+byte Application::take_ppu_view_changes(const ppu_viewers& viewer) {
+	return instance->take_ppu_view_changes(viewer);
+}
+
+void Application::fill_map_pixels(const int& map, uint32_t* pixels) {
+	instance->fill_map_pixels(map, pixels);
+}
+
+void Application::fill_sprite_pixels(const byte& tile, const byte& attributes, uint32_t* pixels, const int& pitch) {
+	instance->fill_sprite_pixels(tile, attributes, pixels, pitch);
+}
+
+const std::array<byte, OAM_SIZE>& Application::get_oam() {
+	return instance->get_oam();
+}
+
+byte Application::read_io_register(const byte& io_target) {
+	return instance->io_instant_read(io_target);
+}
+
+#ifdef SHARPBOY_PROFILER
+Profiler* Application::get_profiler() {
+	return instance->get_profiler();
+}
+#endif
+
+#ifdef SHARPBOY_HEATMAP
+Heatmap* Application::get_heatmap() {
+	return instance->get_heatmap();
+}
+#endif
\ No newline at end of file
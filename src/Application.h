@@ -1,6 +1,8 @@
 #pragma once
 #include <SDL3/SDL.h>
 #include "emulator/Emulator.h"
+#include "emulator/Timeline_trace.h"
+#include "emulator/Frame_filter.h"
 #include "emulator/emu_visuals/Graphics.h"
 
 #include <thread>
@@ -25,20 +27,61 @@ public:
 	void close();
 
 	//sdl rendering for emu instance
-	std::array<uint32_t, 160 * 144> get_frame_buffer();
+	const std::array<byte, 160 * 144>& get_shade_buffer();
+	bool take_dirty_lines(int& first_line, int& last_line);
+	Frame_filter* get_frame_filter();
+
+	//joypad, host buttons are read again right before the guest's first JOYP read each frame
+	void refresh_joypad(const bool& pump_events);
+	const input_latency_stats& get_input_latency() const;
 
 	//imgui + sdl helpers
 	void toggle_imgui_shown();
-	std::vector<std::string> get_rom_file_names();
+	void mark_window_dirty(); //the window contents were lost or went stale, present again even if the gb frame has not changed
+	const std::vector<std::string>& get_rom_file_names();
 	void refresh_rom_file_names();
-	const cpu_data& get_cpu_data();
-    std::array<uint32_t, 64> get_tile_map_data(const int& index);
+	cpu_data get_cpu_data(); //by value, the emulator hands back a materialised copy
+	cpu_engines get_cpu_engine();
+	void set_cpu_engine(const cpu_engines& engine);
+	bool take_viewer_dirty_tiles(std::array<bool, TILE_CACHE_TILES>& dirty_tiles);
+	void fill_tile_pixels(const int& index, uint32_t* pixels, const int& pitch);
+	byte take_ppu_view_changes(const ppu_viewers& viewer);
+	void fill_map_pixels(const int& map, uint32_t* pixels);
+	void fill_sprite_pixels(const byte& tile, const byte& attributes, uint32_t* pixels, const int& pitch);
+	const std::array<byte, OAM_SIZE>& get_oam();
+	byte read_io_register(const byte& io_target);
+	const perf_stats& get_perf_stats();
+	bool start_instruction_trace(const std::string& file_name);
+	void stop_instruction_trace();
+	bool is_instruction_trace_running();
+	void set_startup_trace(const std::string& file_name); //--trace on the command line, started once the first rom is loaded
+
+	//debugger, stepping pauses the emulator and runs it forward from the ui thread
+	void add_breakpoint(const ushort& address, const int& bank);
+	void remove_breakpoint(const int& index);
+	void add_watchpoint(const ushort& address, const watch_access& access, const watch_conditions& condition, const byte& value);
+	void remove_watchpoint(const int& index);
+	const Debugger* get_debugger();
+	void debug_step(const debug_step_modes& mode);
+	const std::vector<disassembly_line>& get_disassembly(const ushort& address, const int& lines_before, const int& lines_after);
+	const Memory_view& refresh_memory_view();
+	void edit_memory(const ushort& address, const byte& value);
+#ifdef SHARPBOY_PROFILER
+	Profiler* get_profiler();
+#endif
+#ifdef SHARPBOY_HEATMAP
+	Heatmap* get_heatmap();
+#endif
 
 	//todo move this stuff to a static class which stores this stuff 
 	//timing for emulator to run (todo eventually sync to audio emulation)
 	void start_timers_for_new_instance();
 	void calculate_elapsed_time();
 
+private:
+	void hand_off_frame();
+	void add_host_time_since(const perf_components& component, const std::chrono::steady_clock::time_point& start);
+
 public:
 	bool imgui_hidden = true;
 	int selected_rom_index = 0;
@@ -46,22 +89,52 @@ public:
 	bool emu_initialised = false;
 	bool emu_running = false;
 	bool use_boot_rom_next_instance = false;
+	int colour_scheme = scheme_GREY;
+	frame_formats frame_format = frame_RGBA8888; //emu_texture's layout, the renderer's preferred one when we can write it
+	int frame_filter = filter_NONE;
 
 	bool basic_debug_shown = false;
 	bool ppu_debug_shown = false;
+	bool bg_map_viewer_shown = false;
+	bool oam_viewer_shown = false;
+	bool profiler_shown = false;
+	bool heatmap_shown = false;
+	bool performance_shown = false;
+	bool debugger_shown = false;
+	bool disassembly_shown = false;
+	bool memory_viewer_shown = false;
 
 	SDL_Renderer* renderer = nullptr;
 
 
+private:
+	static void poll_host_input(void* context);
+
 private:
 	std::shared_ptr<Application> self = nullptr;
 	std::shared_ptr<Emulator> instance = nullptr;
 	std::vector<std::string> rom_file_names = std::vector<std::string>{"=== ROMS ==="};
+	std::string startup_trace_file_name = "";
 
 	SDL_Window* window = nullptr;
 	SDL_Texture* emu_texture = nullptr; 
 	SDL_Texture* debug_tilemap_texture = nullptr;
+	std::unique_ptr<Frame_filter> frame_filter_pipeline = nullptr; //made on first use so its threads only exist when a filter is picked
 
 	bool initialised = false;
 	bool sdl_running = false;
+
+	//set when emu_texture took new pixels, cleared once they are presented
+	bool frame_dirty = true;
+	std::chrono::steady_clock::time_point last_present = std::chrono::steady_clock::time_point();
+	std::chrono::nanoseconds present_interval = std::chrono::nanoseconds(16666667);
+
+	//a press is timed in handed off frames until the guest reads it through JOYP, or dropped if it never does
+	const uint64_t INPUT_LATENCY_TIMEOUT_FRAMES = 30;
+	byte host_buttons = button_NONE;
+	uint64_t handed_off_frames = 0;
+	uint64_t input_press_frame = 0;
+	byte input_press_buttons = button_NONE;
+	bool input_latency_pending = false;
+	input_latency_stats input_latency = input_latency_stats();
 };
\ No newline at end of file
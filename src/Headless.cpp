@@ -0,0 +1,96 @@
+#include "Headless.h"
+#include "externals/nlohmann/json.hpp"
+
+static nlohmann::json perf_frame_to_json(const perf_stats& stats) {
+	const perf_frame& frame = stats.last_frame;
+
+	nlohmann::json line = nlohmann::json();
+	line["frame"] = stats.frame_count;
+	line["cycles"] = frame.cycles;
+	line["instructions"] = frame.instructions;
+	line["bus_reads"] = frame.bus_reads;
+	line["bus_writes"] = frame.bus_writes;
+#ifdef SHARPBOY_ALLOC_TRACKING
+	line["allocations"] = frame.allocations;
+	line["allocated_bytes"] = frame.allocated_bytes;
+#endif
+	line["host_ns"] = {
+		{ "cpu", frame.host_ns[perf_CPU] },
+		{ "ppu", frame.host_ns[perf_PPU] },
+		{ "timers", frame.host_ns[perf_TIMERS] },
+		{ "dma", frame.host_ns[perf_DMA] },
+		{ "texture_upload", frame.host_ns[perf_TEXTURE_UPLOAD] },
+		{ "imgui", frame.host_ns[perf_IMGUI] },
+	};
+	line["cycles_per_second"] = stats.cycles_per_second;
+	line["frames_per_second"] = stats.frames_per_second;
+
+	return line;
+}
+
+int run_headless(const std::string& rom_file_name, const uint64_t& frames, const std::string& output_file_name, const std::string& trace_file_name, const int64_t& alloc_free_after) {
+#ifndef SHARPBOY_ALLOC_TRACKING
+	if (alloc_free_after >= 0) {
+		printf("[SB] Allocation checks need a build configured with -DSHARPBOY_ALLOC_TRACKING=ON\n");
+		return -4;
+	}
+#endif
+
+	std::shared_ptr<Emulator> instance = std::make_shared<Emulator>();
+	instance->set_emu_pointer(instance);
+	if (instance->initialise_emu_instance(rom_file_name, false) < 0) {
+		return -1;
+	}
+
+	std::ofstream output_file;
+	if (!output_file_name.empty()) {
+		output_file.open(output_file_name);
+		if (!output_file) {
+			printf("[SB] Failed to open %s for writing\n", output_file_name.c_str());
+			return -2;
+		}
+	}
+	std::ostream& output = output_file_name.empty() ? std::cout : output_file;
+
+	if (!trace_file_name.empty() && !instance->start_instruction_trace(trace_file_name)) {
+		return -3;
+	}
+
+	printf("[SB] Running %s headless\n", rom_file_name.c_str());
+
+	//no frontend here, so the whole emulation time lands in the cpu bucket and the rest stays zero
+	uint64_t frames_completed = 0;
+	int result = 0;
+	auto emulation_start = std::chrono::steady_clock::now();
+	while (frames == 0 || frames_completed < frames) {
+		instance->run_next_instruction();
+
+		if (instance->draw_ready()) {
+			auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - emulation_start);
+			instance->add_host_time(perf_CPU, (uint64_t)elapsed.count());
+			instance->complete_perf_frame();
+			instance->reset_draw_ready();
+
+			output << perf_frame_to_json(instance->get_perf_stats()).dump() << "\n";
+			frames_completed++;
+
+#ifdef SHARPBOY_ALLOC_TRACKING
+			const perf_frame& frame = instance->get_perf_stats().last_frame;
+			if (alloc_free_after >= 0 && frames_completed > (uint64_t)alloc_free_after && frame.allocations > 0) {
+				printf("[SB] Frame %llu allocated %llu times (%llu bytes) after warmup\n", (unsigned long long)frames_completed, (unsigned long long)frame.allocations, (unsigned long long)frame.allocated_bytes);
+				result = -4;
+				break;
+			}
+
+			//the json line above is the driver's, not the emulator's
+			instance->reset_perf_alloc_baseline();
+#endif
+
+			emulation_start = std::chrono::steady_clock::now();
+		}
+	}
+
+	output.flush();
+	instance->close_emulator();
+	return result;
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "emulator/Emulator.h"
+
+//runs a rom without sdl/imgui for the given number of frames (0 runs until killed)
+//the performance counters of every frame are written as one json object per line to output_file_name, or stdout when empty
+//trace_file_name optionally records a binary instruction trace for the whole run
+//alloc_free_after >= 0 fails the run (returns -4) when any frame past that many warmup frames touches the heap, needs SHARPBOY_ALLOC_TRACKING
+int run_headless(const std::string& rom_file_name, const uint64_t& frames, const std::string& output_file_name, const std::string& trace_file_name, const int64_t& alloc_free_after = -1);
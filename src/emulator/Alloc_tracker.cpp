@@ -0,0 +1,122 @@
+#include "Alloc_tracker.h"
+
+#ifdef SHARPBOY_ALLOC_TRACKING
+#include <new>
+#include <cstdlib>
+
+//plain data so it needs no constructor, operator new can run before/after anything else on a thread
+static thread_local alloc_counts thread_alloc_counts;
+
+const alloc_counts& get_thread_alloc_counts() {
+	return thread_alloc_counts;
+}
+
+static void* tracked_allocate(std::size_t size) {
+	thread_alloc_counts.allocations++;
+	thread_alloc_counts.allocated_bytes += size;
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* tracked_allocate_aligned(std::size_t size, std::align_val_t alignment) {
+	thread_alloc_counts.allocations++;
+	thread_alloc_counts.allocated_bytes += size;
+
+	std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+	return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+	//aligned_alloc wants the size rounded up to the alignment
+	return std::aligned_alloc(align, ((size == 0 ? 1 : size) + align - 1) / align * align);
+#endif
+}
+
+static void tracked_free(void* pointer) {
+	if (pointer != nullptr) {
+		thread_alloc_counts.frees++;
+		std::free(pointer);
+	}
+}
+
+static void tracked_free_aligned(void* pointer) {
+	if (pointer != nullptr) {
+		thread_alloc_counts.frees++;
+#ifdef _MSC_VER
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+}
+
+void* operator new(std::size_t size) {
+	void* pointer = tracked_allocate(size);
+	if (pointer == nullptr) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return tracked_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return tracked_allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	void* pointer = tracked_allocate_aligned(size, alignment);
+	if (pointer == nullptr) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept {
+	tracked_free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+	tracked_free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+	tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+	tracked_free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+	tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+	tracked_free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+	tracked_free_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+	tracked_free_aligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+	tracked_free_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+	tracked_free_aligned(pointer);
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "_definitions.h"
+
+//heap allocation accounting, only built with -DSHARPBOY_ALLOC_TRACKING=ON (see CMakeLists.txt)
+//the global operator new/delete are replaced and count per thread, so a frame's numbers only cover the thread that ran it
+
+struct alloc_counts {
+	uint64_t allocations = 0;
+	uint64_t frees = 0;
+	uint64_t allocated_bytes = 0;
+};
+
+#ifdef SHARPBOY_ALLOC_TRACKING
+const alloc_counts& get_thread_alloc_counts();
+#endif
@@ -0,0 +1,231 @@
+#include "CPU.h"
+#include "Emulator.h"
+#include "Opcode_info.h"
+#include <algorithm>
+
+//public
+void CPU::set_engine(const cpu_engines& engine) {
+	this->engine = engine;
+	reset_block_cursor();
+}
+
+const cpu_engines& CPU::get_engine() const {
+	return engine;
+}
+
+void CPU::invalidate_code_page(const byte& page) {
+	cached_page_blocks& page_blocks = blocks_in_page[page];
+	for (int i = 0; i < page_blocks.count; i++) {
+		ushort start_address = page_blocks.starts[i];
+		if (block_cache[start_address] != nullptr) {
+			release_cached_block(std::move(block_cache[start_address]));
+		}
+	}
+
+	page_blocks.count = 0;
+	emulator_ptr->clear_memory_page_flag(page, page_CODE);
+
+	//code rewritten in this page has to get hot again before it is cached
+	std::fill_n(block_entry_counts.begin() + (page << 8), 0x100, 0);
+
+	//links into the erased blocks are stale from here on, as may be the running block
+	block_generation++;
+	reset_block_cursor();
+}
+
+void CPU::invalidate_block_cache() {
+	for (int page = 0; page < (int)blocks_in_page.size(); page++) {
+		if (blocks_in_page[page].count > 0) {
+			invalidate_code_page((byte)page);
+		}
+	}
+
+	reset_block_cursor();
+}
+
+//privates
+void CPU::allocate_block_pool() {
+	free_blocks.reserve(MAX_CACHED_BLOCKS);
+	for (int i = 0; i < MAX_CACHED_BLOCKS; i++) {
+		//sized for the longest block up front so decoding into it never reallocates
+		std::unique_ptr<cached_block> block = std::make_unique<cached_block>();
+		block->instructions.reserve(MAX_CACHED_BLOCK_LENGTH);
+		free_blocks.push_back(std::move(block));
+	}
+}
+
+const cached_instruction* CPU::fetch_cached_instruction() {
+	//carry on through the current block while execution falls straight through it
+	if (current_block != nullptr && data.pc == next_cached_address && current_block_index < current_block->instructions.size()) {
+		const cached_instruction* instruction = &current_block->instructions[current_block_index++];
+		next_cached_address = (ushort)(data.pc + instruction->length);
+		return instruction;
+	}
+
+	cached_block* block = nullptr;
+
+	//leaving a block, follow its link if it was last seen going to the same address
+	cached_block* previous = current_block;
+	cached_block_link* link = nullptr;
+	if (previous != nullptr) {
+		link = &previous->links[data.pc == (ushort)(previous->end_address + 1) ? 0 : 1];
+		if (link->block != nullptr && link->address == data.pc && link->generation == block_generation) {
+			block = link->block;
+		}
+	}
+
+	if (block == nullptr) {
+		uint32_t generation = block_generation;
+		block = find_cached_block(data.pc);
+
+		//a rebuild may have freed the block we are leaving, only link when nothing was dropped
+		if (block != nullptr && link != nullptr && generation == block_generation) {
+			link->address = data.pc;
+			link->block = block;
+			link->generation = block_generation;
+		}
+	}
+
+	current_block = block;
+	if (block == nullptr) {
+		return nullptr;
+	}
+
+	current_block_index = 1;
+
+	const cached_instruction* instruction = &block->instructions[0];
+	next_cached_address = (ushort)(data.pc + instruction->length);
+	return instruction;
+}
+
+cached_block* CPU::find_cached_block(const ushort& address) {
+	if (get_cache_region(address) < 0) {
+		return nullptr;
+	}
+
+	int bank = emulator_ptr->get_memory_bank(address);
+
+	cached_block* block = block_cache[address].get();
+	if (block != nullptr && block->bank == bank) {
+		return block;
+	}
+
+	//cold code stays on the interpreter path until it has been entered a few times
+	if (block_entry_counts[address] < BLOCK_HOT_THRESHOLD) {
+		block_entry_counts[address]++;
+		return nullptr;
+	}
+
+	return build_cached_block(address, bank);
+}
+
+cached_block* CPU::build_cached_block(const ushort& address, const int& bank) {
+	std::unique_ptr<cached_block> block = acquire_cached_block(address, bank);
+
+	int region = get_cache_region(address);
+	ushort pc = address;
+
+	while (block->instructions.size() < MAX_CACHED_BLOCK_LENGTH) {
+		//decoding is not a guest access, read like the interpreter's fetch so watchpoints, the heatmap and bus counters never see it
+		byte opcode = emulator_ptr->memory_instant_read(pc);
+		byte length = instruction_lengths[opcode];
+
+		//leave invalid opcodes and instructions straddling a region/bank edge to the interpreter
+		if (length == 0 || get_cache_region((ushort)(pc + length - 1)) != region) {
+			break;
+		}
+
+		cached_instruction instruction = cached_instruction();
+		instruction.opcode = opcode;
+		instruction.length = length;
+		instruction.handler = opcode_handlers[opcode];
+		for (int i = 1; i < length; i++) {
+			instruction.operands[i - 1] = emulator_ptr->memory_instant_read((ushort)(pc + i));
+		}
+
+		block->instructions.push_back(instruction);
+		pc += length;
+
+		if (ends_cached_block(opcode) || get_cache_region(pc) != region) {
+			break;
+		}
+	}
+
+	if (block->instructions.empty()) {
+		release_cached_block(std::move(block));
+		return nullptr;
+	}
+
+	block->end_address = (ushort)(pc - 1);
+	return insert_cached_block(std::move(block));
+}
+
+cached_block* CPU::insert_cached_block(std::unique_ptr<cached_block> block) {
+	ushort address = block->start_address;
+
+	//flag every page the block covers so writes there invalidate it
+	for (int page = (block->start_address >> 8); page <= (block->end_address >> 8); page++) {
+		cached_page_blocks& page_blocks = blocks_in_page[page];
+		ushort* starts_end = page_blocks.starts.data() + page_blocks.count;
+		if (std::find(page_blocks.starts.data(), starts_end, address) == starts_end) {
+			page_blocks.starts[page_blocks.count++] = address;
+		}
+
+		emulator_ptr->set_memory_page_flag((byte)page, page_CODE);
+	}
+
+	//replacing a block built for another bank leaves links to it stale
+	if (block_cache[address] != nullptr) {
+		release_cached_block(std::move(block_cache[address]));
+		block_generation++;
+	}
+
+	block_cache[address] = std::move(block);
+	return block_cache[address].get();
+}
+
+std::unique_ptr<cached_block> CPU::acquire_cached_block(const ushort& address, const int& bank) {
+	//out of blocks, start the cache over like a full code cache instead of allocating more
+	if (free_blocks.empty()) {
+		invalidate_block_cache();
+	}
+
+	std::unique_ptr<cached_block> block = std::move(free_blocks.back());
+	free_blocks.pop_back();
+
+	block->bank = bank;
+	block->start_address = address;
+	block->end_address = address;
+	block->instructions.clear();
+	block->links = std::array<cached_block_link, 2>();
+	return block;
+}
+
+void CPU::release_cached_block(std::unique_ptr<cached_block> block) {
+	free_blocks.push_back(std::move(block));
+}
+
+//only regions without read side effects are cached: rom bank 0, rom bank n, wram and hram
+int CPU::get_cache_region(const ushort& address) {
+	if (address < 0x4000) {
+		return 0;
+	}
+	else if (address < 0x8000) {
+		return 1;
+	}
+	else if (address >= 0xc000 && address < 0xe000) {
+		return 2;
+	}
+	else if (address >= 0xff80 && address < 0xffff) {
+		return 3;
+	}
+
+	return -1;
+}
+
+void CPU::reset_block_cursor() {
+	current_block = nullptr;
+	current_block_index = 0;
+	current_instruction = nullptr;
+	current_operand_index = 0;
+}
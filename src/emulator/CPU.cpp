@@ -10,6 +10,8 @@ CPU::CPU(std::shared_ptr<Emulator> emulator_ptr) {
 	else {
 		initialised = false;
 	}
+
+	allocate_block_pool();
 }
 
 CPU::~CPU() {
@@ -27,59 +29,150 @@ const bool CPU::is_cpu_initialised() {
 
 void CPU::reset_cpu(const bool& check_sum_zero) {
 	bool using_boot_rom = emulator_ptr->is_using_boot_rom();
-	std::unique_ptr<cpu_data> new_data = std::make_unique<cpu_data>();
+	cpu_data new_data = cpu_data();
 	
-	new_data->a = 0x00;
-	new_data->f = 0x00;
-	new_data->b = 0x00;
-	new_data->c = 0x00;
-	new_data->d = 0x00;
-	new_data->e = 0x00;
-	new_data->h = 0x00;
-	new_data->l = 0x00;
-
-	new_data->pc = 0x0000;
-	new_data->sp = 0x0000;
+	new_data.a = 0x00;
+	new_data.f = 0x00;
+	new_data.b = 0x00;
+	new_data.c = 0x00;
+	new_data.d = 0x00;
+	new_data.e = 0x00;
+	new_data.h = 0x00;
+	new_data.l = 0x00;
+
+	new_data.pc = 0x0000;
+	new_data.sp = 0x0000;
+
+	invalidate_block_cache();
+	lazy_op = lazy_NONE;
+	elapsed_cycles = 0;
 
 	if (using_boot_rom) {
-		this->data = *new_data;
+		this->data = new_data;
 		return;
 	}
 
-	new_data->a = 0x01;
-	new_data->f = check_sum_zero ? 0x80 : 0xb0;
-	new_data->b = 0x00;
-	new_data->c = 0x13;
-	new_data->d = 0x00;
-	new_data->e = 0xd8;
-	new_data->h = 0x01;
-	new_data->l = 0x4d;
+	new_data.a = 0x01;
+	new_data.f = check_sum_zero ? 0x80 : 0xb0;
+	new_data.b = 0x00;
+	new_data.c = 0x13;
+	new_data.d = 0x00;
+	new_data.e = 0xd8;
+	new_data.h = 0x01;
+	new_data.l = 0x4d;
 
-	new_data->pc = 0x0100;
-	new_data->sp = 0xfffe;
+	new_data.pc = 0x0100;
+	new_data.sp = 0xfffe;
 
-	this->data = *new_data;
+	this->data = new_data;
 }
 
 void CPU::step_cpu(int& cycles, const bool& print_debug_to_console) {
-	/*
-	FILE* f = fopen("logs.txt", "w");
-	if (f) {
-		byte one = emulator_ptr->memory_instant_read(data.pc);
-		byte two = emulator_ptr->memory_instant_read(data.pc + 1);
-		byte three = emulator_ptr->memory_instant_read(data.pc + 2);
-		byte four = emulator_ptr->memory_instant_read(data.pc + 3);
-
-		fprintf(f, "A: %02X A: %02X B: %02X C: %02X D: %02X E: %02X H: %02X L: %02X SP: %04X PC: 00:%04X (%02X %02X %02X %02X)\n",
-			data.a, data.f, data.b, data.c, data.d, data.e, data.h, data.l, data.sp, data.pc, one, two, three, four);
+	int cycles_before = cycles;
+#ifdef SHARPBOY_PROFILER
+	ushort profiled_pc = data.pc;
+	(this->*step_path)(cycles, print_debug_to_console);
+	emulator_ptr->profile_step(profiled_pc, cycles - cycles_before);
+#else
+	(this->*step_path)(cycles, print_debug_to_console);
+#endif
+	elapsed_cycles += cycles - cycles_before;
+}
 
-		printf("A: %02X A: %02X B: %02X C: %02X D: %02X E: %02X H: %02X L: %02X SP: %04X PC: 00:%04X (%02X %02X %02X %02X)\n",
-			data.a, data.f, data.b, data.c, data.d, data.e, data.h, data.l, data.sp, data.pc, one, two, three, four);
-		fclose(f);
+void CPU::set_instruction_trace(Instruction_trace* instruction_trace) {
+	this->instruction_trace = instruction_trace;
+	step_hooks = instruction_trace != nullptr ? (step_hooks | hook_TRACE) : (step_hooks & ~hook_TRACE);
+	step_path = step_hooks != hook_NONE ? &CPU::execute_hooked_step : &CPU::execute_step;
+}
+
+void CPU::set_breakpoints_armed(const bool& armed) {
+	step_hooks = armed ? (step_hooks | hook_BREAKPOINTS) : (step_hooks & ~hook_BREAKPOINTS);
+	step_path = step_hooks != hook_NONE ? &CPU::execute_hooked_step : &CPU::execute_step;
+}
+
+void CPU::save_state(cpu_snapshot& snapshot) {
+	materialise_flags();
+
+	snapshot.data = data;
+	snapshot.enable_ime_next_cycle = enable_ime_next_cycle;
+	snapshot.interrupt_pending = interrupt_pending;
+	snapshot.halt_bug_next_instruction = halt_bug_next_instruction;
+	snapshot.elapsed_cycles = elapsed_cycles;
+}
+
+void CPU::load_state(const cpu_snapshot& snapshot) {
+	data = snapshot.data;
+	enable_ime_next_cycle = snapshot.enable_ime_next_cycle;
+	interrupt_pending = snapshot.interrupt_pending;
+	halt_bug_next_instruction = snapshot.halt_bug_next_instruction;
+	elapsed_cycles = snapshot.elapsed_cycles;
+	lazy_op = lazy_NONE;
+
+	//memory came back from the snapshot, so drop every block and the code flags saved with it
+	invalidate_block_cache();
+	for (int page = 0; page < 0x100; page++) {
+		emulator_ptr->clear_memory_page_flag((byte)page, page_CODE);
 	}
-	*/
-	
+}
+
+uint64_t CPU::get_state_hash(const uint64_t& hash) {
+	//flags are compared as the guest sees them, not by how lazily they are held
+	materialise_flags();
+
+	uint64_t state_hash = hash_state_value(hash, data);
+	state_hash = hash_state_value(state_hash, enable_ime_next_cycle);
+	state_hash = hash_state_value(state_hash, halt_bug_next_instruction);
+	return hash_state_value(state_hash, elapsed_cycles);
+}
+
+const uint64_t& CPU::get_elapsed_cycles() const {
+	return elapsed_cycles;
+}
+
+const cpu_data& CPU::get_data() {
+	materialise_flags();
+	return data;
+}
+
+//privates
+void CPU::record_trace() {
+	materialise_flags();
+
+	instruction_trace_record trace_record = instruction_trace_record();
+	trace_record.cycle = elapsed_cycles;
+	trace_record.af = data.af;
+	trace_record.bc = data.bc;
+	trace_record.de = data.de;
+	trace_record.hl = data.hl;
+	trace_record.sp = data.sp;
+	trace_record.pc = data.pc;
+	for (int i = 0; i < 4; i++) {
+		trace_record.pc_bytes[i] = emulator_ptr->memory_instant_read((ushort)(data.pc + i));
+	}
+
+	instruction_trace->record(trace_record);
+}
+
+//step_path while a hook is set, so unhooked steps never test for them
+void CPU::execute_hooked_step(int& cycles, const bool& print_debug_to_console) {
+	//halted steps run no instruction so they are left out, same as gameboy-doctor logs
+	if (!data.halted) {
+		//stop before the instruction runs, the step takes no cycles
+		if ((step_hooks & hook_BREAKPOINTS) && emulator_ptr->check_breakpoint(data.pc)) {
+			return;
+		}
+
+		if (step_hooks & hook_TRACE) {
+			record_trace();
+		}
+	}
+
+	execute_step(cycles, print_debug_to_console);
+}
+
+void CPU::execute_step(int& cycles, const bool& print_debug_to_console) {
 	if (print_debug_to_console) {
+		materialise_flags();
 		byte one = emulator_ptr->bus_read(data.pc);
 		byte two = emulator_ptr->bus_read(data.pc + 1);
 		byte three = emulator_ptr->bus_read(data.pc + 2);
@@ -121,23 +214,47 @@ void CPU::step_cpu(int& cycles, const bool& print_debug_to_console) {
 			enable_ime_next_cycle = false;
 		}
 
+#ifdef SHARPBOY_HEATMAP
+		//halt bug runs the opcode at pc again, either way it was fetched from pc - 1
+		emulator_ptr->heatmap_execute((ushort)(data.pc - 1), opcode);
+#endif
+
 		if (halt_bug_next_instruction) {
 			data.pc--;
 			halt_bug_next_instruction = false;
+
+			//the byte after halt is read twice, so cached immediates no longer line up
+			reset_block_cursor();
 		}
 
-		execute_opcode(cycles, opcode);
+		//cached instructions carry their handler, skipping the dispatch on the opcode
+		if (current_instruction != nullptr) {
+			current_instruction->handler(*this, cycles);
+		}
+		else {
+			execute_opcode(cycles, opcode);
+		}
 	}
 }
 
-const cpu_data& CPU::get_data() {
-	return data;
-}
-
 byte CPU::fetch_opcode() {
 	emulator_ptr->tick_other_components(2);
 	
-	byte opcode = emulator_ptr->bus_read(data.pc);
+	//take the opcode from the block cache when possible, bus timing is unchanged
+	current_instruction = nullptr;
+	current_operand_index = 0;
+	if (engine == engine_CACHED) {
+		current_instruction = fetch_cached_instruction();
+	}
+
+	byte opcode = 0x00;
+	if (current_instruction != nullptr) {
+		opcode = current_instruction->opcode;
+		emulator_ptr->count_bus_fetch();
+	}
+	else {
+		opcode = emulator_ptr->bus_fetch(data.pc);
+	}
 	data.pc++;
 
 	interrupt_pending = is_interrupt_pending(); //check opcodes on t 3 of fetch
@@ -147,7 +264,14 @@ byte CPU::fetch_opcode() {
 
 byte CPU::fetch_next_byte() {
 	emulator_ptr->tick_other_components(2);
-	byte value = emulator_ptr->bus_read(data.pc);
+	byte value = 0x00;
+	if (current_instruction != nullptr) {
+		value = current_instruction->operands[current_operand_index++];
+		emulator_ptr->count_bus_fetch();
+	}
+	else {
+		value = emulator_ptr->bus_fetch(data.pc);
+	}
 	data.pc++;
 
 	emulator_ptr->tick_other_components(2);
@@ -161,7 +285,8 @@ void CPU::internal_cycle_other_components() {
 
 const byte CPU::is_interrupt_pending() {
 	byte IF = emulator_ptr->io_instant_read(io_IF);
-	byte IE = emulator_ptr->bus_read(0xffff);
+	//internal check every instruction, not a guest access so it stays off the bus counters/heatmap
+	byte IE = emulator_ptr->memory_instant_read(0xffff);
 
 	return ((IF & IE) & 0x1f);
 }
@@ -214,6 +339,9 @@ int CPU::handle_interupts(int& cycles) {
 		}
 
 		data.pc = interrupt_vector;
+#ifdef SHARPBOY_PROFILER
+		emulator_ptr->profile_call(data.pc);
+#endif
 
 		//if we havent cleared our interrupt on the push, clear the bit in IF to service interrupt
 		if (!cleared_ie) {
@@ -227,21 +355,39 @@ int CPU::handle_interupts(int& cycles) {
 }
 
 void CPU::execute_opcode(int& cycles, const byte& opcode) {
+	opcode_handlers[opcode](*this, cycles);
+}
+
+template<byte OPCODE>
+void CPU::execute_opcode_handler(CPU& cpu, int& cycles) {
+	cpu.execute_fixed_opcode<OPCODE>(cycles);
+}
+
+template<size_t... OPCODES>
+constexpr std::array<opcode_handler, 0x100> CPU::make_opcode_handlers(std::index_sequence<OPCODES...>) {
+	return { &CPU::execute_opcode_handler<(byte)OPCODES>... };
+}
+
+const std::array<opcode_handler, 0x100> CPU::opcode_handlers = CPU::make_opcode_handlers(std::make_index_sequence<0x100>());
+
+//the switch is on a template argument, so each handler keeps only its own case
+template<byte OPCODE>
+void CPU::execute_fixed_opcode(int& cycles) {
 	cycles = 0;
-	switch (opcode) {
+	switch (OPCODE) {
 		//0x00->0x0f
 	case inst_NOOP: cycles += 4; return;
-	case inst_LD_BC_N16: cycles = LD_R16_N16(data.b, data.c); return;
-	case inst_LD_BC_A: cycles = LD_R16_A(data.b, data.c, data.a); return;
-	case inst_INC_BC: cycles = INC_R16(data.b, data.c); return;
+	case inst_LD_BC_N16: cycles = LD_R16_N16(data.bc); return;
+	case inst_LD_BC_A: cycles = LD_R16_A(data.bc, data.a); return;
+	case inst_INC_BC: cycles = INC_R16(data.bc); return;
 	case inst_INC_B: cycles = INC_R8(data.b); return;
 	case inst_DEC_B: cycles = DEC_R8(data.b); return;
 	case inst_LD_B_N8: cycles = LD_R8_N8(data.b); return;
 	case inst_RLCA: cycles = RLCA(data.a); return;
 	case inst_LD_N16_SP: cycles = LD_N16_SP(data.sp); return;
-	case inst_ADD_HL_BC: cycles = ADD_HL_R16(data.h, data.l, data.b, data.c); return;
-	case inst_LD_A_BC: cycles = LD_A_R16(data.a, data.b, data.c); return;
-	case inst_DEC_BC: cycles = DEC_R16(data.b, data.c); return;
+	case inst_ADD_HL_BC: cycles = ADD_HL_R16(data.hl, data.bc); return;
+	case inst_LD_A_BC: cycles = LD_A_R16(data.a, data.bc); return;
+	case inst_DEC_BC: cycles = DEC_R16(data.bc); return;
 	case inst_INC_C: cycles = INC_R8(data.c); return;
 	case inst_DEC_C: cycles = DEC_R8(data.c); return;
 	case inst_LD_C_N8: cycles = LD_R8_N8(data.c); return;
@@ -249,17 +395,17 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 
 		//0x10->0x1f
 	case inst_STOP_N8: cycles = STOP(); return;
-	case inst_LD_DE_N16: cycles = LD_R16_N16(data.d, data.e); return;
-	case inst_LD_DE_A: cycles = LD_R16_A(data.d, data.e, data.a); return;
-	case inst_INC_DE: cycles = INC_R16(data.d, data.e); return;
+	case inst_LD_DE_N16: cycles = LD_R16_N16(data.de); return;
+	case inst_LD_DE_A: cycles = LD_R16_A(data.de, data.a); return;
+	case inst_INC_DE: cycles = INC_R16(data.de); return;
 	case inst_INC_D: cycles = INC_R8(data.d); return;
 	case inst_DEC_D: cycles = DEC_R8(data.d); return;
 	case inst_LD_D_N8: cycles = LD_R8_N8(data.d); return;
 	case inst_RLA: cycles = RLA(data.a); return;
 	case inst_JR_E8: cycles = JR_E8(); return;
-	case inst_ADD_HL_DE: cycles = ADD_HL_R16(data.h, data.l, data.d, data.e); return;
-	case inst_LD_A_DE: cycles = LD_A_R16(data.a, data.d, data.e); return;
-	case inst_DEC_DE: cycles = DEC_R16(data.d, data.e); return;
+	case inst_ADD_HL_DE: cycles = ADD_HL_R16(data.hl, data.de); return;
+	case inst_LD_A_DE: cycles = LD_A_R16(data.a, data.de); return;
+	case inst_DEC_DE: cycles = DEC_R16(data.de); return;
 	case inst_INC_E: cycles = INC_R8(data.e); return;
 	case inst_DEC_E: cycles = DEC_R8(data.e); return;
 	case inst_LD_E_N8: cycles = LD_R8_N8(data.e); return;
@@ -267,17 +413,17 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 
 		//0x20-0x2f
 	case inst_JR_NZ_E8: cycles = JR_CC_E8(!get_flag_state(flags_ZERO)); return;
-	case inst_LD_HL_N16: cycles = LD_R16_N16(data.h, data.l); return;
-	case inst_LDI_HL_A: cycles = LD_HLINC_A(data.h, data.l, data.a); return;
-	case inst_INC_HL: cycles = INC_R16(data.h, data.l); return;
+	case inst_LD_HL_N16: cycles = LD_R16_N16(data.hl); return;
+	case inst_LDI_HL_A: cycles = LD_HLINC_A(data.hl, data.a); return;
+	case inst_INC_HL: cycles = INC_R16(data.hl); return;
 	case inst_INC_H: cycles = INC_R8(data.h); return;
 	case inst_DEC_H: cycles = DEC_R8(data.h); return;
 	case inst_LD_H_N8: cycles = LD_R8_N8(data.h); return;
 	case inst_DAA: cycles = DAA(data.a); return;
 	case inst_JR_Z_E8: cycles = JR_CC_E8(get_flag_state(flags_ZERO)); return;
-	case inst_ADD_HL_HL: cycles = ADD_HL_R16(data.h, data.l, data.h, data.l); return;
-	case inst_LD_A_HLI: cycles = LD_A_HLINC(data.a, data.h, data.l); return;
-	case inst_DEC_HL: cycles = DEC_R16(data.h, data.l); return;
+	case inst_ADD_HL_HL: cycles = ADD_HL_R16(data.hl, data.hl); return;
+	case inst_LD_A_HLI: cycles = LD_A_HLINC(data.a, data.hl); return;
+	case inst_DEC_HL: cycles = DEC_R16(data.hl); return;
 	case inst_INC_L: cycles = INC_R8(data.l); return;
 	case inst_DEC_L: cycles = DEC_R8(data.l); return;
 	case inst_LD_L_N8: cycles = LD_R8_N8(data.l); return;
@@ -286,15 +432,15 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 		//0x30->0x3f
 	case inst_JR_NC_E8: cycles = JR_CC_E8(!get_flag_state(flags_CARRY)); return;
 	case inst_LD_SP_N16: cycles = LD_SP_N16(data.sp); return;
-	case inst_LDD_HL_A: cycles = LD_HLDEC_A(data.h, data.l, data.a); return;
+	case inst_LDD_HL_A: cycles = LD_HLDEC_A(data.hl, data.a); return;
 	case inst_INC_SP: cycles += 8; data.sp++; internal_cycle_other_components(); return;
-	case inst_INC_memHL: cycles = INC_HL(data.h, data.l); return;
-	case inst_DEC_memHL: cycles = DEC_HL(data.h, data.l); return;
-	case inst_LD_HL_N8: cycles = LD_HL_N8(data.h, data.l); return;
+	case inst_INC_memHL: cycles = INC_HL(data.hl); return;
+	case inst_DEC_memHL: cycles = DEC_HL(data.hl); return;
+	case inst_LD_HL_N8: cycles = LD_HL_N8(data.hl); return;
 	case inst_SCF: cycles = SCF(); return;
 	case inst_JR_C_E8: cycles = JR_CC_E8(get_flag_state(flags_CARRY)); return;
-	case inst_ADD_HL_SP: cycles = ADD_HL_R16(data.h, data.l, (byte)(data.sp >> 8), (byte)(data.sp & 0xff)); return;
-	case inst_LD_A_HLD: cycles = LD_A_HLDEC(data.a, data.h, data.l); return;
+	case inst_ADD_HL_SP: cycles = ADD_HL_R16(data.hl, data.sp); return;
+	case inst_LD_A_HLD: cycles = LD_A_HLDEC(data.a, data.hl); return;
 	case inst_DEC_SP: cycles += 8; data.sp--; internal_cycle_other_components(); return;
 	case inst_INC_A: cycles = INC_R8(data.a); return;
 	case inst_DEC_A: cycles = DEC_R8(data.a); return;
@@ -308,7 +454,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_LD_B_E: cycles = LD_R8_R8(data.b, data.e); return;
 	case inst_LD_B_H: cycles = LD_R8_R8(data.b, data.h); return;
 	case inst_LD_B_L: cycles = LD_R8_R8(data.b, data.l); return;
-	case inst_LD_B_HL: cycles = LD_R8_HL(data.b, data.h, data.l); return;
+	case inst_LD_B_HL: cycles = LD_R8_HL(data.b, data.hl); return;
 	case inst_LD_B_A: cycles = LD_R8_R8(data.b, data.a); return;
 	case inst_LD_C_B: cycles = LD_R8_R8(data.c, data.b); return;
 	case inst_LD_C_C: cycles = LD_R8_R8(data.c, data.c); return;
@@ -316,7 +462,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_LD_C_E: cycles = LD_R8_R8(data.c, data.e); return;
 	case inst_LD_C_H: cycles = LD_R8_R8(data.c, data.h); return;
 	case inst_LD_C_L: cycles = LD_R8_R8(data.c, data.l); return;
-	case inst_LD_C_HL: cycles = LD_R8_HL(data.c, data.h, data.l); return;
+	case inst_LD_C_HL: cycles = LD_R8_HL(data.c, data.hl); return;
 	case inst_LD_C_A: cycles = LD_R8_R8(data.c, data.a); return;
 
 		//0x50->0x5f
@@ -326,7 +472,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_LD_D_E: cycles = LD_R8_R8(data.d, data.e); return;
 	case inst_LD_D_H: cycles = LD_R8_R8(data.d, data.h); return;
 	case inst_LD_D_L: cycles = LD_R8_R8(data.d, data.l); return;
-	case inst_LD_D_HL: cycles = LD_R8_HL(data.d, data.h, data.l); return;
+	case inst_LD_D_HL: cycles = LD_R8_HL(data.d, data.hl); return;
 	case inst_LD_D_A: cycles = LD_R8_R8(data.d, data.a); return;
 	case inst_LD_E_B: cycles = LD_R8_R8(data.e, data.b); return;
 	case inst_LD_E_C: cycles = LD_R8_R8(data.e, data.c); return;
@@ -334,7 +480,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_LD_E_E: cycles = LD_R8_R8(data.e, data.e); return;
 	case inst_LD_E_H: cycles = LD_R8_R8(data.e, data.h); return;
 	case inst_LD_E_L: cycles = LD_R8_R8(data.e, data.l); return;
-	case inst_LD_E_HL: cycles = LD_R8_HL(data.e, data.h, data.l); return;
+	case inst_LD_E_HL: cycles = LD_R8_HL(data.e, data.hl); return;
 	case inst_LD_E_A: cycles = LD_R8_R8(data.e, data.a); return;
 
 		//0x60->0x6f
@@ -344,7 +490,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_LD_H_E: cycles = LD_R8_R8(data.h, data.e); return;
 	case inst_LD_H_H: cycles = LD_R8_R8(data.h, data.h); return;
 	case inst_LD_H_L: cycles = LD_R8_R8(data.h, data.l); return;
-	case inst_LD_H_HL: cycles = LD_R8_HL(data.h, data.h, data.l); return;
+	case inst_LD_H_HL: cycles = LD_R8_HL(data.h, data.hl); return;
 	case inst_LD_H_A: cycles = LD_R8_R8(data.h, data.a); return;
 	case inst_LD_L_B: cycles = LD_R8_R8(data.l, data.b); return;
 	case inst_LD_L_C: cycles = LD_R8_R8(data.l, data.c); return;
@@ -352,26 +498,26 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_LD_L_E: cycles = LD_R8_R8(data.l, data.e); return;
 	case inst_LD_L_H: cycles = LD_R8_R8(data.l, data.h); return;
 	case inst_LD_L_L: cycles = LD_R8_R8(data.l, data.l); return;
-	case inst_LD_L_HL: cycles = LD_R8_HL(data.l, data.h, data.l); return;
+	case inst_LD_L_HL: cycles = LD_R8_HL(data.l, data.hl); return;
 	case inst_LD_L_A: cycles = LD_R8_R8(data.l, data.a); return;
 
 		//0x70->0x7f
-	case inst_LD_HL_B: cycles = LD_HL_R8(data.h, data.l, data.b); return;
-	case inst_LD_HL_C: cycles = LD_HL_R8(data.h, data.l, data.c); return;
-	case inst_LD_HL_D: cycles = LD_HL_R8(data.h, data.l, data.d); return;
-	case inst_LD_HL_E: cycles = LD_HL_R8(data.h, data.l, data.e); return;
-	case inst_LD_HL_H: cycles = LD_HL_R8(data.h, data.l, data.h); return;
-	case inst_LD_HL_L: cycles = LD_HL_R8(data.h, data.l, data.l); return;
+	case inst_LD_HL_B: cycles = LD_HL_R8(data.hl, data.b); return;
+	case inst_LD_HL_C: cycles = LD_HL_R8(data.hl, data.c); return;
+	case inst_LD_HL_D: cycles = LD_HL_R8(data.hl, data.d); return;
+	case inst_LD_HL_E: cycles = LD_HL_R8(data.hl, data.e); return;
+	case inst_LD_HL_H: cycles = LD_HL_R8(data.hl, data.h); return;
+	case inst_LD_HL_L: cycles = LD_HL_R8(data.hl, data.l); return;
 	case inst_HALT: HALT(); return;//not impl
 		return;
-	case inst_LD_HL_A: cycles = LD_HL_R8(data.h, data.l, data.a); return;
+	case inst_LD_HL_A: cycles = LD_HL_R8(data.hl, data.a); return;
 	case inst_LD_A_B: cycles = LD_R8_R8(data.a, data.b); return;
 	case inst_LD_A_C: cycles = LD_R8_R8(data.a, data.c); return;
 	case inst_LD_A_D: cycles = LD_R8_R8(data.a, data.d); return;
 	case inst_LD_A_E: cycles = LD_R8_R8(data.a, data.e); return;
 	case inst_LD_A_H: cycles = LD_R8_R8(data.a, data.h); return;
 	case inst_LD_A_L: cycles = LD_R8_R8(data.a, data.l); return;
-	case inst_LD_A_HL: cycles = LD_R8_HL(data.a, data.h, data.l); return;
+	case inst_LD_A_HL: cycles = LD_R8_HL(data.a, data.hl); return;
 	case inst_LD_A_A: cycles = LD_R8_R8(data.a, data.a); return;
 
 		//0x80->0x8f 
@@ -381,7 +527,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_ADD_A_E: cycles = ADD_R8(data.a, data.e); return;
 	case inst_ADD_A_H: cycles = ADD_R8(data.a, data.h); return;
 	case inst_ADD_A_L: cycles = ADD_R8(data.a, data.l); return;
-	case inst_ADD_A_HL: cycles = ADD_HL(data.a, data.h, data.l); return;
+	case inst_ADD_A_HL: cycles = ADD_HL(data.a, data.hl); return;
 	case inst_ADD_A_A: cycles = ADD_R8(data.a, data.a); return;
 	case inst_ADC_A_B: cycles = ADC_R8(data.a, data.b); return;
 	case inst_ADC_A_C: cycles = ADC_R8(data.a, data.c); return;
@@ -389,7 +535,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_ADC_A_E: cycles = ADC_R8(data.a, data.e); return;
 	case inst_ADC_A_H: cycles = ADC_R8(data.a, data.h); return;
 	case inst_ADC_A_L: cycles = ADC_R8(data.a, data.l); return;
-	case inst_ADC_A_HL: cycles = ADC_HL(data.a, data.h, data.l); return;
+	case inst_ADC_A_HL: cycles = ADC_HL(data.a, data.hl); return;
 	case inst_ADC_A_A: cycles = ADC_R8(data.a, data.a); return;
 
 		//0x90->0x9f
@@ -399,7 +545,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_SUB_A_E: cycles = SUB_R8(data.a, data.e); return;
 	case inst_SUB_A_H: cycles = SUB_R8(data.a, data.h); return;
 	case inst_SUB_A_L: cycles = SUB_R8(data.a, data.l); return;
-	case inst_SUB_A_HL: cycles = SUB_HL(data.a, data.h, data.l); return;
+	case inst_SUB_A_HL: cycles = SUB_HL(data.a, data.hl); return;
 	case inst_SUB_A_A: cycles = SUB_R8(data.a, data.a); return;
 	case inst_SBC_A_B: cycles = SBC_R8(data.a, data.b); return;
 	case inst_SBC_A_C: cycles = SBC_R8(data.a, data.c); return;
@@ -407,7 +553,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_SBC_A_E: cycles = SBC_R8(data.a, data.e); return;
 	case inst_SBC_A_H: cycles = SBC_R8(data.a, data.h); return;
 	case inst_SBC_A_L: cycles = SBC_R8(data.a, data.l); return;
-	case inst_SBC_A_HL: cycles = SBC_HL(data.a, data.h, data.l); return;
+	case inst_SBC_A_HL: cycles = SBC_HL(data.a, data.hl); return;
 	case inst_SBC_A_A: cycles = SBC_R8(data.a, data.a); return;
 
 		//0xa0->0xaf
@@ -417,7 +563,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_AND_A_E: cycles = AND_R8(data.a, data.e); return;
 	case inst_AND_A_H: cycles = AND_R8(data.a, data.h); return;
 	case inst_AND_A_L: cycles = AND_R8(data.a, data.l); return;
-	case inst_AND_A_HL: cycles = AND_HL(data.a, data.h, data.l); return;
+	case inst_AND_A_HL: cycles = AND_HL(data.a, data.hl); return;
 	case inst_AND_A_A: cycles = AND_R8(data.a, data.a); return;
 	case inst_XOR_A_B: cycles = XOR_R8(data.a, data.b); return;
 	case inst_XOR_A_C: cycles = XOR_R8(data.a, data.c); return;
@@ -425,7 +571,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_XOR_A_E: cycles = XOR_R8(data.a, data.e); return;
 	case inst_XOR_A_H: cycles = XOR_R8(data.a, data.h); return;
 	case inst_XOR_A_L: cycles = XOR_R8(data.a, data.l); return;
-	case inst_XOR_A_HL: cycles = XOR_HL(data.a, data.h, data.l); return;
+	case inst_XOR_A_HL: cycles = XOR_HL(data.a, data.hl); return;
 	case inst_XOR_A_A: cycles = XOR_R8(data.a, data.a); return;
 
 		//0xb0->0xbf
@@ -435,7 +581,7 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_OR_A_E: cycles = OR_R8(data.a, data.e); return;
 	case inst_OR_A_H: cycles = OR_R8(data.a, data.h); return;
 	case inst_OR_A_L: cycles = OR_R8(data.a, data.l); return;
-	case inst_OR_A_HL: cycles = OR_HL(data.a, data.h, data.l); return;
+	case inst_OR_A_HL: cycles = OR_HL(data.a, data.hl); return;
 	case inst_OR_A_A: cycles = OR_R8(data.a, data.a); return;
 	case inst_CP_A_B: cycles = CP_R8(data.a, data.b); return;
 	case inst_CP_A_C: cycles = CP_R8(data.a, data.c); return;
@@ -443,16 +589,16 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 	case inst_CP_A_E: cycles = CP_R8(data.a, data.e); return;
 	case inst_CP_A_H: cycles = CP_R8(data.a, data.h); return;
 	case inst_CP_A_L: cycles = CP_R8(data.a, data.l); return;
-	case inst_CP_A_HL: cycles = CP_HL(data.a, data.h, data.l); return;
+	case inst_CP_A_HL: cycles = CP_HL(data.a, data.hl); return;
 	case inst_CP_A_A: cycles = CP_R8(data.a, data.a); return;
 
 		//0xc0->0xcf
 	case inst_RET_NZ: cycles = RET_CC(data.sp, !get_flag_state(flags_ZERO)); return;
-	case inst_POP_BC: cycles = POP_R16(data.sp, data.b, data.c); return;
+	case inst_POP_BC: cycles = POP_R16(data.sp, data.bc); return;
 	case inst_JP_NZ_N16: cycles = JP_CC_N16(!get_flag_state(flags_ZERO)); return;
 	case inst_JP_N16: cycles = JP_N16(); return;
 	case inst_CALL_NZ_N16: cycles = CALL_CC_N16(data.sp, !get_flag_state(flags_ZERO)); return;
-	case inst_PUSH_BC: cycles = PUSH_R16(data.sp, data.b, data.c); return;
+	case inst_PUSH_BC: cycles = PUSH_R16(data.sp, data.bc); return;
 	case inst_ADD_A_N8: cycles = ADD_N8(data.a); return;
 	case inst_RST_00: cycles = RST_N8(data.sp, 0x00); return;
 	case inst_RET_Z: cycles = RET_CC(data.sp, get_flag_state(flags_ZERO)); return;
@@ -466,10 +612,10 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 
 		//0xd0->0xdf
 	case inst_RET_NC: cycles = RET_CC(data.sp, !get_flag_state(flags_CARRY)); return;
-	case inst_POP_DE: cycles = POP_R16(data.sp, data.d, data.e); return;
+	case inst_POP_DE: cycles = POP_R16(data.sp, data.de); return;
 	case inst_JP_NC_N16: cycles = JP_CC_N16(!get_flag_state(flags_CARRY)); return;
 	case inst_CALL_NC_N16: cycles = CALL_CC_N16(data.sp, !get_flag_state(flags_CARRY)); return;
-	case inst_PUSH_DE: cycles = PUSH_R16(data.sp, data.d, data.e); return;
+	case inst_PUSH_DE: cycles = PUSH_R16(data.sp, data.de); return;
 	case inst_SUB_A_N8: cycles = SUB_N8(data.a); return;
 	case inst_RST_10: cycles = RST_N8(data.sp, 0x10); return;
 	case inst_RET_C: cycles = RET_CC(data.sp, get_flag_state(flags_CARRY)); return;
@@ -481,27 +627,27 @@ void CPU::execute_opcode(int& cycles, const byte& opcode) {
 
 		//0xe0->0xef
 	case inst_LDH_N8_A: cycles = LDH_N8_A(data.a); return;
-	case inst_POP_HL: cycles = POP_R16(data.sp, data.h, data.l); return;
+	case inst_POP_HL: cycles = POP_R16(data.sp, data.hl); return;
 	case inst_LDH_C_A: cycles = LDH_C_A(data.c, data.a); return;
-	case inst_PUSH_HL: cycles = PUSH_R16(data.sp, data.h, data.l); return;
+	case inst_PUSH_HL: cycles = PUSH_R16(data.sp, data.hl); return;
 	case inst_AND_A_N8: cycles = AND_N8(data.a); return;
 	case inst_RST_20: cycles = RST_N8(data.sp, 0x20); return;
 	case inst_ADD_SP_E8: cycles = ADD_SP_E8(data.sp); return;
-	case inst_JP_HL: cycles = JP_HL(data.h, data.l); return;
+	case inst_JP_HL: cycles = JP_HL(data.hl); return;
 	case inst_LD_N16_A: cycles = LD_N16_A(data.a); return;
 	case inst_XOR_A_N8: cycles = XOR_N8(data.a); return;
 	case inst_RST_28: cycles = RST_N8(data.sp, 0x28); return;
 
 		//0xf0->0xff
 	case inst_LDH_A_N8: cycles = LDH_A_N8(data.a); return;
-	case inst_POP_AF: cycles = POP_AF(data.sp, data.a, data.f); return;
+	case inst_POP_AF: cycles = POP_AF(data.sp, data.af); return;
 	case inst_LDH_A_C: cycles = LDH_A_C(data.a, data.c); return;
 	case inst_DI: cycles = DI(); return;
-	case inst_PUSH_AF: cycles = PUSH_R16(data.sp, data.a, data.f); return;
+	case inst_PUSH_AF: materialise_flags(); cycles = PUSH_R16(data.sp, data.af); return;
 	case inst_OR_A_N8: cycles = OR_N8(data.a); return;
 	case inst_RST_30: cycles = RST_N8(data.sp, 0x30); return;
-	case inst_LD_HL_SP_E8: cycles = LD_HL_SP_E8(data.h, data.l, data.sp); return;
-	case inst_LD_SP_HL: cycles = LD_SP_HL(data.sp, data.h, data.l); return;
+	case inst_LD_HL_SP_E8: cycles = LD_HL_SP_E8(data.hl, data.sp); return;
+	case inst_LD_SP_HL: cycles = LD_SP_HL(data.sp, data.hl); return;
 	case inst_LD_A_N16: cycles = LD_A_N16(data.a); return;
 	case inst_EI: cycles = EI(); return;
 	case inst_CP_A_N8: cycles = CP_N8(data.a); return;
@@ -522,7 +668,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RLC_E: cycles = RLC_R8(data.e); break;
 	case inst_cb_RLC_H: cycles = RLC_R8(data.h); break;
 	case inst_cb_RLC_L: cycles = RLC_R8(data.l); break;
-	case inst_cb_RLC_HL: cycles = RLC_HL(data.h, data.l); break;
+	case inst_cb_RLC_HL: cycles = RLC_HL(data.hl); break;
 	case inst_cb_RLC_A: cycles = RLC_R8(data.a); break;
 	case inst_cb_RRC_B: cycles = RRC_R8(data.b); break;
 	case inst_cb_RRC_C: cycles = RRC_R8(data.c); break;
@@ -530,7 +676,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RRC_E: cycles = RRC_R8(data.e); break;
 	case inst_cb_RRC_H: cycles = RRC_R8(data.h); break;
 	case inst_cb_RRC_L: cycles = RRC_R8(data.l); break;
-	case inst_cb_RRC_HL: cycles = RRC_HL(data.h, data.l); break;
+	case inst_cb_RRC_HL: cycles = RRC_HL(data.hl); break;
 	case inst_cb_RRC_A: cycles = RRC_R8(data.a); break;
 
 		//0x10-0x1f
@@ -540,7 +686,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RL_E: cycles = RL_R8(data.e); break;
 	case inst_cb_RL_H: cycles = RL_R8(data.h); break;
 	case inst_cb_RL_L: cycles = RL_R8(data.l); break;
-	case inst_cb_RL_HL: cycles = RL_HL(data.h, data.l); break;
+	case inst_cb_RL_HL: cycles = RL_HL(data.hl); break;
 	case inst_cb_RL_A: cycles = RL_R8(data.a); break;
 	case inst_cb_RR_B: cycles = RR_R8(data.b); break;
 	case inst_cb_RR_C: cycles = RR_R8(data.c); break;
@@ -548,7 +694,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RR_E: cycles = RR_R8(data.e); break;
 	case inst_cb_RR_H: cycles = RR_R8(data.h); break;
 	case inst_cb_RR_L: cycles = RR_R8(data.l); break;
-	case inst_cb_RR_HL: cycles = RR_HL(data.h, data.l); break;
+	case inst_cb_RR_HL: cycles = RR_HL(data.hl); break;
 	case inst_cb_RR_A: cycles = RR_R8(data.a); break;
 
 		//0x20->0x2f
@@ -558,7 +704,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SLA_E: cycles = SLA_R8(data.e); break;
 	case inst_cb_SLA_H: cycles = SLA_R8(data.h); break;
 	case inst_cb_SLA_L: cycles = SLA_R8(data.l); break;
-	case inst_cb_SLA_HL: cycles = SLA_HL(data.h, data.l); break;
+	case inst_cb_SLA_HL: cycles = SLA_HL(data.hl); break;
 	case inst_cb_SLA_A: cycles = SLA_R8(data.a); break;
 	case inst_cb_SRA_B: cycles = SRA_R8(data.b); break;
 	case inst_cb_SRA_C: cycles = SRA_R8(data.c); break;
@@ -566,7 +712,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SRA_E: cycles = SRA_R8(data.e); break;
 	case inst_cb_SRA_H: cycles = SRA_R8(data.h); break;
 	case inst_cb_SRA_L: cycles = SRA_R8(data.l); break;
-	case inst_cb_SRA_HL: cycles = SRA_HL(data.h, data.l); break;
+	case inst_cb_SRA_HL: cycles = SRA_HL(data.hl); break;
 	case inst_cb_SRA_A: cycles = SRA_R8(data.a); break;
 
 		//0x30->0x3f
@@ -576,7 +722,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SWAP_E: cycles = SWAP_R8(data.e); break;
 	case inst_cb_SWAP_H: cycles = SWAP_R8(data.h); break;
 	case inst_cb_SWAP_L: cycles = SWAP_R8(data.l); break;
-	case inst_cb_SWAP_HL: cycles = SWAP_HL(data.h, data.l); break;
+	case inst_cb_SWAP_HL: cycles = SWAP_HL(data.hl); break;
 	case inst_cb_SWAP_A: cycles = SWAP_R8(data.a); break;
 	case inst_cb_SRL_B: cycles = SRL_R8(data.b); break;
 	case inst_cb_SRL_C: cycles = SRL_R8(data.c); break;
@@ -584,7 +730,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SRL_E: cycles = SRL_R8(data.e); break;
 	case inst_cb_SRL_H: cycles = SRL_R8(data.h); break;
 	case inst_cb_SRL_L: cycles = SRL_R8(data.l); break;
-	case inst_cb_SRL_HL: cycles = SRL_HL(data.h, data.l); break;
+	case inst_cb_SRL_HL: cycles = SRL_HL(data.hl); break;
 	case inst_cb_SRL_A: cycles = SRL_R8(data.a); break;
 
 		//0x40->0x4f
@@ -594,7 +740,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_0_E: cycles = BIT_B_R8(0, data.e); break;
 	case inst_cb_BIT_0_H: cycles = BIT_B_R8(0, data.h); break;
 	case inst_cb_BIT_0_L: cycles = BIT_B_R8(0, data.l); break;
-	case inst_cb_BIT_0_HL: cycles = BIT_B_HL(0, data.h, data.l); break;
+	case inst_cb_BIT_0_HL: cycles = BIT_B_HL(0, data.hl); break;
 	case inst_cb_BIT_0_A: cycles = BIT_B_R8(0, data.a); break;
 	case inst_cb_BIT_1_B: cycles = BIT_B_R8(1, data.b); break;
 	case inst_cb_BIT_1_C: cycles = BIT_B_R8(1, data.c); break;
@@ -602,7 +748,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_1_E: cycles = BIT_B_R8(1, data.e); break;
 	case inst_cb_BIT_1_H: cycles = BIT_B_R8(1, data.h); break;
 	case inst_cb_BIT_1_L: cycles = BIT_B_R8(1, data.l); break;
-	case inst_cb_BIT_1_HL: cycles = BIT_B_HL(1, data.h, data.l); break;
+	case inst_cb_BIT_1_HL: cycles = BIT_B_HL(1, data.hl); break;
 	case inst_cb_BIT_1_A: cycles = BIT_B_R8(1, data.a); break;
 
 		//0x50->0x5f
@@ -612,7 +758,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_2_E: cycles = BIT_B_R8(2, data.e); break;
 	case inst_cb_BIT_2_H: cycles = BIT_B_R8(2, data.h); break;
 	case inst_cb_BIT_2_L: cycles = BIT_B_R8(2, data.l); break;
-	case inst_cb_BIT_2_HL: cycles = BIT_B_HL(2, data.h, data.l); break;
+	case inst_cb_BIT_2_HL: cycles = BIT_B_HL(2, data.hl); break;
 	case inst_cb_BIT_2_A: cycles = BIT_B_R8(2, data.a); break;
 	case inst_cb_BIT_3_B: cycles = BIT_B_R8(3, data.b); break;
 	case inst_cb_BIT_3_C: cycles = BIT_B_R8(3, data.c); break;
@@ -620,7 +766,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_3_E: cycles = BIT_B_R8(3, data.e); break;
 	case inst_cb_BIT_3_H: cycles = BIT_B_R8(3, data.h); break;
 	case inst_cb_BIT_3_L: cycles = BIT_B_R8(3, data.l); break;
-	case inst_cb_BIT_3_HL: cycles = BIT_B_HL(3, data.h, data.l); break;
+	case inst_cb_BIT_3_HL: cycles = BIT_B_HL(3, data.hl); break;
 	case inst_cb_BIT_3_A: cycles = BIT_B_R8(3, data.a); break;
 
 		//0x60->0x6f
@@ -630,7 +776,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_4_E: cycles = BIT_B_R8(4, data.e); break;
 	case inst_cb_BIT_4_H: cycles = BIT_B_R8(4, data.h); break;
 	case inst_cb_BIT_4_L: cycles = BIT_B_R8(4, data.l); break;
-	case inst_cb_BIT_4_HL: cycles = BIT_B_HL(4, data.h, data.l); break;
+	case inst_cb_BIT_4_HL: cycles = BIT_B_HL(4, data.hl); break;
 	case inst_cb_BIT_4_A: cycles = BIT_B_R8(4, data.a); break;
 	case inst_cb_BIT_5_B: cycles = BIT_B_R8(5, data.b); break;
 	case inst_cb_BIT_5_C: cycles = BIT_B_R8(5, data.c); break;
@@ -638,7 +784,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_5_E: cycles = BIT_B_R8(5, data.e); break;
 	case inst_cb_BIT_5_H: cycles = BIT_B_R8(5, data.h); break;
 	case inst_cb_BIT_5_L: cycles = BIT_B_R8(5, data.l); break;
-	case inst_cb_BIT_5_HL: cycles = BIT_B_HL(5, data.h, data.l); break;
+	case inst_cb_BIT_5_HL: cycles = BIT_B_HL(5, data.hl); break;
 	case inst_cb_BIT_5_A: cycles = BIT_B_R8(5, data.a); break;
 
 		//0x70->0x7f
@@ -648,7 +794,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_6_E: cycles = BIT_B_R8(6, data.e); break;
 	case inst_cb_BIT_6_H: cycles = BIT_B_R8(6, data.h); break;
 	case inst_cb_BIT_6_L: cycles = BIT_B_R8(6, data.l); break;
-	case inst_cb_BIT_6_HL: cycles = BIT_B_HL(6, data.h, data.l); break;
+	case inst_cb_BIT_6_HL: cycles = BIT_B_HL(6, data.hl); break;
 	case inst_cb_BIT_6_A: cycles = BIT_B_R8(6, data.a); break;
 	case inst_cb_BIT_7_B: cycles = BIT_B_R8(7, data.b); break;
 	case inst_cb_BIT_7_C: cycles = BIT_B_R8(7, data.c); break;
@@ -656,7 +802,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_BIT_7_E: cycles = BIT_B_R8(7, data.e); break;
 	case inst_cb_BIT_7_H: cycles = BIT_B_R8(7, data.h); break;
 	case inst_cb_BIT_7_L: cycles = BIT_B_R8(7, data.l); break;
-	case inst_cb_BIT_7_HL: cycles = BIT_B_HL(7, data.h, data.l); break;
+	case inst_cb_BIT_7_HL: cycles = BIT_B_HL(7, data.hl); break;
 	case inst_cb_BIT_7_A: cycles = BIT_B_R8(7, data.a); break;
 
 		//0x80->0x8f
@@ -666,7 +812,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_0_E: cycles = RES_B_R8(0, data.e); break;
 	case inst_cb_RES_0_H: cycles = RES_B_R8(0, data.h); break;
 	case inst_cb_RES_0_L: cycles = RES_B_R8(0, data.l); break;
-	case inst_cb_RES_0_HL: cycles = RES_B_HL(0, data.h, data.l); break;
+	case inst_cb_RES_0_HL: cycles = RES_B_HL(0, data.hl); break;
 	case inst_cb_RES_0_A: cycles = RES_B_R8(0, data.a); break;
 	case inst_cb_RES_1_B: cycles = RES_B_R8(1, data.b); break;
 	case inst_cb_RES_1_C: cycles = RES_B_R8(1, data.c); break;
@@ -674,7 +820,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_1_E: cycles = RES_B_R8(1, data.e); break;
 	case inst_cb_RES_1_H: cycles = RES_B_R8(1, data.h); break;
 	case inst_cb_RES_1_L: cycles = RES_B_R8(1, data.l); break;
-	case inst_cb_RES_1_HL: cycles = RES_B_HL(1, data.h, data.l); break;
+	case inst_cb_RES_1_HL: cycles = RES_B_HL(1, data.hl); break;
 	case inst_cb_RES_1_A: cycles = RES_B_R8(1, data.a); break;
 
 		//0x90->0x9f
@@ -684,7 +830,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_2_E: cycles = RES_B_R8(2, data.e); break;
 	case inst_cb_RES_2_H: cycles = RES_B_R8(2, data.h); break;
 	case inst_cb_RES_2_L: cycles = RES_B_R8(2, data.l); break;
-	case inst_cb_RES_2_HL: cycles = RES_B_HL(2, data.h, data.l); break;
+	case inst_cb_RES_2_HL: cycles = RES_B_HL(2, data.hl); break;
 	case inst_cb_RES_2_A: cycles = RES_B_R8(2, data.a); break;
 	case inst_cb_RES_3_B: cycles = RES_B_R8(3, data.b); break;
 	case inst_cb_RES_3_C: cycles = RES_B_R8(3, data.c); break;
@@ -692,7 +838,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_3_E: cycles = RES_B_R8(3, data.e); break;
 	case inst_cb_RES_3_H: cycles = RES_B_R8(3, data.h); break;
 	case inst_cb_RES_3_L: cycles = RES_B_R8(3, data.l); break;
-	case inst_cb_RES_3_HL: cycles = RES_B_HL(3, data.h, data.l); break;
+	case inst_cb_RES_3_HL: cycles = RES_B_HL(3, data.hl); break;
 	case inst_cb_RES_3_A: cycles = RES_B_R8(3, data.a); break;
 
 		//0xa0->0xaf
@@ -702,7 +848,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_4_E: cycles = RES_B_R8(4, data.e); break;
 	case inst_cb_RES_4_H: cycles = RES_B_R8(4, data.h); break;
 	case inst_cb_RES_4_L: cycles = RES_B_R8(4, data.l); break;
-	case inst_cb_RES_4_HL: cycles = RES_B_HL(4, data.h, data.l); break;
+	case inst_cb_RES_4_HL: cycles = RES_B_HL(4, data.hl); break;
 	case inst_cb_RES_4_A: cycles = RES_B_R8(4, data.a); break;
 	case inst_cb_RES_5_B: cycles = RES_B_R8(5, data.b); break;
 	case inst_cb_RES_5_C: cycles = RES_B_R8(5, data.c); break;
@@ -710,7 +856,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_5_E: cycles = RES_B_R8(5, data.e); break;
 	case inst_cb_RES_5_H: cycles = RES_B_R8(5, data.h); break;
 	case inst_cb_RES_5_L: cycles = RES_B_R8(5, data.l); break;
-	case inst_cb_RES_5_HL: cycles = RES_B_HL(5, data.h, data.l); break;
+	case inst_cb_RES_5_HL: cycles = RES_B_HL(5, data.hl); break;
 	case inst_cb_RES_5_A: cycles = RES_B_R8(5, data.a); break;
 
 		//0xb0->0xbf
@@ -720,7 +866,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_6_E: cycles = RES_B_R8(6, data.e); break;
 	case inst_cb_RES_6_H: cycles = RES_B_R8(6, data.h); break;
 	case inst_cb_RES_6_L: cycles = RES_B_R8(6, data.l); break;
-	case inst_cb_RES_6_HL: cycles = RES_B_HL(6, data.h, data.l); break;
+	case inst_cb_RES_6_HL: cycles = RES_B_HL(6, data.hl); break;
 	case inst_cb_RES_6_A: cycles = RES_B_R8(6, data.a); break;
 	case inst_cb_RES_7_B: cycles = RES_B_R8(7, data.b); break;
 	case inst_cb_RES_7_C: cycles = RES_B_R8(7, data.c); break;
@@ -728,7 +874,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_RES_7_E: cycles = RES_B_R8(7, data.e); break;
 	case inst_cb_RES_7_H: cycles = RES_B_R8(7, data.h); break;
 	case inst_cb_RES_7_L: cycles = RES_B_R8(7, data.l); break;
-	case inst_cb_RES_7_HL: cycles = RES_B_HL(7, data.h, data.l); break;
+	case inst_cb_RES_7_HL: cycles = RES_B_HL(7, data.hl); break;
 	case inst_cb_RES_7_A: cycles = RES_B_R8(7, data.a); break;
 
 		//0xc0->0xcf
@@ -738,7 +884,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_0_E: cycles = SET_B_R8(0, data.e); break;
 	case inst_cb_SET_0_H: cycles = SET_B_R8(0, data.h); break;
 	case inst_cb_SET_0_L: cycles = SET_B_R8(0, data.l); break;
-	case inst_cb_SET_0_HL: cycles = SET_B_HL(0, data.h, data.l); break;
+	case inst_cb_SET_0_HL: cycles = SET_B_HL(0, data.hl); break;
 	case inst_cb_SET_0_A: cycles = SET_B_R8(0, data.a); break;
 	case inst_cb_SET_1_B: cycles = SET_B_R8(1, data.b); break;
 	case inst_cb_SET_1_C: cycles = SET_B_R8(1, data.c); break;
@@ -746,7 +892,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_1_E: cycles = SET_B_R8(1, data.e); break;
 	case inst_cb_SET_1_H: cycles = SET_B_R8(1, data.h); break;
 	case inst_cb_SET_1_L: cycles = SET_B_R8(1, data.l); break;
-	case inst_cb_SET_1_HL: cycles = SET_B_HL(1, data.h, data.l); break;
+	case inst_cb_SET_1_HL: cycles = SET_B_HL(1, data.hl); break;
 	case inst_cb_SET_1_A: cycles = SET_B_R8(1, data.a); break;
 
 		//0xd0->0xdf
@@ -756,7 +902,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_2_E: cycles = SET_B_R8(2, data.e); break;
 	case inst_cb_SET_2_H: cycles = SET_B_R8(2, data.h); break;
 	case inst_cb_SET_2_L: cycles = SET_B_R8(2, data.l); break;
-	case inst_cb_SET_2_HL: cycles = SET_B_HL(2, data.h, data.l); break;
+	case inst_cb_SET_2_HL: cycles = SET_B_HL(2, data.hl); break;
 	case inst_cb_SET_2_A: cycles = SET_B_R8(2, data.a); break;
 	case inst_cb_SET_3_B: cycles = SET_B_R8(3, data.b); break;
 	case inst_cb_SET_3_C: cycles = SET_B_R8(3, data.c); break;
@@ -764,7 +910,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_3_E: cycles = SET_B_R8(3, data.e); break;
 	case inst_cb_SET_3_H: cycles = SET_B_R8(3, data.h); break;
 	case inst_cb_SET_3_L: cycles = SET_B_R8(3, data.l); break;
-	case inst_cb_SET_3_HL: cycles = SET_B_HL(3, data.h, data.l); break;
+	case inst_cb_SET_3_HL: cycles = SET_B_HL(3, data.hl); break;
 	case inst_cb_SET_3_A: cycles = SET_B_R8(3, data.a); break;
 
 		//0xe0->0xef
@@ -774,7 +920,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_4_E: cycles = SET_B_R8(4, data.e); break;
 	case inst_cb_SET_4_H: cycles = SET_B_R8(4, data.h); break;
 	case inst_cb_SET_4_L: cycles = SET_B_R8(4, data.l); break;
-	case inst_cb_SET_4_HL: cycles = SET_B_HL(4, data.h, data.l); break;
+	case inst_cb_SET_4_HL: cycles = SET_B_HL(4, data.hl); break;
 	case inst_cb_SET_4_A: cycles = SET_B_R8(4, data.a); break;
 	case inst_cb_SET_5_B: cycles = SET_B_R8(5, data.b); break;
 	case inst_cb_SET_5_C: cycles = SET_B_R8(5, data.c); break;
@@ -782,7 +928,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_5_E: cycles = SET_B_R8(5, data.e); break;
 	case inst_cb_SET_5_H: cycles = SET_B_R8(5, data.h); break;
 	case inst_cb_SET_5_L: cycles = SET_B_R8(5, data.l); break;
-	case inst_cb_SET_5_HL: cycles = SET_B_HL(5, data.h, data.l); break;
+	case inst_cb_SET_5_HL: cycles = SET_B_HL(5, data.hl); break;
 	case inst_cb_SET_5_A: cycles = SET_B_R8(5, data.a); break;
 
 		//0xf0->0xff
@@ -792,7 +938,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_6_E: cycles = SET_B_R8(6, data.e); break;
 	case inst_cb_SET_6_H: cycles = SET_B_R8(6, data.h); break;
 	case inst_cb_SET_6_L: cycles = SET_B_R8(6, data.l); break;
-	case inst_cb_SET_6_HL: cycles = SET_B_HL(6, data.h, data.l); break;
+	case inst_cb_SET_6_HL: cycles = SET_B_HL(6, data.hl); break;
 	case inst_cb_SET_6_A: cycles = SET_B_R8(6, data.a); break;
 	case inst_cb_SET_7_B: cycles = SET_B_R8(7, data.b); break;
 	case inst_cb_SET_7_C: cycles = SET_B_R8(7, data.c); break;
@@ -800,7 +946,7 @@ void CPU::execute_cb_opcode(int& cycles) {
 	case inst_cb_SET_7_E: cycles = SET_B_R8(7, data.e); break;
 	case inst_cb_SET_7_H: cycles = SET_B_R8(7, data.h); break;
 	case inst_cb_SET_7_L: cycles = SET_B_R8(7, data.l); break;
-	case inst_cb_SET_7_HL: cycles = SET_B_HL(7, data.h, data.l); break;
+	case inst_cb_SET_7_HL: cycles = SET_B_HL(7, data.hl); break;
 	case inst_cb_SET_7_A: cycles = SET_B_R8(7, data.a); break;
 
 	}	
@@ -820,10 +966,19 @@ void CPU::write_to_bus(const ushort& address, const byte& value) {
 }
 
 const bool CPU::get_flag_state(const cpu_flags& flag) {
+	if (lazy_op != lazy_NONE) {
+		materialise_flags();
+	}
+
 	return (data.f & (1 << flag)) != 0;
 }
 
 void CPU::set_flag_state(const cpu_flags& flag, const bool& state) {
+	//partial flag updates (inc/dec/ccf...) keep the other flags, so they need them worked out first
+	if (lazy_op != lazy_NONE) {
+		materialise_flags();
+	}
+
 	if (state) {
 		data.f |= (1 << flag);
 	}
@@ -833,3 +988,52 @@ void CPU::set_flag_state(const cpu_flags& flag, const bool& state) {
 
 	data.f &= 0xf0;
 }
+
+void CPU::set_lazy_flags(const lazy_flag_ops& op, const byte& lhs, const byte& rhs, const bool& carry_in) {
+	lazy_op = op;
+	lazy_lhs = lhs;
+	lazy_rhs = rhs;
+	lazy_carry_in = carry_in;
+}
+
+void CPU::materialise_flags() {
+	bool zero = false;
+	bool subtraction = false;
+	bool half_carry = false;
+	bool carry = false;
+
+	switch (lazy_op) {
+	case lazy_ADD: {
+		int result = lazy_lhs + lazy_rhs + lazy_carry_in;
+		zero = (byte)result == 0;
+		half_carry = (lazy_lhs & 0xf) + (lazy_rhs & 0xf) + lazy_carry_in > 0xf;
+		carry = result > 0xff;
+		break;
+	}
+
+	case lazy_SUB: {
+		int result = lazy_lhs - lazy_rhs - lazy_carry_in;
+		zero = (byte)result == 0;
+		subtraction = true;
+		half_carry = (lazy_lhs & 0xf) < (lazy_rhs & 0xf) + lazy_carry_in;
+		carry = lazy_lhs < lazy_rhs + lazy_carry_in;
+		break;
+	}
+
+	//logic ops record their result in lhs
+	case lazy_AND:
+		zero = lazy_lhs == 0;
+		half_carry = true;
+		break;
+
+	case lazy_OR:
+		zero = lazy_lhs == 0;
+		break;
+
+	default:
+		return;
+	}
+
+	data.f = (byte)((zero << flags_ZERO) | (subtraction << flags_SUBTRACTION) | (half_carry << flags_HALFCARRY) | (carry << flags_CARRY));
+	lazy_op = lazy_NONE;
+}
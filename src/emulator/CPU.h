@@ -4,11 +4,14 @@
 #include <array>
 
 #include "_definitions.h"
+#include "Instruction_trace.h"
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 class Emulator;
+class CPU;
 
 struct single_step_test_cycle {
 	ushort address = 0x0000;
@@ -16,6 +19,62 @@ struct single_step_test_cycle {
 	std::string operation = std::string("");
 };
 
+const int MAX_CACHED_BLOCK_LENGTH = 64;
+const int BLOCK_HOT_THRESHOLD = 2;
+
+//every block comes out of a pool allocated with the cpu, a full pool flushes the cache rather than growing
+const int MAX_CACHED_BLOCKS = 4096;
+
+//a page has at most 0x100 block starts plus the blocks running into it from the page before
+const int MAX_BLOCKS_PER_PAGE = 0x200;
+static_assert(MAX_CACHED_BLOCK_LENGTH * 3 <= 0x100, "a block has to fit in two pages for MAX_BLOCKS_PER_PAGE to hold");
+
+struct cached_block;
+
+//last exit taken out of a block, followed without going back through the lookup table
+struct cached_block_link {
+	ushort address = 0x0000;
+	cached_block* block = nullptr;
+	uint32_t generation = 0;
+};
+
+//one opcode's body with the opcode switch folded away at compile time, see CPU::opcode_handlers
+typedef void (*opcode_handler)(CPU& cpu, int& cycles);
+
+//opcode, immediates and handler of one instruction, decoded once when its block is built
+struct cached_instruction {
+	byte opcode = 0x00;
+	byte length = 0;
+	std::array<byte, 2> operands = std::array<byte, 2>();
+	opcode_handler handler = nullptr;
+};
+
+//straight line run of instructions ending at a branch, keyed by (bank, start address)
+struct cached_block {
+	int bank = 0;
+	ushort start_address = 0x0000;
+	ushort end_address = 0x0000;
+	std::vector<cached_instruction> instructions = std::vector<cached_instruction>();
+
+	//[0] falls through past end_address, [1] is the last branch target taken
+	std::array<cached_block_link, 2> links = std::array<cached_block_link, 2>();
+};
+
+//start addresses of the blocks covering one page, fixed size so building blocks never touches the heap
+struct cached_page_blocks {
+	std::array<ushort, MAX_BLOCKS_PER_PAGE> starts = std::array<ushort, MAX_BLOCKS_PER_PAGE>();
+	int count = 0;
+};
+
+//everything needed to resume execution, the block cache is left to rebuild itself
+struct cpu_snapshot {
+	cpu_data data = cpu_data();
+	bool enable_ime_next_cycle = false;
+	byte interrupt_pending = 0x00;
+	bool halt_bug_next_instruction = false;
+	uint64_t elapsed_cycles = 0;
+};
+
 class CPU {
 public:
 	CPU(std::shared_ptr<Emulator> emulator_ptr);
@@ -28,7 +87,30 @@ public:
 
 	const cpu_data& get_data();
 
+	//execution engine, the cached engine runs predecoded blocks
+	void set_engine(const cpu_engines& engine);
+	const cpu_engines& get_engine() const;
+
+	//block cache invalidation (self modifying code, rom/bank writes)
+	void invalidate_code_page(const byte& page);
+	void invalidate_block_cache();
+
+	//binary instruction trace, owned by the emulator, nullptr when not tracing
+	void set_instruction_trace(Instruction_trace* instruction_trace);
+
+	//breakpoints are checked before each instruction only while armed
+	void set_breakpoints_armed(const bool& armed);
+
+	//snapshots + state hashing for the divergence finder
+	void save_state(cpu_snapshot& snapshot);
+	void load_state(const cpu_snapshot& snapshot);
+	uint64_t get_state_hash(const uint64_t& hash);
+	const uint64_t& get_elapsed_cycles() const;
+
 private:
+	void execute_step(int& cycles, const bool& print_debug_to_console);
+	void execute_hooked_step(int& cycles, const bool& print_debug_to_console);
+	void record_trace();
 	void internal_cycle_other_components();
 	byte fetch_opcode();
 	byte fetch_next_byte();
@@ -39,6 +121,12 @@ private:
 	void execute_opcode(int& cycles, const byte& opcode);
 	void execute_cb_opcode(int& cycles);
 
+	//threaded dispatch, one handler per opcode so cached blocks call straight into the instruction
+	template<byte OPCODE> void execute_fixed_opcode(int& cycles);
+	template<byte OPCODE> static void execute_opcode_handler(CPU& cpu, int& cycles);
+	template<size_t... OPCODES> static constexpr std::array<opcode_handler, 0x100> make_opcode_handlers(std::index_sequence<OPCODES...>);
+	static const std::array<opcode_handler, 0x100> opcode_handlers;
+
 	//read/write to memory
 	byte read_from_bus(const ushort& address);
 	void write_to_bus(const ushort& address, const byte& value);
@@ -46,6 +134,10 @@ private:
 	const bool get_flag_state(const cpu_flags& flag);
 	void set_flag_state(const cpu_flags& flag, const bool& state);
 
+	//lazy flags, alu ops record their inputs and f is rebuilt on the next flag read/write
+	void set_lazy_flags(const lazy_flag_ops& op, const byte& lhs, const byte& rhs, const bool& carry_in);
+	void materialise_flags();
+
 private:
 	std::shared_ptr<Emulator> emulator_ptr;
 	bool initialised = false;
@@ -55,66 +147,107 @@ private:
 	byte interrupt_pending = 0x00;
 
 	bool halt_bug_next_instruction = false;
+
+	uint64_t elapsed_cycles = 0;
+	Instruction_trace* instruction_trace = nullptr;
+	byte step_hooks = hook_NONE;
+	void (CPU::*step_path)(int& cycles, const bool& print_debug_to_console) = &CPU::execute_step;
+
+	lazy_flag_ops lazy_op = lazy_NONE;
+	byte lazy_lhs = 0x00;
+	byte lazy_rhs = 0x00;
+	bool lazy_carry_in = false;
+
+	//predecoded block cache, see Block_cache.cpp
+	cpu_engines engine = engine_CACHED;
+
+	//direct mapped on start address, the bank stored in the block is checked on lookup
+	std::vector<std::unique_ptr<cached_block>> block_cache = std::vector<std::unique_ptr<cached_block>>(0x10000);
+	std::array<cached_page_blocks, 0x100> blocks_in_page = std::array<cached_page_blocks, 0x100>();
+	std::vector<byte> block_entry_counts = std::vector<byte>(0x10000);
+	uint32_t block_generation = 0;
+
+	//unused blocks from the pool, invalidated blocks go back here so code that keeps getting rewritten does not go back to the heap
+	std::vector<std::unique_ptr<cached_block>> free_blocks = std::vector<std::unique_ptr<cached_block>>();
+
+	cached_block* current_block = nullptr;
+	size_t current_block_index = 0;
+	ushort next_cached_address = 0x0000;
+
+	const cached_instruction* current_instruction = nullptr;
+	int current_operand_index = 0;
+
+private:
+	void allocate_block_pool();
+	const cached_instruction* fetch_cached_instruction();
+	cached_block* find_cached_block(const ushort& address);
+	cached_block* build_cached_block(const ushort& address, const int& bank);
+	cached_block* insert_cached_block(std::unique_ptr<cached_block> block);
+	std::unique_ptr<cached_block> acquire_cached_block(const ushort& address, const int& bank);
+	void release_cached_block(std::unique_ptr<cached_block> block);
+	int get_cache_region(const ushort& address);
+	void reset_block_cursor();
+
 private:
 	//opcode functions (include memory vector and cycles for testing)
 
 	//8 bit load instructions
 	int LD_R8_R8(byte& register_one, const byte& register_two);
 	int LD_R8_N8(byte& register_one);
-	int LD_R8_HL(byte& register_one, const byte& h, const byte& l);
-	int LD_HL_R8(const byte& h, const byte& l, const byte& );
-	int LD_HL_N8(const byte& h, const byte& l);
-	int LD_A_R16(byte& a, const byte& register_high, const byte& register_low);
-	int LD_R16_A(const byte& register_high, const byte& register_low, const byte& a);
+	int LD_R8_HL(byte& register_one, const ushort& hl);
+	int LD_HL_R8(const ushort& hl, const byte& register_value);
+	int LD_HL_N8(const ushort& hl);
+	int LD_A_R16(byte& a, const ushort& register_pair);
+	int LD_R16_A(const ushort& register_pair, const byte& a);
 	int LD_A_N16(byte& a);
 	int LD_N16_A(const byte& a);
 	int LDH_A_C(byte& a, const byte& c);
 	int LDH_C_A(const byte& c, const byte& a);
 	int LDH_A_N8(byte& a);
 	int LDH_N8_A(const byte& a);
-	int LD_A_HLDEC(byte& a, byte& h, byte& l);
-	int LD_HLDEC_A(byte& h, byte& l, const byte& a);
-	int LD_A_HLINC(byte& a, byte& h, byte& l);
-	int LD_HLINC_A(byte& h, byte& l, const byte& a);
+	int LD_A_HLDEC(byte& a, ushort& hl);
+	int LD_HLDEC_A(ushort& hl, const byte& a);
+	int LD_A_HLINC(byte& a, ushort& hl);
+	int LD_HLINC_A(ushort& hl, const byte& a);
 
 	//16 bit load instructions
-	int LD_R16_N16(byte& register_high, byte& register_low);
+	int LD_R16_N16(ushort& register_pair);
 	int LD_N16_SP(const ushort& sp);
 	int LD_SP_N16(ushort& sp);
-	int LD_SP_HL(ushort& sp, const byte& h, const byte& l);
-	int PUSH_R16(ushort& sp, const byte& register_high, const byte& register_low);
-	int POP_AF(ushort& sp, byte& a, byte& f);
-	int POP_R16(ushort& sp, byte& register_high, byte& register_low);
-	int LD_HL_SP_E8(byte& h, byte& l, const ushort& sp);
+	int LD_SP_HL(ushort& sp, const ushort& hl);
+	int PUSH_R16(ushort& sp, const ushort& register_pair);
+	int POP_AF(ushort& sp, ushort& af);
+	int POP_R16(ushort& sp, ushort& register_pair);
+	int LD_HL_SP_E8(ushort& hl, const ushort& sp);
 
 	//8 bit arithmetic and logic instructions
 	int ADD_R8(byte& a, const byte& register_value);
-	int ADD_HL(byte& a, const byte& h, const byte& l);
+	int ADD_HL(byte& a, const ushort& hl);
 	int ADD_N8(byte& a);
 	int ADC_R8(byte& a, const byte& register_value);
-	int ADC_HL(byte& a, const byte& h, const byte& l);
+	int ADC_HL(byte& a, const ushort& hl);
 	int ADC_N8(byte& a);
 	int SUB_R8(byte& a, const byte& register_value);
-	int SUB_HL(byte& a, const byte& h, const byte& l);
+	int SUB_HL(byte& a, const ushort& hl);
 	int SUB_N8(byte& a);
 	int SBC_R8(byte& a, const byte& register_value);
-	int SBC_HL(byte& a, const byte& h, const byte& l);
+	int SBC_HL(byte& a, const ushort& hl);
 	int SBC_N8(byte& a);
 	int CP_R8(const byte& a, const byte& register_value);
-	int CP_HL(const byte& a, const byte& h, const byte& l);
+	int CP_HL(const byte& a, const ushort& hl);
 	int CP_N8(const byte& a);
 	int INC_R8(byte& register_value);
-	int INC_HL(const byte& h, const byte& l);
+	int INC_HL(const ushort& hl);
 	int DEC_R8(byte& register_value);
-	int DEC_HL(const byte& h, const byte& l);
+	int DEC_HL(const ushort& hl);
 	int AND_R8(byte& a, const byte& register_value);
-	int AND_HL(byte& a, const byte& h, const byte& l);
+	int AND_HL(byte& a, const ushort& hl);
 	int AND_N8(byte& a);
 	int OR_R8(byte& a, const byte& register_value);
-	int OR_HL(byte& a, const byte& h, const byte& l);
+	int OR_HL(byte& a, const ushort& hl);
 	int OR_N8(byte& a);
 	int XOR_R8(byte& a, const byte& register_value);
-	int XOR_HL(byte& a, const byte& h, const byte& l);
+	int XOR_HL(byte& a, const ushort& hl);
 	int XOR_N8(byte& a);
 	int CCF();
 	int SCF();
@@ -122,9 +255,9 @@ private:
 	int CPL(byte& a);
 
 	//16 bit arithmetic instructions
-	int INC_R16(byte& register_high, byte& register_low);
-	int DEC_R16(byte& register_high, byte& register_low);
-	int ADD_HL_R16(byte& h, byte& l, const byte& register_high, const byte& register_low);
+	int INC_R16(ushort& register_pair);
+	int DEC_R16(ushort& register_pair);
+	int ADD_HL_R16(ushort& hl, const ushort& register_pair);
 	int ADD_SP_E8(ushort& sp);
 
 	//rotate shift and bit op instructions
@@ -133,31 +266,31 @@ private:
 	int RLA(byte& a);
 	int RRA(byte& a);
 	int RLC_R8(byte& register_value);
-	int RLC_HL(const byte& h, const byte& l);
+	int RLC_HL(const ushort& hl);
 	int RRC_R8(byte& register_value);
-	int RRC_HL(const byte& h, const byte& l);
+	int RRC_HL(const ushort& hl);
 	int RL_R8(byte& register_value);
-	int RL_HL(const byte& h, const byte& l);
+	int RL_HL(const ushort& hl);
 	int RR_R8(byte& register_value);
-	int RR_HL(const byte& h, const byte& l);
+	int RR_HL(const ushort& hl);
 	int SLA_R8(byte& register_value);
-	int SLA_HL(const byte& h, const byte& l);
+	int SLA_HL(const ushort& hl);
 	int SRA_R8(byte& register_value);
-	int SRA_HL(const byte& h, const byte& l);
+	int SRA_HL(const ushort& hl);
 	int SWAP_R8(byte& register_value);
-	int SWAP_HL(const byte& h, const byte& l);
+	int SWAP_HL(const ushort& hl);
 	int SRL_R8(byte& register_value);
-	int SRL_HL(const byte& h, const byte& l);
+	int SRL_HL(const ushort& hl);
 	int BIT_B_R8(const int& bit, const byte& register_value);
-	int BIT_B_HL(const int& bit, const byte& h, const byte& l);
+	int BIT_B_HL(const int& bit, const ushort& hl);
 	int RES_B_R8(const int& bit, byte& register_value);
-	int RES_B_HL(const int& bit, const byte& h, const byte& l);
+	int RES_B_HL(const int& bit, const ushort& hl);
 	int SET_B_R8(const int& bit, byte& register_value);
-	int SET_B_HL(const int& bit, const byte& h, const byte& l);
+	int SET_B_HL(const int& bit, const ushort& hl);
 
 	//control flow instructions
 	int JP_N16();
-	int JP_HL(const byte& h, const byte& l);
+	int JP_HL(const ushort& hl);
 	int JP_CC_N16(const bool& condition);
 	int JR_E8();
 	int JR_CC_E8(const bool& condition);
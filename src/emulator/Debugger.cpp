@@ -0,0 +1,149 @@
+#include "Debugger.h"
+#include <cstdio>
+
+Debugger::Debugger() {
+	rebuild_lookups();
+}
+
+Debugger::~Debugger() {
+	printf("[SB] Shutting down DEBUGGER object\n");
+}
+
+void Debugger::add_breakpoint(const ushort& address, const int& bank) {
+	for (const breakpoint& existing : breakpoints) {
+		if (existing.address == address && existing.bank == bank) {
+			return;
+		}
+	}
+
+	breakpoint entry = breakpoint();
+	entry.address = address;
+	entry.bank = bank;
+	breakpoints.push_back(entry);
+
+	rebuild_lookups();
+}
+
+void Debugger::remove_breakpoint(const int& index) {
+	if (index < 0 || index >= (int)breakpoints.size()) {
+		return;
+	}
+
+	breakpoints.erase(breakpoints.begin() + index);
+	rebuild_lookups();
+}
+
+void Debugger::add_watchpoint(const ushort& address, const watch_access& access, const watch_conditions& condition, const byte& value) {
+	watchpoint entry = watchpoint();
+	entry.address = address;
+	entry.access = access;
+	entry.condition = condition;
+	entry.value = value;
+	watchpoints.push_back(entry);
+
+	rebuild_lookups();
+}
+
+void Debugger::remove_watchpoint(const int& index) {
+	if (index < 0 || index >= (int)watchpoints.size()) {
+		return;
+	}
+
+	watchpoints.erase(watchpoints.begin() + index);
+	rebuild_lookups();
+}
+
+const std::vector<breakpoint>& Debugger::get_breakpoints() const {
+	return breakpoints;
+}
+
+const std::vector<watchpoint>& Debugger::get_watchpoints() const {
+	return watchpoints;
+}
+
+bool Debugger::has_breakpoints() const {
+	return !breakpoints.empty();
+}
+
+byte Debugger::get_watch_page_flags(const byte& page) const {
+	return watch_page_flags[page];
+}
+
+bool Debugger::check_breakpoint(const ushort& pc, const int& bank) {
+	//the first instruction after resuming is the one we stopped on
+	if (resuming) {
+		resuming = false;
+		if (pc == resume_pc) {
+			return false;
+		}
+	}
+
+	if ((breakpoint_bitmap[pc >> 6] & (1ull << (pc & 63))) == 0) {
+		return false;
+	}
+
+	for (int i = 0; i < (int)breakpoints.size(); i++) {
+		breakpoint& entry = breakpoints[i];
+		if (entry.address == pc && (entry.bank < 0 || entry.bank == bank)) {
+			entry.hits++;
+
+			last_break = { break_BREAKPOINT, i, pc, 0x00 };
+			break_pending = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Debugger::check_watchpoint(const ushort& address, const byte& value, const watch_access& access) {
+	for (int i = 0; i < (int)watchpoints.size(); i++) {
+		watchpoint& entry = watchpoints[i];
+		if (entry.address != address || (entry.access & access) == 0) {
+			continue;
+		}
+
+		if ((entry.condition == condition_EQUAL && value != entry.value) || (entry.condition == condition_NOT_EQUAL && value == entry.value)) {
+			continue;
+		}
+
+		entry.hits++;
+
+		//the access finishes its instruction, the run loop stops straight after
+		last_break = { access == watch_READ ? break_WATCH_READ : break_WATCH_WRITE, i, address, value };
+		break_pending = true;
+		return;
+	}
+}
+
+bool Debugger::is_break_pending() const {
+	return break_pending;
+}
+
+const debug_break& Debugger::get_last_break() const {
+	return last_break;
+}
+
+void Debugger::resume(const ushort& pc) {
+	if (!break_pending) {
+		return;
+	}
+
+	break_pending = false;
+	resuming = true;
+	resume_pc = pc;
+}
+
+//privates
+void Debugger::rebuild_lookups() {
+	breakpoint_bitmap.fill(0);
+	for (const breakpoint& entry : breakpoints) {
+		breakpoint_bitmap[entry.address >> 6] |= 1ull << (entry.address & 63);
+	}
+
+	watch_page_flags.fill(page_NONE);
+	for (const watchpoint& entry : watchpoints) {
+		byte flags = ((entry.access & watch_READ) ? page_WATCH_READ : page_NONE) | ((entry.access & watch_WRITE) ? page_WATCH_WRITE : page_NONE);
+		watch_page_flags[entry.address >> 8] |= flags;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "_definitions.h"
+#include <vector>
+#include <array>
+
+//pc breakpoints + memory watchpoints, only looked at while something is armed
+//breakpoints are found through a per pc bitmap, watchpoints flag their 256 byte page (page_WATCH_READ/WRITE)
+//so the cpu and mmu skip this entirely when nothing is set (see Emulator::refresh_debug_hooks)
+
+struct breakpoint {
+	ushort address = 0x0000;
+	int bank = -1; //-1 matches any bank
+	uint64_t hits = 0;
+};
+
+struct watchpoint {
+	ushort address = 0x0000;
+	watch_access access = watch_WRITE;
+	watch_conditions condition = condition_ANY;
+	byte value = 0x00;
+	uint64_t hits = 0;
+};
+
+//why execution last stopped, index is into the breakpoint/watchpoint list it came from
+struct debug_break {
+	debug_break_reasons reason = break_NONE;
+	int index = -1;
+	ushort address = 0x0000;
+	byte value = 0x00;
+};
+
+class Debugger {
+public:
+	Debugger();
+	~Debugger();
+
+	//editing, the emulator refreshes the cpu hooks and page flags afterwards
+	void add_breakpoint(const ushort& address, const int& bank);
+	void remove_breakpoint(const int& index);
+	void add_watchpoint(const ushort& address, const watch_access& access, const watch_conditions& condition, const byte& value);
+	void remove_watchpoint(const int& index);
+
+	const std::vector<breakpoint>& get_breakpoints() const;
+	const std::vector<watchpoint>& get_watchpoints() const;
+	bool has_breakpoints() const;
+	byte get_watch_page_flags(const byte& page) const;
+
+	//called from the cpu step/mmu for pcs and pages flagged above
+	bool check_breakpoint(const ushort& pc, const int& bank);
+	void check_watchpoint(const ushort& address, const byte& value, const watch_access& access);
+
+	//a pending break stops the frontend's run loop, resuming steps over the breakpoint at pc once
+	bool is_break_pending() const;
+	const debug_break& get_last_break() const;
+	void resume(const ushort& pc);
+
+private:
+	void rebuild_lookups();
+
+private:
+	std::vector<breakpoint> breakpoints = std::vector<breakpoint>();
+	std::vector<watchpoint> watchpoints = std::vector<watchpoint>();
+
+	std::array<uint64_t, 0x10000 / 64> breakpoint_bitmap = std::array<uint64_t, 0x10000 / 64>();
+	std::array<byte, 0x100> watch_page_flags = std::array<byte, 0x100>();
+
+	debug_break last_break = debug_break();
+	bool break_pending = false;
+	bool resuming = false;
+	ushort resume_pc = 0x0000;
+};
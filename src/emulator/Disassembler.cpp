@@ -0,0 +1,156 @@
+#include "Disassembler.h"
+#include "Emulator.h"
+#include "Opcode_info.h"
+#include <cstdio>
+#include <algorithm>
+
+Disassembler::Disassembler(std::shared_ptr<Emulator> emulator_ptr) {
+	this->emulator_ptr = emulator_ptr;
+}
+
+Disassembler::~Disassembler() {
+	this->emulator_ptr.reset();
+	this->emulator_ptr = nullptr;
+
+	printf("[SB] Shutting down DISASSEMBLER object\n");
+}
+
+const std::vector<disassembly_line>& Disassembler::get_window(const ushort& address, const int& lines_before, const int& lines_after) {
+	if (window_valid && window_address == address && window_before == lines_before && window_after == lines_after) {
+		return window;
+	}
+
+	window.clear();
+
+	ushort line_address = find_window_start(address, lines_before);
+	int line_count = 0;
+	while (line_count < lines_before + lines_after + 1) {
+		const disassembly_line& line = get_line(line_address);
+		window.push_back(line);
+		line_address = (ushort)(line_address + line.length);
+		line_count++;
+
+		if (line_address < window.back().address) {
+			break; //wrapped past 0xffff
+		}
+	}
+
+	window_address = address;
+	window_before = lines_before;
+	window_after = lines_after;
+	window_valid = true;
+	return window;
+}
+
+void Disassembler::invalidate_page(const byte& page) {
+	for (const uint32_t& key : lines_in_page[page]) {
+		lines.erase(key);
+	}
+
+	lines_in_page[page].clear();
+	emulator_ptr->clear_memory_page_flag(page, page_DISASSEMBLED);
+	window_valid = false;
+}
+
+void Disassembler::invalidate_all() {
+	for (int page = 0; page < 0x100; page++) {
+		invalidate_page((byte)page);
+	}
+}
+
+int Disassembler::format_instruction(const std::array<byte, 3>& bytes, const ushort& address, char* text, const size_t& size) {
+	const opcode_info* info = &opcode_table[bytes[0]];
+	if (bytes[0] == inst_CB) {
+		info = &cb_opcode_table[bytes[1]];
+	}
+
+	if (info->length == 0) {
+		snprintf(text, size, "DB $%02X", bytes[0]);
+		return 1;
+	}
+
+	char immediate[8] = "";
+	ushort value16 = (ushort)((bytes[2] << 8) | bytes[1]);
+	switch (info->operand) {
+	case opnd_N8: snprintf(immediate, sizeof(immediate), "$%02X", bytes[1]); break;
+	case opnd_N16: case opnd_A16: snprintf(immediate, sizeof(immediate), "$%04X", value16); break;
+	case opnd_A8: snprintf(immediate, sizeof(immediate), "$FF%02X", bytes[1]); break;
+	case opnd_E8: snprintf(immediate, sizeof(immediate), "$%04X", (ushort)(address + 2 + (int8_t)bytes[1])); break;
+	case opnd_E8_SIGNED: snprintf(immediate, sizeof(immediate), "%+d", (int8_t)bytes[1]); break;
+	default: break;
+	}
+
+	//mnemonic, then the operand text with # swapped for the immediate
+	size_t length = (size_t)snprintf(text, size, info->operands[0] == '\0' ? "%s" : "%s ", info->mnemonic);
+	for (const char* c = info->operands; *c != '\0' && length + 1 < size; c++) {
+		if (*c == '#') {
+			for (const char* i = immediate; *i != '\0' && length + 1 < size; i++) {
+				text[length++] = *i;
+			}
+		}
+		else {
+			text[length++] = *c;
+		}
+	}
+	text[std::min(length, size - 1)] = '\0';
+
+	return info->length;
+}
+
+//privates
+const disassembly_line& Disassembler::get_line(const ushort& address) {
+	int bank = emulator_ptr->get_memory_bank(address);
+	uint32_t key = ((uint32_t)bank << 16) | address;
+
+	auto cached = lines.find(key);
+	if (cached != lines.end()) {
+		return cached->second;
+	}
+
+	disassembly_line line = disassembly_line();
+	line.bank = bank;
+	line.address = address;
+	for (int i = 0; i < 3; i++) {
+		line.bytes[i] = emulator_ptr->memory_instant_read((ushort)(address + i));
+	}
+	line.length = (byte)format_instruction(line.bytes, address, line.text.data(), line.text.size());
+
+	//flag every page the instruction's bytes sit in so a write to any of them drops it
+	byte first_page = (byte)(address >> 8);
+	byte last_page = (byte)((address + line.length - 1) >> 8);
+	lines_in_page[first_page].push_back(key);
+	emulator_ptr->set_memory_page_flag(first_page, page_DISASSEMBLED);
+	if (last_page != first_page) {
+		lines_in_page[last_page].push_back(key);
+		emulator_ptr->set_memory_page_flag(last_page, page_DISASSEMBLED);
+	}
+
+	return lines.emplace(key, line).first->second;
+}
+
+//the bytes before address can decode several ways, start as far back as possible from where decoding lands exactly on address
+ushort Disassembler::find_window_start(const ushort& address, const int& lines_before) {
+	int max_distance = std::min((int)address, lines_before * 3);
+	for (int distance = max_distance; distance > 0; distance--) {
+		ushort line_address = (ushort)(address - distance);
+		int line_count = 0;
+		while (line_address < address) {
+			line_address = (ushort)(line_address + get_line(line_address).length);
+			line_count++;
+		}
+
+		if (line_address != address) {
+			continue;
+		}
+
+		//drop the oldest lines when the walk found more than asked for
+		line_address = (ushort)(address - distance);
+		while (line_count > lines_before) {
+			line_address = (ushort)(line_address + get_line(line_address).length);
+			line_count--;
+		}
+		return line_address;
+	}
+
+	return address;
+}
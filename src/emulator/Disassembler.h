@@ -0,0 +1,50 @@
+#pragma once
+
+#include "_definitions.h"
+#include <memory>
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+class Emulator;
+
+//disassembly for the debugger windows, decoded through the tables in Opcode_info.h
+//lines are cached per (bank, address) and their pages flagged page_DISASSEMBLED, a write there drops them again
+
+struct disassembly_line {
+	int bank = 0;
+	ushort address = 0x0000;
+	byte length = 1;
+	std::array<byte, 3> bytes = std::array<byte, 3>();
+	std::array<char, 32> text = std::array<char, 32>();
+};
+
+class Disassembler {
+public:
+	Disassembler(std::shared_ptr<Emulator> emulator_ptr);
+	~Disassembler();
+
+	//lines around an address, the returned window is reused until the address moves or its memory is written
+	const std::vector<disassembly_line>& get_window(const ushort& address, const int& lines_before, const int& lines_after);
+	void invalidate_page(const byte& page);
+	void invalidate_all();
+
+	//one instruction from up to 3 bytes at address, returns its length
+	static int format_instruction(const std::array<byte, 3>& bytes, const ushort& address, char* text, const size_t& size);
+
+private:
+	const disassembly_line& get_line(const ushort& address);
+	ushort find_window_start(const ushort& address, const int& lines_before);
+
+private:
+	std::shared_ptr<Emulator> emulator_ptr;
+
+	std::unordered_map<uint32_t, disassembly_line> lines = std::unordered_map<uint32_t, disassembly_line>();
+	std::array<std::vector<uint32_t>, 0x100> lines_in_page = std::array<std::vector<uint32_t>, 0x100>();
+
+	std::vector<disassembly_line> window = std::vector<disassembly_line>();
+	ushort window_address = 0x0000;
+	int window_before = 0;
+	int window_after = 0;
+	bool window_valid = false;
+};
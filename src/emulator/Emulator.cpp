@@ -1,9 +1,18 @@
 #include "Emulator.h"
+#include "Opcode_info.h"
 
 Emulator::Emulator() {
 	this->using_boot_rom = false;
 	this->single_step_test_mode = false;
 
+	//the sampled component timings would otherwise be mostly the cost of reading the clock
+	const int calibration_reads = 1000;
+	auto calibration_start = std::chrono::steady_clock::now();
+	for (int i = 0; i < calibration_reads; i++) {
+		std::chrono::steady_clock::now();
+	}
+	this->perf_clock_overhead_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - calibration_start).count() / calibration_reads;
+
 	this->initialised = true;
 }
 
@@ -85,6 +94,22 @@ int Emulator::initialise_emu_instance(const std::string& rom_file_name, const bo
 	}
 	PPU_ptr->reset_ppu();
 
+	current_emulator_instance->JOYPAD_ptr = std::make_unique<Joypad>(this->current_emulator_instance);
+
+#ifdef SHARPBOY_PROFILER
+	//pick up symbols sitting next to the rom (game.gb -> game.sym)
+	current_emulator_instance->PROFILER_ptr = std::make_unique<Profiler>(header);
+	PROFILER_ptr->load_symbols(std::filesystem::path(rom_file_name).replace_extension(".sym").string());
+#endif
+
+#ifdef SHARPBOY_HEATMAP
+	current_emulator_instance->HEATMAP_ptr = std::make_unique<Heatmap>(header);
+#endif
+
+	current_emulator_instance->DEBUGGER_ptr = std::make_unique<Debugger>();
+	current_emulator_instance->DISASSEMBLER_ptr = std::make_unique<Disassembler>(this->current_emulator_instance);
+	current_emulator_instance->MEMORY_VIEW_ptr = std::make_unique<Memory_view>(this->current_emulator_instance);
+
 	if (using_boot_rom) {
 		tick_other_components(4);
 	}
@@ -113,8 +138,28 @@ const bool& Emulator::is_using_boot_rom() const {
 void Emulator::close_emulator() {
 	printf("+----------------------------------------+\n");
 
+	stop_instruction_trace();
+	TRACE_ptr.reset();
+	TRACE_ptr = nullptr;
+	DEBUGGER_ptr.reset();
+	DEBUGGER_ptr = nullptr;
+	DISASSEMBLER_ptr.reset();
+	DISASSEMBLER_ptr = nullptr;
+	MEMORY_VIEW_ptr.reset();
+	MEMORY_VIEW_ptr = nullptr;
+	JOYPAD_ptr.reset();
+	JOYPAD_ptr = nullptr;
+
 	PPU_ptr.reset();
 	PPU_ptr = nullptr;
+#ifdef SHARPBOY_PROFILER
+	PROFILER_ptr.reset();
+	PROFILER_ptr = nullptr;
+#endif
+#ifdef SHARPBOY_HEATMAP
+	HEATMAP_ptr.reset();
+	HEATMAP_ptr = nullptr;
+#endif
 	MMU_ptr.reset();
 	MMU_ptr = nullptr;
 	TIMER_ptr.reset();
@@ -131,12 +176,217 @@ void Emulator::close_emulator() {
 int Emulator::run_next_instruction() {
 	int cycles_completed = 0;
 	CPU_ptr->step_cpu(cycles_completed, false);
+
+	current_perf_frame.instructions++;
+	current_perf_frame.cycles += cycles_completed;
 	return cycles_completed;
 }
 
+void Emulator::set_cpu_engine(const cpu_engines& engine) {
+	CPU_ptr->set_engine(engine);
+}
+
+cpu_engines Emulator::get_cpu_engine() {
+	return CPU_ptr->get_engine();
+}
+
+
+
+bool Emulator::start_instruction_trace(const std::string& file_name) {
+	if (TRACE_ptr == nullptr) {
+		TRACE_ptr = std::make_unique<Instruction_trace>();
+	}
+
+	if (!TRACE_ptr->start(file_name)) {
+		return false;
+	}
+
+	CPU_ptr->set_instruction_trace(TRACE_ptr.get());
+	return true;
+}
+
+void Emulator::stop_instruction_trace() {
+	if (TRACE_ptr == nullptr) {
+		return;
+	}
+
+	if (CPU_ptr != nullptr) {
+		CPU_ptr->set_instruction_trace(nullptr);
+	}
+	TRACE_ptr->stop();
+}
+
+bool Emulator::is_instruction_trace_running() {
+	return TRACE_ptr != nullptr && TRACE_ptr->is_running();
+}
+
+
+
+void Emulator::add_breakpoint(const ushort& address, const int& bank) {
+	DEBUGGER_ptr->add_breakpoint(address, bank);
+	refresh_debug_hooks();
+}
+
+void Emulator::remove_breakpoint(const int& index) {
+	DEBUGGER_ptr->remove_breakpoint(index);
+	refresh_debug_hooks();
+}
+
+void Emulator::add_watchpoint(const ushort& address, const watch_access& access, const watch_conditions& condition, const byte& value) {
+	DEBUGGER_ptr->add_watchpoint(address, access, condition, value);
+	refresh_debug_hooks();
+}
+
+void Emulator::remove_watchpoint(const int& index) {
+	DEBUGGER_ptr->remove_watchpoint(index);
+	refresh_debug_hooks();
+}
+
+const Debugger* Emulator::get_debugger() const {
+	return DEBUGGER_ptr.get();
+}
+
+bool Emulator::check_breakpoint(const ushort& pc) {
+	return DEBUGGER_ptr->check_breakpoint(pc, MMU_ptr->get_memory_bank(pc));
+}
+
+void Emulator::check_watchpoint(const ushort& address, const byte& value, const watch_access& access) {
+	DEBUGGER_ptr->check_watchpoint(address, value, access);
+}
+
+bool Emulator::is_debug_break_pending() {
+	return DEBUGGER_ptr->is_break_pending();
+}
+
+void Emulator::resume_from_debug_break() {
+	DEBUGGER_ptr->resume(CPU_ptr->get_data().pc);
+}
+
+const std::vector<disassembly_line>& Emulator::get_disassembly(const ushort& address, const int& lines_before, const int& lines_after) {
+	return DISASSEMBLER_ptr->get_window(address, lines_before, lines_after);
+}
+
+void Emulator::invalidate_disassembly_page(const byte& page) {
+	DISASSEMBLER_ptr->invalidate_page(page);
+}
+
+const Memory_view& Emulator::refresh_memory_view() {
+	MEMORY_VIEW_ptr->refresh();
+	return *MEMORY_VIEW_ptr;
+}
+
+void Emulator::copy_address_space(std::array<byte, 0x10000>& bus) {
+	MMU_ptr->copy_address_space(bus);
+}
+
+void Emulator::edit_memory(const ushort& address, const byte& value) {
+	MMU_ptr->edit_memory(address, value);
+	MEMORY_VIEW_ptr->force_refresh();
+}
+
+void Emulator::save_snapshot(emulator_snapshot& snapshot) {
+	CPU_ptr->save_state(snapshot.cpu);
+	JOYPAD_ptr->save_state(snapshot.joypad);
+
+	if (snapshot.mmu == nullptr) {
+		snapshot.mmu = std::make_unique<MMU>(*MMU_ptr);
+		snapshot.timers = std::make_unique<Timers>(*TIMER_ptr);
+		snapshot.ppu = std::make_unique<PPU>(*PPU_ptr);
+	}
+	else {
+		*snapshot.mmu = *MMU_ptr;
+		*snapshot.timers = *TIMER_ptr;
+		*snapshot.ppu = *PPU_ptr;
+	}
+}
+
+void Emulator::load_snapshot(const emulator_snapshot& snapshot) {
+	*MMU_ptr = *snapshot.mmu;
+	*TIMER_ptr = *snapshot.timers;
+	*PPU_ptr = *snapshot.ppu;
+	JOYPAD_ptr->load_state(snapshot.joypad);
+
+	//after the mmu, the cpu clears the code page flags that came back with it
+	CPU_ptr->load_state(snapshot.cpu);
+
+	//watchpoints follow the debugger, not the snapshot, and the memory under the disassembly changed
+	refresh_debug_hooks();
+	DISASSEMBLER_ptr->invalidate_all();
+
+	//the tile viewer has no idea the vram under it changed, nor does the screen texture
+	PPU_ptr->invalidate_tile_cache();
+	PPU_ptr->mark_frame_dirty();
+}
+
+uint64_t Emulator::get_state_hash() {
+	uint64_t hash = CPU_ptr->get_state_hash(STATE_HASH_SEED);
+	hash = MMU_ptr->get_state_hash(hash);
+	hash = TIMER_ptr->get_state_hash(hash);
+	hash = JOYPAD_ptr->get_state_hash(hash);
+	return PPU_ptr->get_state_hash(hash);
+}
+
+uint64_t Emulator::get_elapsed_cycles() {
+	return CPU_ptr->get_elapsed_cycles();
+}
+
+
+
+#ifdef SHARPBOY_PROFILER
+void Emulator::profile_step(const ushort& pc, const int& cycles) {
+	PROFILER_ptr->add_step(MMU_ptr->get_memory_bank(pc), pc, cycles);
+}
+
+void Emulator::profile_call(const ushort& address) {
+	PROFILER_ptr->enter_routine(MMU_ptr->get_memory_bank(address), address);
+}
+
+void Emulator::profile_return() {
+	PROFILER_ptr->leave_routine();
+}
+
+Profiler* Emulator::get_profiler() {
+	return PROFILER_ptr.get();
+}
+#endif
+
+
+
+#ifdef SHARPBOY_HEATMAP
+//the boot rom and the echo ram recursion read before the heatmap exists
+void Emulator::heatmap_read(const ushort& address) {
+	if (HEATMAP_ptr != nullptr) {
+		HEATMAP_ptr->add_read(address, MMU_ptr->get_memory_bank(address));
+	}
+}
+
+void Emulator::heatmap_write(const ushort& address) {
+	if (HEATMAP_ptr != nullptr) {
+		HEATMAP_ptr->add_write(address, MMU_ptr->get_memory_bank(address));
+	}
+}
+
+void Emulator::heatmap_execute(const ushort& address, const byte& opcode) {
+	if (HEATMAP_ptr != nullptr) {
+		byte length = opcode == 0xcb ? 2 : std::max<byte>(instruction_lengths[opcode], 1);
+		HEATMAP_ptr->add_execute(address, MMU_ptr->get_memory_bank(address), length);
+	}
+}
+
+Heatmap* Emulator::get_heatmap() {
+	return HEATMAP_ptr.get();
+}
+#endif
+
 
 
 void Emulator::tick_other_components(const int& cycles) {
+	//only a sample of the calls are timed, reading the clock every t cycle would cost more than the ticks
+	if ((++perf_tick_calls & (PERF_SAMPLE_INTERVAL - 1)) == 0) {
+		tick_other_components_timed(cycles);
+		return;
+	}
+
 	for (int i = 0; i < cycles; i++) {
 		TIMER_ptr->timers_tick();
 		PPU_ptr->ppu_tick();
@@ -145,6 +395,107 @@ void Emulator::tick_other_components(const int& cycles) {
 	}
 }
 
+void Emulator::tick_other_components_timed(const int& cycles) {
+	for (int i = 0; i < cycles; i++) {
+		auto start = std::chrono::steady_clock::now();
+		TIMER_ptr->timers_tick();
+		auto timers_done = std::chrono::steady_clock::now();
+		PPU_ptr->ppu_tick();
+		auto ppu_done = std::chrono::steady_clock::now();
+		MMU_ptr->dma_tick();
+		auto dma_done = std::chrono::steady_clock::now();
+
+		current_perf_frame.host_ns[perf_TIMERS] += get_sampled_ns(start, timers_done);
+		current_perf_frame.host_ns[perf_PPU] += get_sampled_ns(timers_done, ppu_done);
+		current_perf_frame.host_ns[perf_DMA] += get_sampled_ns(ppu_done, dma_done);
+	}
+}
+
+uint64_t Emulator::get_sampled_ns(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end) {
+	int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() - perf_clock_overhead_ns;
+	return nanoseconds > 0 ? (uint64_t)nanoseconds * PERF_SAMPLE_INTERVAL : 0;
+}
+
+//cpu hook + watch page flags mirror the debugger, so nothing is checked while it is empty
+void Emulator::refresh_debug_hooks() {
+	if (DEBUGGER_ptr == nullptr) {
+		return;
+	}
+
+	CPU_ptr->set_breakpoints_armed(DEBUGGER_ptr->has_breakpoints());
+
+	bool read_watch_armed = false;
+	for (int page = 0; page < 0x100; page++) {
+		MMU_ptr->clear_page_flag((byte)page, (memory_page_flags)(page_WATCH_READ | page_WATCH_WRITE));
+
+		byte flags = DEBUGGER_ptr->get_watch_page_flags((byte)page);
+		if (flags != page_NONE) {
+			MMU_ptr->set_page_flag((byte)page, (memory_page_flags)flags);
+		}
+		if (flags & page_WATCH_READ) {
+			read_watch_armed = true;
+		}
+	}
+
+	//reads only pay for the page flag test while a read watchpoint is set
+	mmu_read = read_watch_armed ? &MMU::watched_read_from_memory : &MMU::read_from_memory;
+	MMU_ptr->set_read_watch_armed(read_watch_armed);
+}
+
+void Emulator::add_host_time(const perf_components& component, const uint64_t& nanoseconds) {
+	current_perf_frame.host_ns[component] += nanoseconds;
+}
+
+void Emulator::complete_perf_frame() {
+	//the driver reports all emulation time as cpu, take out the sampled estimates for the other components
+	uint64_t components_ns = current_perf_frame.host_ns[perf_PPU] + current_perf_frame.host_ns[perf_TIMERS] + current_perf_frame.host_ns[perf_DMA];
+	uint64_t& cpu_ns = current_perf_frame.host_ns[perf_CPU];
+	cpu_ns = cpu_ns > components_ns ? cpu_ns - components_ns : 0;
+
+#ifdef SHARPBOY_ALLOC_TRACKING
+	//everything the calling thread allocated since the previous frame ended, ui included when run from the app
+	const alloc_counts& counts = get_thread_alloc_counts();
+	current_perf_frame.allocations = counts.allocations - perf_frame_alloc_start.allocations;
+	current_perf_frame.allocated_bytes = counts.allocated_bytes - perf_frame_alloc_start.allocated_bytes;
+	perf_frame_alloc_start = counts;
+#endif
+
+	stats.last_frame = current_perf_frame;
+	stats.frame_count++;
+
+	perf_window_cycles += current_perf_frame.cycles;
+	perf_window_frames++;
+	current_perf_frame = perf_frame();
+
+	//rates are averaged over roughly a second of wall time, until the first second is up they cover everything so far
+	//so short (headless) runs still report them
+	auto now = std::chrono::steady_clock::now();
+	double elapsed = std::chrono::duration<double>(now - perf_window_start).count();
+	if (elapsed >= 1.0) {
+		stats.cycles_per_second = perf_window_cycles / elapsed;
+		stats.frames_per_second = perf_window_frames / elapsed;
+
+		perf_window_cycles = 0;
+		perf_window_frames = 0;
+		perf_window_start = now;
+		perf_window_filled = true;
+	}
+	else if (!perf_window_filled && elapsed > 0.0) {
+		stats.cycles_per_second = perf_window_cycles / elapsed;
+		stats.frames_per_second = perf_window_frames / elapsed;
+	}
+}
+
+const perf_stats& Emulator::get_perf_stats() const {
+	return stats;
+}
+
+#ifdef SHARPBOY_ALLOC_TRACKING
+void Emulator::reset_perf_alloc_baseline() {
+	perf_frame_alloc_start = get_thread_alloc_counts();
+}
+#endif
+
 void Emulator::trigger_interrupt(const interrupt_types& interrupt) {
 	if (interrupt >= int_VBLANK && interrupt <= int_JOYPAD) {
 		byte IF = io_instant_read(io_IF);
@@ -164,11 +515,29 @@ void Emulator::clear_interrupt(const int& interrupt) {
 
 
 byte Emulator::bus_read(const ushort& address) {
-	byte value = MMU_ptr->read_from_memory(address);
+	current_perf_frame.bus_reads++;
+	byte value = ((*MMU_ptr).*mmu_read)(address);
 	return value;
 }
 
+//instruction fetches, bus traffic but not a data read for the heatmap
+byte Emulator::bus_fetch(const ushort& address) {
+	current_perf_frame.bus_reads++;
+	return MMU_ptr->fetch_from_memory(address);
+}
+
+//fetches served from the block cache skip the bus, the guest still made them
+void Emulator::count_bus_fetch() {
+	current_perf_frame.bus_reads++;
+}
+
+//debug/trace reads and block cache decoding, no side effects and invisible to the heatmap and bus counters
+byte Emulator::memory_instant_read(const ushort& address) {
+	return MMU_ptr->fetch_from_memory(address);
+}
+
 void Emulator::bus_write(const ushort& address, const byte& value) {
+	current_perf_frame.bus_writes++;
 	MMU_ptr->write_to_memory(address, value);
 }
 
@@ -201,12 +570,41 @@ void Emulator::io_instant_write(const byte& io_target, const byte& value) {
 
 
 
+int Emulator::get_memory_bank(const ushort& address) {
+	return MMU_ptr->get_memory_bank(address);
+}
+
+void Emulator::set_memory_page_flag(const byte& page, const memory_page_flags& flag) {
+	MMU_ptr->set_page_flag(page, flag);
+}
+
+void Emulator::clear_memory_page_flag(const byte& page, const memory_page_flags& flag) {
+	MMU_ptr->clear_page_flag(page, flag);
+}
+
+void Emulator::invalidate_code_page(const byte& page) {
+	CPU_ptr->invalidate_code_page(page);
+}
+
+
+
 ppu_modes Emulator::get_current_ppu_mode() {
 	return PPU_ptr->get_current_mode();
 }
 
-std::array<uint32_t, 160 * 144> Emulator::get_frame_buffer() {
-	return PPU_ptr->get_bg_frame_buffer();
+const std::array<byte, 160 * 144>& Emulator::get_shade_buffer() {
+	return PPU_ptr->get_shade_buffer();
+}
+
+//expanded copy for tools/tests, the frontend expands get_shade_buffer straight into its texture
+std::array<uint32_t, 160 * 144> Emulator::get_frame_buffer(const colour_schemes& scheme) {
+	std::array<uint32_t, 160 * 144> frame = std::array<uint32_t, 160 * 144>();
+	expand_shades(PPU_ptr->get_shade_buffer().data(), frame.data(), frame.size(), colour_scheme_table[scheme].colours);
+	return frame;
+}
+
+bool Emulator::take_dirty_lines(int& first_line, int& last_line) {
+	return PPU_ptr->take_dirty_lines(first_line, last_line);
 }
 
 bool Emulator::draw_ready() {
@@ -215,14 +613,72 @@ bool Emulator::draw_ready() {
 
 void Emulator::reset_draw_ready() {
 	PPU_ptr->reset_draw_ready();
+	JOYPAD_ptr->start_frame();
+}
+
+void Emulator::set_joypad_buttons(const byte& buttons) {
+	JOYPAD_ptr->set_host_buttons(buttons);
+}
+
+void Emulator::set_input_poller(input_poller poller, void* context) {
+	JOYPAD_ptr->set_input_poller(poller, context);
+}
+
+//picks up buttons set since the last read so a press raises its interrupt even if the game never reads JOYP
+void Emulator::sync_joypad() {
+	JOYPAD_ptr->sync_input(MMU_ptr->read_io(io_JOYP));
+}
+
+byte Emulator::read_joypad(const byte& select) {
+	return JOYPAD_ptr->read_joyp(select);
+}
+
+byte Emulator::peek_joypad(const byte& select) {
+	return JOYPAD_ptr->peek_joyp(select);
+}
+
+void Emulator::write_joypad(const byte& old_select, const byte& new_select) {
+	JOYPAD_ptr->write_joyp(old_select, new_select);
+}
+
+byte Emulator::take_joypad_read_buttons() {
+	return JOYPAD_ptr->take_read_buttons();
 }
 
 cpu_data Emulator::get_cpu_data() {
 	return CPU_ptr->get_data();
 }
 
-std::array<uint32_t, 64> Emulator::get_next_tile(const int& index) {
-	return PPU_ptr->get_next_tile(index);
+void Emulator::vram_written(const ushort& address) {
+	PPU_ptr->mark_vram_written(address);
+}
+
+void Emulator::oam_written() {
+	PPU_ptr->mark_oam_written();
+}
+
+bool Emulator::take_viewer_dirty_tiles(std::array<bool, TILE_CACHE_TILES>& dirty_tiles) {
+	return PPU_ptr->take_viewer_dirty_tiles(dirty_tiles);
+}
+
+void Emulator::fill_tile_pixels(const int& index, uint32_t* pixels, const int& pitch) {
+	PPU_ptr->fill_tile_pixels(index, pixels, pitch);
+}
+
+byte Emulator::take_ppu_view_changes(const ppu_viewers& viewer) {
+	return PPU_ptr->take_view_changes(viewer);
+}
+
+void Emulator::fill_map_pixels(const int& map, uint32_t* pixels) {
+	PPU_ptr->fill_map_pixels(map, pixels);
+}
+
+void Emulator::fill_sprite_pixels(const byte& tile, const byte& attributes, uint32_t* pixels, const int& pitch) {
+	PPU_ptr->fill_sprite_pixels(tile, attributes, pixels, pitch);
+}
+
+const std::array<byte, OAM_SIZE>& Emulator::get_oam() {
+	return MMU_ptr->get_oam();
 }
 
 
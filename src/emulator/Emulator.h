@@ -12,9 +12,34 @@
 #include "MMU.h"
 #include "Timers.h"
 #include "PPU.h"
+#include "Instruction_trace.h"
+#include "Alloc_tracker.h"
+#include "Debugger.h"
+#include "Disassembler.h"
+#include "Memory_view.h"
+#include "Joypad.h"
+#ifdef SHARPBOY_PROFILER
+#include "Profiler.h"
+#endif
+#ifdef SHARPBOY_HEATMAP
+#include "Heatmap.h"
+#endif
 
 #include "emu_visuals/Graphics.h"
 
+//1 in n calls to tick_other_components is timed per component, must be a power of 2
+const int PERF_SAMPLE_INTERVAL = 64;
+
+//whole machine state for rewinding, components are copied as they are apart from the cpu block cache
+//the components are created on the first save and copy assigned from then on, so saving and loading never construct or destroy one
+struct emulator_snapshot {
+	cpu_snapshot cpu = cpu_snapshot();
+	joypad_snapshot joypad = joypad_snapshot();
+	std::unique_ptr<MMU> mmu = nullptr;
+	std::unique_ptr<Timers> timers = nullptr;
+	std::unique_ptr<PPU> ppu = nullptr;
+};
+
 class Emulator {
 public:
 	//constructors
@@ -29,29 +54,120 @@ public:
 
 	//execution
 	int run_next_instruction();
+	void set_cpu_engine(const cpu_engines& engine);
+	cpu_engines get_cpu_engine();
+
+#ifdef SHARPBOY_PROFILER
+	//guest profiler hooks, compiled out unless SHARPBOY_PROFILER is defined
+	void profile_step(const ushort& pc, const int& cycles);
+	void profile_call(const ushort& address);
+	void profile_return();
+	Profiler* get_profiler();
+#endif
+
+#ifdef SHARPBOY_HEATMAP
+	//memory heatmap hooks, compiled out unless SHARPBOY_HEATMAP is defined
+	void heatmap_read(const ushort& address);
+	void heatmap_write(const ushort& address);
+	void heatmap_execute(const ushort& address, const byte& opcode);
+	Heatmap* get_heatmap();
+#endif
+
+	//binary instruction trace (see Instruction_trace.h), convert with Instruction_trace::convert_to_doctor_log
+	bool start_instruction_trace(const std::string& file_name);
+	void stop_instruction_trace();
+	bool is_instruction_trace_running();
+
+	//breakpoints/watchpoints (see Debugger.h), arming or clearing them updates the cpu hooks and page flags
+	void add_breakpoint(const ushort& address, const int& bank);
+	void remove_breakpoint(const int& index);
+	void add_watchpoint(const ushort& address, const watch_access& access, const watch_conditions& condition, const byte& value);
+	void remove_watchpoint(const int& index);
+	const Debugger* get_debugger() const;
+	bool check_breakpoint(const ushort& pc);
+	void check_watchpoint(const ushort& address, const byte& value, const watch_access& access);
+	bool is_debug_break_pending();
+	void resume_from_debug_break();
+
+	//cached disassembly for the debugger windows (see Disassembler.h)
+	const std::vector<disassembly_line>& get_disassembly(const ushort& address, const int& lines_before, const int& lines_after);
+	void invalidate_disassembly_page(const byte& page);
+
+	//memory viewer (see Memory_view.h), edits skip watchpoints and io side effects aside from the write itself
+	const Memory_view& refresh_memory_view();
+	void copy_address_space(std::array<byte, 0x10000>& bus);
+	void edit_memory(const ushort& address, const byte& value);
+
+	//snapshots + state hashing (see tools/Divergence_finder.cpp)
+	void save_snapshot(emulator_snapshot& snapshot);
+	void load_snapshot(const emulator_snapshot& snapshot);
+	uint64_t get_state_hash();
+	uint64_t get_elapsed_cycles();
 
 	//ticks for other components
 	void tick_other_components(const int& cycles);
 
+	//performance counters, host times are added by whoever drives the emulator (app/headless)
+	void add_host_time(const perf_components& component, const uint64_t& nanoseconds);
+	void complete_perf_frame();
+	const perf_stats& get_perf_stats() const;
+#ifdef SHARPBOY_ALLOC_TRACKING
+	//drops whatever the calling thread allocated since the last frame ended from the next frame's count
+	void reset_perf_alloc_baseline();
+#endif
+
 	//interrupts
 	void trigger_interrupt(const interrupt_types& interrupt);
 	void clear_interrupt(const int& interrupt);
 
 	//memory/io read write
 	byte bus_read(const ushort& address);
+	byte bus_fetch(const ushort& address);
+	void count_bus_fetch();
+	byte memory_instant_read(const ushort& address);
 	void bus_write(const ushort& address, const byte& value);
 	byte io_instant_read(const byte& io_target);
 	void io_instant_write(const byte& io_target, const byte& value);
 
+	//memory page flags + cached code
+	int get_memory_bank(const ushort& address);
+	void set_memory_page_flag(const byte& page, const memory_page_flags& flag);
+	void clear_memory_page_flag(const byte& page, const memory_page_flags& flag);
+	void invalidate_code_page(const byte& page);
+
 	//ppu functions
 	ppu_modes get_current_ppu_mode();
-	std::array<uint32_t, 160 * 144> get_frame_buffer();
+	const std::array<byte, 160 * 144>& get_shade_buffer();
+	std::array<uint32_t, 160 * 144> get_frame_buffer(const colour_schemes& scheme = scheme_GREY);
+	bool take_dirty_lines(int& first_line, int& last_line);
+
+	//joypad, the host sets held buttons (joypad_buttons) and is polled through poller before the first JOYP read each frame
+	void set_joypad_buttons(const byte& buttons);
+	void set_input_poller(input_poller poller, void* context);
+	void sync_joypad();
+	byte read_joypad(const byte& select);
+	byte peek_joypad(const byte& select);
+	void write_joypad(const byte& old_select, const byte& new_select);
+	byte take_joypad_read_buttons();
 	bool draw_ready();
 	void reset_draw_ready();
 
+	//decoded tile cache + debug view dirty tracking, vram/oam writes mark what the fetcher and viewers redo
+	void vram_written(const ushort& address);
+	void oam_written();
+	bool take_viewer_dirty_tiles(std::array<bool, TILE_CACHE_TILES>& dirty_tiles);
+	void fill_tile_pixels(const int& index, uint32_t* pixels, const int& pitch);
+	byte take_ppu_view_changes(const ppu_viewers& viewer);
+	void fill_map_pixels(const int& map, uint32_t* pixels);
+	void fill_sprite_pixels(const byte& tile, const byte& attributes, uint32_t* pixels, const int& pitch);
+	const std::array<byte, OAM_SIZE>& get_oam();
+
 	//get debug information
 	cpu_data get_cpu_data();
-	std::array<uint32_t, 64> get_next_tile(const int& index);
+
+	//rom loading, static so tools can read roms without an emulator instance
+	static bool load_rom_file(const std::string& file_name, std::vector<byte>& rom_file);
+	static void parse_rom_file_header(rom_header& header, const std::vector<byte>& rom);
  
 private:
 	std::shared_ptr<Emulator> current_emulator_instance = nullptr;
@@ -61,16 +177,44 @@ private:
 	std::unique_ptr<MMU> MMU_ptr = nullptr;
 	std::unique_ptr<Timers> TIMER_ptr = nullptr;
 	std::unique_ptr<PPU> PPU_ptr = nullptr;
+#ifdef SHARPBOY_PROFILER
+	std::unique_ptr<Profiler> PROFILER_ptr = nullptr;
+#endif
+#ifdef SHARPBOY_HEATMAP
+	std::unique_ptr<Heatmap> HEATMAP_ptr = nullptr;
+#endif
+	std::unique_ptr<Instruction_trace> TRACE_ptr = nullptr;
+	std::unique_ptr<Debugger> DEBUGGER_ptr = nullptr;
+	std::unique_ptr<Disassembler> DISASSEMBLER_ptr = nullptr;
+	std::unique_ptr<Memory_view> MEMORY_VIEW_ptr = nullptr;
+	std::unique_ptr<Joypad> JOYPAD_ptr = nullptr;
+
+	//guest data reads, swapped for MMU::watched_read_from_memory while a read watchpoint is set
+	byte (MMU::*mmu_read)(const ushort& address) = &MMU::read_from_memory;
 	//apu
 
+	//performance counters
+	perf_frame current_perf_frame = perf_frame();
+	perf_stats stats = perf_stats();
+	uint32_t perf_tick_calls = 0;
+	int64_t perf_clock_overhead_ns = 0;
+	uint64_t perf_window_cycles = 0;
+	uint64_t perf_window_frames = 0;
+	std::chrono::steady_clock::time_point perf_window_start = std::chrono::steady_clock::now();
+	bool perf_window_filled = false;
+#ifdef SHARPBOY_ALLOC_TRACKING
+	alloc_counts perf_frame_alloc_start = alloc_counts();
+#endif
+
 	//control bools
 	bool initialised = false;
 	bool single_step_test_mode = false;
 	bool using_boot_rom = false;
 
 private:
-	bool load_rom_file(const std::string& file_name, std::vector<byte>& rom_file);
-	void parse_rom_file_header(rom_header& header, const std::vector<byte>& rom);
+	void tick_other_components_timed(const int& cycles);
+	uint64_t get_sampled_ns(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end);
+	void refresh_debug_hooks();
 
 	bool load_boot_rom_file(const std::string& file_name, std::array<byte, 0x100>& boot_rom);
 };
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "Frame_filter.h"
+#include "Shades.h"
+#include <cstring>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+//rows are 160 pixels, a multiple of 4, so the sse2 loops cover them whole and the scalar loops are the fallback
+#define SHARPBOY_SSE2_FILTER
+#endif
+
+//bytewise average rounding up, the same as _mm_avg_epu8 so both paths give identical pixels
+static inline uint32_t average_pixels(const uint32_t& a, const uint32_t& b) {
+	return (a | b) - (((a ^ b) >> 1) & 0x7f7f7f7f);
+}
+
+static inline uint32_t* output_row(uint32_t* pixels, const int& pitch, const int& row) {
+	return (uint32_t*)((byte*)pixels + (size_t)row * pitch);
+}
+
+#ifdef SHARPBOY_SSE2_FILTER
+static inline __m128i load_pixels(const uint32_t* pixels) {
+	return _mm_loadu_si128((const __m128i*)pixels);
+}
+
+static inline void store_pixels(uint32_t* pixels, const __m128i& value) {
+	_mm_storeu_si128((__m128i*)pixels, value);
+}
+
+static inline __m128i select_pixels(const __m128i& mask, const __m128i& if_set, const __m128i& if_clear) {
+	return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear));
+}
+
+//a0 b0 c0 a1 | b1 c1 a2 b2 | c2 a3 b3 c3
+static inline void store_interleaved_3(uint32_t* pixels, const __m128i& a, const __m128i& b, const __m128i& c) {
+	__m128 ab_low = _mm_castsi128_ps(_mm_unpacklo_epi32(a, b));
+	__m128 ab_high = _mm_castsi128_ps(_mm_unpackhi_epi32(a, b));
+	__m128 ca_low = _mm_castsi128_ps(_mm_unpacklo_epi32(c, a));
+	__m128 ca_high = _mm_castsi128_ps(_mm_unpackhi_epi32(c, a));
+	__m128 bc_low = _mm_castsi128_ps(_mm_unpacklo_epi32(b, c));
+	__m128 bc_high = _mm_castsi128_ps(_mm_unpackhi_epi32(b, c));
+
+	store_pixels(pixels, _mm_castps_si128(_mm_shuffle_ps(ab_low, ca_low, _MM_SHUFFLE(3, 0, 1, 0))));
+	store_pixels(pixels + 4, _mm_castps_si128(_mm_shuffle_ps(bc_low, ab_high, _MM_SHUFFLE(1, 0, 3, 2))));
+	store_pixels(pixels + 8, _mm_castps_si128(_mm_shuffle_ps(ca_high, bc_high, _MM_SHUFFLE(3, 2, 3, 0))));
+}
+#endif
+
+//scale2x (AdvMAME2x), blend swaps the copied edge pixel for its average with the centre to soften the stair steps
+static void scale2x_row(const uint32_t* up, const uint32_t* row, const uint32_t* down, uint32_t* out_top, uint32_t* out_bottom, const bool& blend) {
+	int x = 0;
+
+#ifdef SHARPBOY_SSE2_FILTER
+	for (; x + 4 <= 160; x += 4) {
+		__m128i b = load_pixels(up + x);
+		__m128i d = load_pixels(row + x - 1);
+		__m128i e = load_pixels(row + x);
+		__m128i f = load_pixels(row + x + 1);
+		__m128i h = load_pixels(down + x);
+
+		__m128i db = _mm_cmpeq_epi32(d, b);
+		__m128i bf = _mm_cmpeq_epi32(b, f);
+		__m128i dh = _mm_cmpeq_epi32(d, h);
+		__m128i hf = _mm_cmpeq_epi32(h, f);
+
+		__m128i top_left = _mm_andnot_si128(bf, _mm_andnot_si128(dh, db));
+		__m128i top_right = _mm_andnot_si128(db, _mm_andnot_si128(hf, bf));
+		__m128i bottom_left = _mm_andnot_si128(db, _mm_andnot_si128(hf, dh));
+		__m128i bottom_right = _mm_andnot_si128(dh, _mm_andnot_si128(bf, hf));
+
+		__m128i left = blend ? _mm_avg_epu8(d, e) : d;
+		__m128i right = blend ? _mm_avg_epu8(f, e) : f;
+		__m128i e0 = select_pixels(top_left, left, e);
+		__m128i e1 = select_pixels(top_right, right, e);
+		__m128i e2 = select_pixels(bottom_left, left, e);
+		__m128i e3 = select_pixels(bottom_right, right, e);
+
+		store_pixels(out_top + x * 2, _mm_unpacklo_epi32(e0, e1));
+		store_pixels(out_top + x * 2 + 4, _mm_unpackhi_epi32(e0, e1));
+		store_pixels(out_bottom + x * 2, _mm_unpacklo_epi32(e2, e3));
+		store_pixels(out_bottom + x * 2 + 4, _mm_unpackhi_epi32(e2, e3));
+	}
+#else
+	for (; x < 160; x++) {
+		uint32_t b = up[x], d = row[x - 1], e = row[x], f = row[x + 1], h = down[x];
+		uint32_t left = blend ? average_pixels(d, e) : d;
+		uint32_t right = blend ? average_pixels(f, e) : f;
+
+		out_top[x * 2] = (d == b && b != f && d != h) ? left : e;
+		out_top[x * 2 + 1] = (b == f && b != d && f != h) ? right : e;
+		out_bottom[x * 2] = (d == h && d != b && h != f) ? left : e;
+		out_bottom[x * 2 + 1] = (h == f && d != h && b != f) ? right : e;
+	}
+#endif
+}
+
+//scale3x (AdvMAME3x)
+static void scale3x_row(const uint32_t* up, const uint32_t* row, const uint32_t* down, uint32_t* out_top, uint32_t* out_middle, uint32_t* out_bottom) {
+	int x = 0;
+
+#ifdef SHARPBOY_SSE2_FILTER
+	for (; x + 4 <= 160; x += 4) {
+		__m128i a = load_pixels(up + x - 1);
+		__m128i b = load_pixels(up + x);
+		__m128i c = load_pixels(up + x + 1);
+		__m128i d = load_pixels(row + x - 1);
+		__m128i e = load_pixels(row + x);
+		__m128i f = load_pixels(row + x + 1);
+		__m128i g = load_pixels(down + x - 1);
+		__m128i h = load_pixels(down + x);
+		__m128i i = load_pixels(down + x + 1);
+
+		__m128i db = _mm_cmpeq_epi32(d, b);
+		__m128i bf = _mm_cmpeq_epi32(b, f);
+		__m128i dh = _mm_cmpeq_epi32(d, h);
+		__m128i hf = _mm_cmpeq_epi32(h, f);
+		__m128i ea = _mm_cmpeq_epi32(e, a);
+		__m128i ec = _mm_cmpeq_epi32(e, c);
+		__m128i eg = _mm_cmpeq_epi32(e, g);
+		__m128i ei = _mm_cmpeq_epi32(e, i);
+
+		__m128i top_left = _mm_andnot_si128(bf, _mm_andnot_si128(dh, db));
+		__m128i top_right = _mm_andnot_si128(db, _mm_andnot_si128(hf, bf));
+		__m128i bottom_left = _mm_andnot_si128(db, _mm_andnot_si128(hf, dh));
+		__m128i bottom_right = _mm_andnot_si128(dh, _mm_andnot_si128(bf, hf));
+
+		__m128i e0 = select_pixels(top_left, d, e);
+		__m128i e1 = select_pixels(_mm_or_si128(_mm_andnot_si128(ec, top_left), _mm_andnot_si128(ea, top_right)), b, e);
+		__m128i e2 = select_pixels(top_right, f, e);
+		__m128i e3 = select_pixels(_mm_or_si128(_mm_andnot_si128(eg, top_left), _mm_andnot_si128(ea, bottom_left)), d, e);
+		__m128i e5 = select_pixels(_mm_or_si128(_mm_andnot_si128(ei, top_right), _mm_andnot_si128(ec, bottom_right)), f, e);
+		__m128i e6 = select_pixels(bottom_left, d, e);
+		__m128i e7 = select_pixels(_mm_or_si128(_mm_andnot_si128(ei, bottom_left), _mm_andnot_si128(eg, bottom_right)), h, e);
+		__m128i e8 = select_pixels(bottom_right, f, e);
+
+		store_interleaved_3(out_top + x * 3, e0, e1, e2);
+		store_interleaved_3(out_middle + x * 3, e3, e, e5);
+		store_interleaved_3(out_bottom + x * 3, e6, e7, e8);
+	}
+#else
+	for (; x < 160; x++) {
+		uint32_t a = up[x - 1], b = up[x], c = up[x + 1];
+		uint32_t d = row[x - 1], e = row[x], f = row[x + 1];
+		uint32_t g = down[x - 1], h = down[x], i = down[x + 1];
+
+		bool top_left = d == b && b != f && d != h;
+		bool top_right = b == f && b != d && f != h;
+		bool bottom_left = d == h && d != b && h != f;
+		bool bottom_right = h == f && d != h && b != f;
+
+		out_top[x * 3] = top_left ? d : e;
+		out_top[x * 3 + 1] = ((top_left && e != c) || (top_right && e != a)) ? b : e;
+		out_top[x * 3 + 2] = top_right ? f : e;
+		out_middle[x * 3] = ((top_left && e != g) || (bottom_left && e != a)) ? d : e;
+		out_middle[x * 3 + 1] = e;
+		out_middle[x * 3 + 2] = ((top_right && e != i) || (bottom_right && e != c)) ? f : e;
+		out_bottom[x * 3] = bottom_left ? d : e;
+		out_bottom[x * 3 + 1] = ((bottom_left && e != i) || (bottom_right && e != g)) ? h : e;
+		out_bottom[x * 3 + 2] = bottom_right ? f : e;
+	}
+#endif
+}
+
+//each pixel becomes 3x3 of itself with a 1 pixel gap line at 3/4 brightness on its right and bottom
+static void lcd_grid_row(const uint32_t* row, uint32_t* const out[4], const uint32_t& alpha_mask) {
+	int x = 0;
+
+#ifdef SHARPBOY_SSE2_FILTER
+	const __m128i alpha = _mm_set1_epi32((int)alpha_mask);
+	const __m128i first_three = _mm_set_epi32(0, -1, -1, -1);
+
+	for (; x + 4 <= 160; x += 4) {
+		__m128i p = load_pixels(row + x);
+		__m128i grid = _mm_avg_epu8(p, _mm_avg_epu8(p, _mm_and_si128(p, alpha)));
+
+		__m128i cells[4] = {
+			select_pixels(first_three, _mm_shuffle_epi32(p, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_epi32(grid, _MM_SHUFFLE(0, 0, 0, 0))),
+			select_pixels(first_three, _mm_shuffle_epi32(p, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_epi32(grid, _MM_SHUFFLE(1, 1, 1, 1))),
+			select_pixels(first_three, _mm_shuffle_epi32(p, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_epi32(grid, _MM_SHUFFLE(2, 2, 2, 2))),
+			select_pixels(first_three, _mm_shuffle_epi32(p, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_epi32(grid, _MM_SHUFFLE(3, 3, 3, 3))),
+		};
+		__m128i gaps[4] = {
+			_mm_shuffle_epi32(grid, _MM_SHUFFLE(0, 0, 0, 0)),
+			_mm_shuffle_epi32(grid, _MM_SHUFFLE(1, 1, 1, 1)),
+			_mm_shuffle_epi32(grid, _MM_SHUFFLE(2, 2, 2, 2)),
+			_mm_shuffle_epi32(grid, _MM_SHUFFLE(3, 3, 3, 3)),
+		};
+
+		for (int cell = 0; cell < 4; cell++) {
+			int out_x = (x + cell) * 4;
+			store_pixels(out[0] + out_x, cells[cell]);
+			store_pixels(out[1] + out_x, cells[cell]);
+			store_pixels(out[2] + out_x, cells[cell]);
+			store_pixels(out[3] + out_x, gaps[cell]);
+		}
+	}
+#else
+	for (; x < 160; x++) {
+		uint32_t p = row[x];
+		uint32_t grid = average_pixels(p, average_pixels(p, p & alpha_mask));
+
+		for (int line = 0; line < 3; line++) {
+			out[line][x * 4] = p;
+			out[line][x * 4 + 1] = p;
+			out[line][x * 4 + 2] = p;
+			out[line][x * 4 + 3] = grid;
+		}
+		for (int column = 0; column < 4; column++) {
+			out[3][x * 4 + column] = grid;
+		}
+	}
+#endif
+}
+
+//halfway to the last output, so changes smear over a few frames like the dmg's slow lcd
+static void ghosting_row(const uint32_t* row, uint32_t* history, uint32_t* out) {
+	int x = 0;
+
+#ifdef SHARPBOY_SSE2_FILTER
+	for (; x + 4 <= 160; x += 4) {
+		__m128i blended = _mm_avg_epu8(load_pixels(row + x), load_pixels(history + x));
+		store_pixels(history + x, blended);
+		store_pixels(out + x, blended);
+	}
+#else
+	for (; x < 160; x++) {
+		history[x] = average_pixels(row[x], history[x]);
+		out[x] = history[x];
+	}
+#endif
+}
+
+Frame_filter::Frame_filter() {
+	pool = std::make_unique<Worker_pool>();
+}
+
+Frame_filter::~Frame_filter() {
+	pool.reset();
+
+	printf("[SB] Shutting down FRAME_FILTER object\n");
+}
+
+void Frame_filter::apply(const frame_filters& filter, const byte* shades, const std::array<uint32_t, 4>& colours, const uint32_t& alpha_mask, uint32_t* pixels, const int& pitch) {
+	for (int y = 0; y < 144; y++) {
+		uint32_t* row = &source[(y + 1) * SOURCE_STRIDE + 1];
+		expand_shades(shades + y * 160, row, 160, colours);
+		row[-1] = row[0];
+		row[160] = row[159];
+	}
+	std::memcpy(&source[0], &source[SOURCE_STRIDE], SOURCE_STRIDE * sizeof(uint32_t));
+	std::memcpy(&source[145 * SOURCE_STRIDE], &source[144 * SOURCE_STRIDE], SOURCE_STRIDE * sizeof(uint32_t));
+
+	//first frame after a reset has nothing to smear from
+	if (filter == filter_GHOSTING && !history_valid) {
+		for (int y = 0; y < 144; y++) {
+			std::memcpy(&history[y * 160], &source[(y + 1) * SOURCE_STRIDE + 1], 160 * sizeof(uint32_t));
+		}
+		history_valid = true;
+	}
+
+	this->filter = filter;
+	this->pixels = pixels;
+	this->pitch = pitch;
+	this->alpha_mask = alpha_mask;
+	pool->run(144, &Frame_filter::filter_band, this);
+}
+
+void Frame_filter::reset_history() {
+	history_valid = false;
+}
+
+//privates
+void Frame_filter::filter_band(void* context, const int& first_row, const int& last_row) {
+	Frame_filter* frame_filter = (Frame_filter*)context;
+	const int scale = frame_filter_table[frame_filter->filter].scale;
+
+	for (int y = first_row; y <= last_row; y++) {
+		const uint32_t* up = &frame_filter->source[y * SOURCE_STRIDE + 1];
+		const uint32_t* row = up + SOURCE_STRIDE;
+		const uint32_t* down = row + SOURCE_STRIDE;
+
+		uint32_t* out[4] = {};
+		for (int line = 0; line < scale; line++) {
+			out[line] = output_row(frame_filter->pixels, frame_filter->pitch, y * scale + line);
+		}
+
+		switch (frame_filter->filter) {
+		case filter_SCALE2X: scale2x_row(up, row, down, out[0], out[1], false); break;
+		case filter_SCALE2X_SMOOTH: scale2x_row(up, row, down, out[0], out[1], true); break;
+		case filter_SCALE3X: scale3x_row(up, row, down, out[0], out[1], out[2]); break;
+		case filter_LCD_GRID: lcd_grid_row(row, out, frame_filter->alpha_mask); break;
+		case filter_GHOSTING: ghosting_row(row, &frame_filter->history[y * 160], out[0]); break;
+		default: std::memcpy(out[0], row, 160 * sizeof(uint32_t)); break;
+		}
+	}
+}
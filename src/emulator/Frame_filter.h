@@ -0,0 +1,56 @@
+#pragma once
+
+#include "_definitions.h"
+#include "Worker_pool.h"
+#include <array>
+#include <memory>
+
+//post processing from the ppu's shades to the screen texture, for when the final blit is sdl's software renderer
+//the shades are expanded into a bordered 32 bit source image, then the filter runs over it in row bands on a Worker_pool
+//pixels are any 32 bit frame format, channels are only ever compared or averaged bytewise so their order does not matter
+
+struct frame_filter_info {
+	const char* name;
+	int scale;
+};
+
+inline constexpr std::array<frame_filter_info, filter_COUNT> frame_filter_table = { {
+	{ "None", 1 },
+	{ "Scale2x", 2 },
+	{ "Scale3x", 3 },
+	{ "Scale2x Smooth", 2 },
+	{ "LCD Grid 4x", 4 },
+	{ "Ghosting", 1 },
+} };
+
+class Frame_filter {
+public:
+	Frame_filter();
+	~Frame_filter();
+
+	//writes 160*scale x 144*scale pixels, alpha_mask has the format's alpha byte set so the lcd grid leaves it alone
+	void apply(const frame_filters& filter, const byte* shades, const std::array<uint32_t, 4>& colours, const uint32_t& alpha_mask, uint32_t* pixels, const int& pitch);
+
+	//ghosting blends with the last output, a new texture or scheme should not fade in from the old one
+	void reset_history();
+
+private:
+	static void filter_band(void* context, const int& first_row, const int& last_row);
+
+public:
+	static const int SOURCE_STRIDE = 160 + 2;
+
+private:
+	std::unique_ptr<Worker_pool> pool = nullptr;
+
+	//1 pixel border repeating the edge so the kernels never bounds check
+	std::array<uint32_t, SOURCE_STRIDE * (144 + 2)> source = std::array<uint32_t, SOURCE_STRIDE * (144 + 2)>();
+	std::array<uint32_t, 160 * 144> history = std::array<uint32_t, 160 * 144>();
+	bool history_valid = false;
+
+	//the job the bands are running
+	frame_filters filter = filter_NONE;
+	uint32_t* pixels = nullptr;
+	int pitch = 0;
+	uint32_t alpha_mask = 0;
+};
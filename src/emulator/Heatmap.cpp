@@ -0,0 +1,157 @@
+#include "Heatmap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+Heatmap::Heatmap(const rom_header& header) {
+	//header rom size n means 32KiB << n, so 2 << n banks of 16KiB
+	if (header.cart_rom_size != rom_NONE) {
+		rom_bank_count = 2 << header.cart_rom_size;
+	}
+
+	switch (header.cart_ram_size) {
+	case ram_KiB_32: ram_bank_count = 4; break;
+	case ram_KiB_64: ram_bank_count = 8; break;
+	case ram_KiB_128: ram_bank_count = 16; break;
+	default: ram_bank_count = 1; break;
+	}
+
+	reset();
+}
+
+Heatmap::~Heatmap() {
+	printf("[SB] Shutting down HEATMAP object\n");
+}
+
+void Heatmap::reset() {
+	reads.assign(0x10000, 0);
+	writes.assign(0x10000, 0);
+	executes.assign(0x10000, 0);
+
+	rom_reads.assign((size_t)rom_bank_count * 0x4000, 0);
+	rom_executes.assign((size_t)rom_bank_count * 0x4000, 0);
+	ram_reads.assign((size_t)ram_bank_count * 0x2000, 0);
+	ram_writes.assign((size_t)ram_bank_count * 0x2000, 0);
+}
+
+void Heatmap::add_read(const ushort& address, const int& bank) {
+	reads[address]++;
+
+	if (address < 0x8000) {
+		rom_reads[get_rom_index(address, bank)]++;
+	}
+	else if (address >= 0xa000 && address < 0xc000) {
+		ram_reads[get_ram_index(address, bank)]++;
+	}
+}
+
+void Heatmap::add_write(const ushort& address, const int& bank) {
+	writes[address]++;
+
+	if (address >= 0xa000 && address < 0xc000) {
+		ram_writes[get_ram_index(address, bank)]++;
+	}
+}
+
+//every byte of the instruction is marked so operands show up as code in the coverage
+void Heatmap::add_execute(const ushort& address, const int& bank, const byte& length) {
+	for (int i = 0; i < length; i++) {
+		ushort byte_address = (ushort)(address + i);
+		executes[byte_address]++;
+
+		if (byte_address < 0x8000) {
+			rom_executes[get_rom_index(byte_address, bank)]++;
+		}
+	}
+}
+
+uint32_t Heatmap::get_count(const ushort& address, const heatmap_views& view) {
+	switch (view) {
+	case heatmap_READS: return reads[address];
+	case heatmap_WRITES: return writes[address];
+	case heatmap_EXECUTES: return executes[address];
+	default: return reads[address] + writes[address] + executes[address];
+	}
+}
+
+void Heatmap::fill_pixels(std::array<uint32_t, 0x10000>& pixels, const heatmap_views& view) {
+	//log scale against the hottest address so rarely touched memory is still visible
+	uint32_t hottest = 1;
+	for (int address = 0; address < 0x10000; address++) {
+		hottest = std::max(hottest, get_count((ushort)address, view));
+	}
+	float scale = 255.0f / std::log2(hottest + 1.0f);
+
+	auto intensity = [scale](const uint32_t& count) -> uint32_t {
+		return count == 0 ? 0 : std::max<uint32_t>(48, (uint32_t)(std::log2(count + 1.0f) * scale));
+	};
+
+	for (int address = 0; address < 0x10000; address++) {
+		uint32_t r = 0;
+		uint32_t g = 0;
+		uint32_t b = 0;
+
+		//rgba8888, writes red, reads green, executes blue
+		switch (view) {
+		case heatmap_READS: g = intensity(reads[address]); break;
+		case heatmap_WRITES: r = intensity(writes[address]); break;
+		case heatmap_EXECUTES: b = intensity(executes[address]); break;
+		default:
+			r = intensity(writes[address]);
+			g = intensity(reads[address]);
+			b = intensity(executes[address]);
+			break;
+		}
+
+		pixels[address] = (r << 24) | (g << 16) | (b << 8) | 0xff;
+	}
+}
+
+coverage_summary Heatmap::get_coverage_summary() {
+	coverage_summary summary = coverage_summary();
+	summary.rom_size = rom_reads.size();
+
+	for (size_t i = 0; i < rom_reads.size(); i++) {
+		if (rom_executes[i] != 0) {
+			summary.executed_bytes++;
+		}
+		else if (rom_reads[i] != 0) {
+			summary.data_bytes++;
+		}
+	}
+
+	return summary;
+}
+
+bool Heatmap::export_coverage(const std::string& file_name) {
+	FILE* output = fopen(file_name.c_str(), "wb");
+	if (output == nullptr) {
+		printf("[SB] Failed to open %s for writing\n", file_name.c_str());
+		return false;
+	}
+
+	std::vector<byte> coverage = std::vector<byte>(rom_reads.size());
+	for (size_t i = 0; i < coverage.size(); i++) {
+		coverage[i] = (rom_executes[i] != 0 ? coverage_EXECUTED : coverage_NONE) | (rom_reads[i] != 0 ? coverage_DATA : coverage_NONE);
+	}
+
+	fwrite(coverage.data(), 1, coverage.size(), output);
+	fclose(output);
+
+	coverage_summary summary = get_coverage_summary();
+	printf("[SB] Wrote coverage to %s, %zu code bytes and %zu data bytes of %zu\n", file_name.c_str(), summary.executed_bytes, summary.data_bytes, summary.rom_size);
+	return true;
+}
+
+//privates
+int Heatmap::get_rom_index(const ushort& address, const int& bank) {
+	if (address < 0x4000) {
+		return address;
+	}
+
+	return std::clamp(bank, 1, rom_bank_count - 1) * 0x4000 + (address - 0x4000);
+}
+
+int Heatmap::get_ram_index(const ushort& address, const int& bank) {
+	return std::clamp(bank, 0, ram_bank_count - 1) * 0x2000 + (address - 0xa000);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "_definitions.h"
+#include <array>
+#include <vector>
+#include <string>
+
+//memory access heatmap + rom coverage, only built with -DSHARPBOY_HEATMAP=ON (see CMakeLists.txt)
+//counts reads/writes made through MMU::read_from_memory/write_to_memory and instructions executed by the cpu
+
+enum heatmap_views {
+	heatmap_ALL = 0,
+	heatmap_READS = 1,
+	heatmap_WRITES = 2,
+	heatmap_EXECUTES = 3,
+};
+
+//coverage file, one byte per rom byte
+enum coverage_flags {
+	coverage_NONE = 0x00,
+	coverage_EXECUTED = 0x01,
+	coverage_DATA = 0x02,
+};
+
+struct coverage_summary {
+	size_t rom_size = 0;
+	size_t executed_bytes = 0;
+	size_t data_bytes = 0;
+};
+
+class Heatmap {
+public:
+	Heatmap(const rom_header& header);
+	~Heatmap();
+
+	void reset();
+
+	//called through the emulator by the mmu/cpu, bank is the bank mapped at address
+	void add_read(const ushort& address, const int& bank);
+	void add_write(const ushort& address, const int& bank);
+	void add_execute(const ushort& address, const int& bank, const byte& length);
+
+	//one pixel per address, 256 addresses per row, counts are log scaled
+	void fill_pixels(std::array<uint32_t, 0x10000>& pixels, const heatmap_views& view);
+	uint32_t get_count(const ushort& address, const heatmap_views& view);
+
+	coverage_summary get_coverage_summary();
+	bool export_coverage(const std::string& file_name);
+
+private:
+	int rom_bank_count = 2;
+	int ram_bank_count = 1;
+
+	//flat 64K map as the cpu sees it
+	std::vector<uint32_t> reads = std::vector<uint32_t>();
+	std::vector<uint32_t> writes = std::vector<uint32_t>();
+	std::vector<uint32_t> executes = std::vector<uint32_t>();
+
+	//rom banks packed one after another, external ram the same
+	std::vector<uint32_t> rom_reads = std::vector<uint32_t>();
+	std::vector<uint32_t> rom_executes = std::vector<uint32_t>();
+	std::vector<uint32_t> ram_reads = std::vector<uint32_t>();
+	std::vector<uint32_t> ram_writes = std::vector<uint32_t>();
+
+private:
+	int get_rom_index(const ushort& address, const int& bank);
+	int get_ram_index(const ushort& address, const int& bank);
+};
@@ -1,4 +1,5 @@
 #include "CPU.h"
+#include "Emulator.h"
 
 //8 bit load instructions
 
@@ -15,41 +16,35 @@ int CPU::LD_R8_N8(byte& register_one) {
 	return cycles_EIGHT;
 }
 
-int CPU::LD_R8_HL(byte& register_one, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::LD_R8_HL(byte& register_one, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	register_one = value;
 	return cycles_EIGHT;
 }
 
-int CPU::LD_HL_R8(const byte& h, const byte& l, const byte& register_value) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::LD_HL_R8(const ushort& hl, const byte& register_value) {
 	write_to_bus(hl, register_value);
 
 	return cycles_EIGHT;
 }
 
-int CPU::LD_HL_N8(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::LD_HL_N8(const ushort& hl) {
 	byte value = fetch_next_byte();
 
 	write_to_bus(hl, value);
 	return cycles_TWELVE;
 }
 
-int CPU::LD_A_R16(byte& a, const byte& register_high, const byte& register_low) {
-	ushort address = (ushort)(register_high << 8 | register_low);
-	byte value = read_from_bus(address);
+int CPU::LD_A_R16(byte& a, const ushort& register_pair) {
+	byte value = read_from_bus(register_pair);
 
 	a = value;
 	return cycles_EIGHT;
 }
 
-int CPU::LD_R16_A(const byte& register_high, const byte& register_low, const byte& a) {
-	ushort address = (ushort)(register_high << 8 | register_low);
-
-	write_to_bus(address, a);
+int CPU::LD_R16_A(const ushort& register_pair, const byte& a) {
+	write_to_bus(register_pair, a);
 	return cycles_EIGHT;
 }
 
@@ -108,64 +103,45 @@ int CPU::LDH_N8_A(const byte& a) {
 	return cycles_TWELVE;
 }
 
-int CPU::LD_A_HLDEC(byte& a, byte& h, byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::LD_A_HLDEC(byte& a, ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	a = value;
 	hl--;
 
-	h = (byte)(hl >> 8);
-	l = (byte)(hl & 0xff);
-
 	return cycles_EIGHT;
 }
 
-int CPU::LD_HLDEC_A(byte& h, byte& l, const byte& a) {
-	ushort hl = (ushort)(h << 8 | l);
-	
+int CPU::LD_HLDEC_A(ushort& hl, const byte& a) {
 	write_to_bus(hl, a);
 	hl--;
 
-	h = (byte)(hl >> 8);
-	l = (byte)(hl & 0xff);
-
 	return cycles_EIGHT;
 }
 
-int CPU::LD_A_HLINC(byte& a, byte& h, byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::LD_A_HLINC(byte& a, ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	a = value;
 	hl++;
 
-	h = (byte)(hl >> 8);
-	l = (byte)(hl & 0xff);
-
 	return cycles_EIGHT;
 }
 
-int CPU::LD_HLINC_A(byte& h, byte& l, const byte& a) {
-	ushort hl = (ushort)(h << 8 | l);
-
+int CPU::LD_HLINC_A(ushort& hl, const byte& a) {
 	write_to_bus(hl, a);
 	hl++;
 
-	h = (byte)(hl >> 8);
-	l = (byte)(hl & 0xff);
-
 	return cycles_EIGHT;
 }
 
 //16 bit load instructions
 
-int CPU::LD_R16_N16(byte& register_high, byte& register_low) {
+int CPU::LD_R16_N16(ushort& register_pair) {
 	byte n16_low = fetch_next_byte();
 	byte n16_high = fetch_next_byte();
 
-	register_high = n16_high;
-	register_low = n16_low;
+	register_pair = (ushort)(n16_high << 8 | n16_low);
 
 	return cycles_TWELVE;
 }
@@ -193,106 +169,82 @@ int CPU::LD_SP_N16(ushort& sp) {
 	return cycles_TWELVE;
 }
 
-int CPU::LD_SP_HL(ushort& sp, const byte& h, const byte& l) {
-	ushort new_sp = (ushort)(h << 8 | l);
-	sp = new_sp;
+int CPU::LD_SP_HL(ushort& sp, const ushort& hl) {
+	sp = hl;
 	internal_cycle_other_components();
 
 	return cycles_EIGHT;
 }
 
-int CPU::PUSH_R16(ushort& sp, const byte& register_high, const byte& register_low) {
+int CPU::PUSH_R16(ushort& sp, const ushort& register_pair) {
 	internal_cycle_other_components();
 	sp--;
 
-	write_to_bus(sp, register_high);
+	write_to_bus(sp, (byte)(register_pair >> 8));
 	sp--;
 
-	write_to_bus(sp, register_low);
+	write_to_bus(sp, (byte)(register_pair & 0xff));
 
 	return cycles_SIXTEEN;
 }
 
-int CPU::POP_AF(ushort& sp, byte& a, byte& f) {
+int CPU::POP_AF(ushort& sp, ushort& af) {
 	byte new_f = read_from_bus(sp);
 	sp++;
 
 	byte new_a = read_from_bus(sp);
 	sp++;
 
-	a = new_a;
-	f = new_f & 0xf0;
+	af = (ushort)(new_a << 8 | (new_f & 0xf0));
+
+	//f was replaced wholesale, drop whatever alu result was still pending
+	lazy_op = lazy_NONE;
 	return cycles_TWELVE;
 }
 
-int CPU::POP_R16(ushort& sp, byte& register_high, byte& register_low) {
+int CPU::POP_R16(ushort& sp, ushort& register_pair) {
 	byte new_reg_low = read_from_bus(sp);
 	sp++;
 
 	byte new_reg_high = read_from_bus(sp);
 	sp++;
 
-	register_high = new_reg_high;
-	register_low = new_reg_low;
+	register_pair = (ushort)(new_reg_high << 8 | new_reg_low);
 	return cycles_TWELVE;
 }
 
-int CPU::LD_HL_SP_E8(byte& h, byte& l, const ushort& sp) {
+int CPU::LD_HL_SP_E8(ushort& hl, const ushort& sp) {
 	byte e8 = fetch_next_byte();
 
 	byte sp_low = (byte)(sp & 0xff);
-	int l_result = sp_low + e8;
-	l = (byte)l_result;
 
 	set_flag_state(flags_ZERO, false);
 	set_flag_state(flags_SUBTRACTION, false);
 	set_flag_state(flags_HALFCARRY, (sp_low & 0xf) + (e8 & 0xf) > 0xf);
 	set_flag_state(flags_CARRY, (sp_low + e8) > 0xff);
 
-	bool z_sign = (sbyte)e8 < 0;
-	byte adj = 0x00;
-	if (z_sign) {
-		adj = 0xff;
-	}
-
 	internal_cycle_other_components();
 
-	int h_result = (sp >> 8) + adj + get_flag_state(flags_CARRY);
-	h = h_result;
+	hl = (ushort)(sp + (sbyte)e8);
 	return cycles_TWELVE;
 }
 
 //8 bit arithmetic and logic instructions
 
 int CPU::ADD_R8(byte& a, const byte& register_value) {
-	int result = a + register_value;
-	bool new_half_carry = (a & 0xf) + (register_value & 0xf) > 0xf;
-	bool new_carry = (a + register_value) > 0xff;
+	set_lazy_flags(lazy_ADD, a, register_value, false);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a + register_value);
 
 	return cycles_FOUR;
 }
 
-int CPU::ADD_HL(byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::ADD_HL(byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
-	int result = a + value;
-	bool new_half_carry = (a & 0xf) + (value & 0xf) > 0xf;
-	bool new_carry = (a + value) > 0xff;
+	set_lazy_flags(lazy_ADD, a, value, false);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a + value);
 
 	return cycles_EIGHT;
 }
@@ -300,53 +252,29 @@ int CPU::ADD_HL(byte& a, const byte& h, const byte& l) {
 int CPU::ADD_N8(byte& a) {
 	byte n8 = fetch_next_byte();
 
-	int result = a + n8;
-	bool new_half_carry = (a & 0xf) + (n8 & 0xf) > 0xf;
-	bool new_carry = (a + n8) > 0xff;
+	set_lazy_flags(lazy_ADD, a, n8, false);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a + n8);
 
 	return cycles_EIGHT;
 }
 
 int CPU::ADC_R8(byte& a, const byte& register_value) {
 	bool c_flag = get_flag_state(flags_CARRY);
-	int result = a + register_value + c_flag;
-
-	bool new_half_carry = (a & 0xf) + (register_value & 0xf) + c_flag > 0xf;
-	bool new_carry = (a + register_value) + c_flag > 0xff;
+	set_lazy_flags(lazy_ADD, a, register_value, c_flag);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a + register_value + c_flag);
 
 	return cycles_FOUR;
 }
 
-int CPU::ADC_HL(byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::ADC_HL(byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	bool c_flag = get_flag_state(flags_CARRY);
-	int result = a + value + c_flag;
+	set_lazy_flags(lazy_ADD, a, value, c_flag);
 
-	bool new_half_carry = (a & 0xf) + (value & 0xf) + c_flag > 0xf;
-	bool new_carry = (a + value) + c_flag > 0xff;
-
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a + value + c_flag);
 
 	return cycles_EIGHT;
 }
@@ -355,50 +283,27 @@ int CPU::ADC_N8(byte& a) {
 	byte n8 = fetch_next_byte();
 
 	bool c_flag = get_flag_state(flags_CARRY);
-	int result = a + n8 + c_flag;
-
-	bool new_half_carry = (a & 0xf) + (n8 & 0xf) + c_flag > 0xf;
-	bool new_carry = (a + n8) + c_flag > 0xff;
+	set_lazy_flags(lazy_ADD, a, n8, c_flag);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a + n8 + c_flag);
 
 	return cycles_EIGHT;
 }
 
 int CPU::SUB_R8(byte& a, const byte& register_value) {
-	int result = a - register_value;
-	bool new_half_carry = (a & 0xf) < (register_value & 0xf);
-	bool new_carry = a < register_value;
+	set_lazy_flags(lazy_SUB, a, register_value, false);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a - register_value);
 
 	return cycles_FOUR;
 }
 
-int CPU::SUB_HL(byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::SUB_HL(byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
-	int result = a - value;
-	bool new_half_carry = (a & 0xf) < (value & 0xf);
-	bool new_carry = a < value;
+	set_lazy_flags(lazy_SUB, a, value, false);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a - value);
 
 	return cycles_EIGHT;
 }
@@ -406,53 +311,29 @@ int CPU::SUB_HL(byte& a, const byte& h, const byte& l) {
 int CPU::SUB_N8(byte& a) {
 	byte n8 = fetch_next_byte();
 
-	int result = a - n8;
-	bool new_half_carry = (a & 0xf) < (n8 & 0xf);
-	bool new_carry = a < n8;
+	set_lazy_flags(lazy_SUB, a, n8, false);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a - n8);
 
 	return cycles_EIGHT;
 }
 
 int CPU::SBC_R8(byte& a, const byte& register_value) {
 	bool c_flag = get_flag_state(flags_CARRY);
-	
-	int result = a - register_value - c_flag;
-	bool new_half_carry = (a & 0xf) < (register_value & 0xf) + c_flag;
-	bool new_carry = a < register_value + c_flag;
+	set_lazy_flags(lazy_SUB, a, register_value, c_flag);
 
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a - register_value - c_flag);
 
 	return cycles_FOUR;
 }
 
-int CPU::SBC_HL(byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::SBC_HL(byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	bool c_flag = get_flag_state(flags_CARRY);
+	set_lazy_flags(lazy_SUB, a, value, c_flag);
 
-	int result = a - value - c_flag;
-	bool new_half_carry = (a & 0xf) < (value & 0xf) + c_flag;
-	bool new_carry = a < value + c_flag;
-
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a - value - c_flag);
 
 	return cycles_EIGHT;
 }
@@ -461,47 +342,23 @@ int CPU::SBC_N8(byte& a) {
 	byte n8 = fetch_next_byte();
 
 	bool c_flag = get_flag_state(flags_CARRY);
+	set_lazy_flags(lazy_SUB, a, n8, c_flag);
 
-	int result = a - n8 - c_flag;
-	bool new_half_carry = (a & 0xf) < (n8 & 0xf) + c_flag;
-	bool new_carry = a < n8 + c_flag;
-
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	a = (byte)(a - n8 - c_flag);
 
 	return cycles_EIGHT;
-
 }
 
 int CPU::CP_R8(const byte& a, const byte& register_value) {
-	int result = a - register_value;
-	bool new_half_carry = (a & 0xf) < (register_value & 0xf);
-	bool new_carry = a < register_value;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	set_lazy_flags(lazy_SUB, a, register_value, false);
 
 	return cycles_FOUR;
 }
 
-int CPU::CP_HL(const byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::CP_HL(const byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
-	int result = a - value;
-	bool new_half_carry = (a & 0xf) < (value & 0xf);
-	bool new_carry = a < value;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	set_lazy_flags(lazy_SUB, a, value, false);
 
 	return cycles_EIGHT;
 }
@@ -509,14 +366,7 @@ int CPU::CP_HL(const byte& a, const byte& h, const byte& l) {
 int CPU::CP_N8(const byte& a) {
 	byte n8 = fetch_next_byte();
 
-	int result = a - n8;
-	bool new_half_carry = (a & 0xf) < (n8 & 0xf);
-	bool new_carry = a < n8;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, true);
-	set_flag_state(flags_HALFCARRY, new_half_carry);
-	set_flag_state(flags_CARRY, new_carry);
+	set_lazy_flags(lazy_SUB, a, n8, false);
 
 	return cycles_EIGHT;
 }
@@ -534,8 +384,7 @@ int CPU::INC_R8(byte& register_value) {
 	return cycles_FOUR;
 }
 
-int CPU::INC_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::INC_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	int result = value + 1;
@@ -563,8 +412,7 @@ int CPU::DEC_R8(byte& register_value) {
 	return cycles_FOUR;
 }
 
-int CPU::DEC_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::DEC_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	int result = value - 1;
@@ -580,28 +428,17 @@ int CPU::DEC_HL(const byte& h, const byte& l) {
 }
 
 int CPU::AND_R8(byte& a, const byte& register_value) {
-	int result = a & register_value;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, true);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a & register_value);
+	set_lazy_flags(lazy_AND, a, 0x00, false);
 
 	return cycles_FOUR;
 }
 
-int CPU::AND_HL(byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::AND_HL(byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
-	int result = a & value;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, true);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a & value);
+	set_lazy_flags(lazy_AND, a, 0x00, false);
 
 	return cycles_EIGHT;
 }
@@ -609,40 +446,24 @@ int CPU::AND_HL(byte& a, const byte& h, const byte& l) {
 int CPU::AND_N8(byte& a) {
 	byte n8 = fetch_next_byte();
 
-	int result = a & n8;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, true);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a & n8);
+	set_lazy_flags(lazy_AND, a, 0x00, false);
 
 	return cycles_EIGHT;
 }
 
 int CPU::OR_R8(byte& a, const byte& register_value) {
-	int result = a | register_value;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, false);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a | register_value);
+	set_lazy_flags(lazy_OR, a, 0x00, false);
 
 	return cycles_FOUR;
 }
 
-int CPU::OR_HL(byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::OR_HL(byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
-	int result = a | value;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, false);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a | value);
+	set_lazy_flags(lazy_OR, a, 0x00, false);
 
 	return cycles_EIGHT;
 }
@@ -650,41 +471,24 @@ int CPU::OR_HL(byte& a, const byte& h, const byte& l) {
 int CPU::OR_N8(byte& a) {
 	byte n8 = fetch_next_byte();
 
-	int result = a | n8;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, false);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a | n8);
+	set_lazy_flags(lazy_OR, a, 0x00, false);
 
 	return cycles_EIGHT;
-
 }
 
 int CPU::XOR_R8(byte& a, const byte& register_value) {
-	int result = a ^ register_value;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, false);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a ^ register_value);
+	set_lazy_flags(lazy_OR, a, 0x00, false);
 
 	return cycles_FOUR;
 }
 
-int CPU::XOR_HL(byte& a, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::XOR_HL(byte& a, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
-	int result = a ^ value;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, false);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a ^ value);
+	set_lazy_flags(lazy_OR, a, 0x00, false);
 
 	return cycles_EIGHT;
 }
@@ -692,16 +496,10 @@ int CPU::XOR_HL(byte& a, const byte& h, const byte& l) {
 int CPU::XOR_N8(byte& a) {
 	byte n8 = fetch_next_byte();
 
-	int result = a ^ n8;
-	a = (byte)result;
-
-	set_flag_state(flags_ZERO, (byte)result == 0);
-	set_flag_state(flags_SUBTRACTION, false);
-	set_flag_state(flags_HALFCARRY, false);
-	set_flag_state(flags_CARRY, false);
+	a = (byte)(a ^ n8);
+	set_lazy_flags(lazy_OR, a, 0x00, false);
 
 	return cycles_EIGHT;
-
 }
 
 int CPU::CCF() {
@@ -772,50 +570,33 @@ int CPU::CPL(byte& a) {
 
 //16 bit arithmetic
 
-int CPU::INC_R16(byte& register_high, byte& register_low) {
-	ushort joined_register = (ushort)(register_high << 8 | register_low);
-	int result = joined_register + 1;
-
-	byte low_result = (byte)((ushort)result & 0xff);
-	byte high_result = (byte)((ushort)result >> 8);
-
-	register_high = high_result;
-	register_low = low_result;
+int CPU::INC_R16(ushort& register_pair) {
+	register_pair = (ushort)(register_pair + 1);
 
 	internal_cycle_other_components();
 
 	return cycles_EIGHT;
 }
 
-int CPU::DEC_R16(byte& register_high, byte& register_low) {
-	ushort joined_register = (ushort)(register_high << 8 | register_low);
-	int result = joined_register - 1;
-
-	byte low_result = (byte)((ushort)result & 0xff);
-	byte high_result = (byte)((ushort)result >> 8);
-
-	register_high = high_result;
-	register_low = low_result;
+int CPU::DEC_R16(ushort& register_pair) {
+	register_pair = (ushort)(register_pair - 1);
 
 	internal_cycle_other_components();
 
 	return cycles_EIGHT;
 }
 
-int CPU::ADD_HL_R16(byte& h, byte& l, const byte& register_high, const byte& register_low) {
-	ushort hl = (ushort)(h << 8 | l);
-	ushort joined_register = (ushort)(register_high << 8 | register_low);
-
-	int result = hl + joined_register;
-
-	bool new_half_carry = (hl & 0xfff) + (joined_register & 0xfff) > 0xfff;
-	bool new_carry = hl + joined_register > 0xffff;
+int CPU::ADD_HL_R16(ushort& hl, const ushort& register_pair) {
+	//copy first, ADD HL,HL passes the same register twice
+	ushort value = register_pair;
+	int result = hl + value;
 
-	l = (byte)((ushort)result & 0xff);
+	bool new_half_carry = (hl & 0xfff) + (value & 0xfff) > 0xfff;
+	bool new_carry = result > 0xffff;
 
 	internal_cycle_other_components();
 
-	h = (byte)((ushort)result >> 8);
+	hl = (ushort)result;
 
 	set_flag_state(flags_SUBTRACTION, false);
 	set_flag_state(flags_HALFCARRY, new_half_carry);
@@ -919,8 +700,7 @@ int CPU::RLC_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::RLC_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::RLC_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte b7 = (value >> 7) & 0x1;
@@ -952,8 +732,7 @@ int CPU::RRC_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::RRC_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::RRC_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte b0 = value & 0x1;
@@ -986,8 +765,7 @@ int CPU::RL_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::RL_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::RL_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte b7 = (value >> 7) & 0x1;
@@ -1022,8 +800,7 @@ int CPU::RR_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::RR_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::RR_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 	
 	byte b0 = value & 0x1;
@@ -1057,8 +834,7 @@ int CPU::SLA_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::SLA_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::SLA_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte b7 = (value >> 7) & 0x1;
@@ -1092,8 +868,7 @@ int CPU::SRA_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::SRA_HL(const byte& h, const byte& l) {
-	ushort hl = (h << 8 | l);
+int CPU::SRA_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte b7 = (value >> 7) & 0x1;
@@ -1124,8 +899,7 @@ int CPU::SWAP_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::SWAP_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::SWAP_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 	
 	int result = (value << 4) | (value >> 4);
@@ -1155,8 +929,7 @@ int CPU::SRL_R8(byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::SRL_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::SRL_HL(const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte b0 = value & 0x1;
@@ -1184,8 +957,7 @@ int CPU::BIT_B_R8(const int& bit, const byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::BIT_B_HL(const int& bit, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::BIT_B_HL(const int& bit, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	bool new_zero = (value & (0x1 << bit)) != 0;
@@ -1204,8 +976,7 @@ int CPU::RES_B_R8(const int& bit, byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::RES_B_HL(const int& bit, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::RES_B_HL(const int& bit, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte mask = ~(1 << bit);
@@ -1222,8 +993,7 @@ int CPU::SET_B_R8(const int& bit, byte& register_value) {
 	return cycles_EIGHT;
 }
 
-int CPU::SET_B_HL(const int& bit, const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::SET_B_HL(const int& bit, const ushort& hl) {
 	byte value = read_from_bus(hl);
 
 	byte set = (1 << bit);
@@ -1247,8 +1017,7 @@ int CPU::JP_N16() {
 	return cycles_SIXTEEN;
 }
 
-int CPU::JP_HL(const byte& h, const byte& l) {
-	ushort hl = (ushort)(h << 8 | l);
+int CPU::JP_HL(const ushort& hl) {
 	data.pc = hl;
 
 	return cycles_FOUR;
@@ -1309,6 +1078,9 @@ int CPU::CALL_N16(ushort& sp) {
 	write_to_bus(sp, pc_low);
 
 	data.pc = call;
+#ifdef SHARPBOY_PROFILER
+	emulator_ptr->profile_call(data.pc);
+#endif
 	return cycles_TWENTYFOUR;
 }
 
@@ -1329,6 +1101,9 @@ int CPU::CALL_CC_N16(ushort& sp, const bool& condition) {
 		write_to_bus(sp, pc_low);
 
 		data.pc = call;
+#ifdef SHARPBOY_PROFILER
+		emulator_ptr->profile_call(data.pc);
+#endif
 		return cycles_TWENTYFOUR;
 	}
 
@@ -1345,6 +1120,9 @@ int CPU::RET(ushort& sp) {
 
 	data.pc = ret;
 	internal_cycle_other_components();
+#ifdef SHARPBOY_PROFILER
+	emulator_ptr->profile_return();
+#endif
 
 	return cycles_SIXTEEN;
 }
@@ -1362,6 +1140,9 @@ int CPU::RET_CC(ushort& sp, const bool& condition) {
 
 		data.pc = ret;
 		internal_cycle_other_components();
+#ifdef SHARPBOY_PROFILER
+		emulator_ptr->profile_return();
+#endif
 		return cycles_TWENTY;
 	}
 
@@ -1379,6 +1160,9 @@ int CPU::RETI(ushort& sp) {
 	data.pc = ret;
 	data.ime = true;
 	internal_cycle_other_components();
+#ifdef SHARPBOY_PROFILER
+	emulator_ptr->profile_return();
+#endif
 	return cycles_SIXTEEN;
 }
 
@@ -1394,6 +1178,9 @@ int CPU::RST_N8(ushort& sp, const byte& vector) {
 	write_to_bus(sp, pc_low);
 
 	data.pc = (ushort)(0x0000 | vector);
+#ifdef SHARPBOY_PROFILER
+	emulator_ptr->profile_call(data.pc);
+#endif
 	return cycles_SIXTEEN;
 }
 
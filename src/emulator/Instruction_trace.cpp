@@ -0,0 +1,134 @@
+#include "Instruction_trace.h"
+#include <chrono>
+#include <algorithm>
+
+Instruction_trace::Instruction_trace() {
+	ring.resize(INSTRUCTION_TRACE_RING_SIZE);
+}
+
+Instruction_trace::~Instruction_trace() {
+	stop();
+}
+
+bool Instruction_trace::start(const std::string& file_name) {
+	if (is_running()) {
+		return false;
+	}
+
+	output = fopen(file_name.c_str(), "wb");
+	if (output == nullptr) {
+		printf("[SB] Failed to open %s for writing\n", file_name.c_str());
+		return false;
+	}
+
+	fwrite(INSTRUCTION_TRACE_MAGIC, 1, sizeof(INSTRUCTION_TRACE_MAGIC), output);
+
+	head.store(0);
+	tail.store(0);
+	running.store(true);
+	writer = std::thread(&Instruction_trace::writer_loop, this);
+
+	printf("[SB] Tracing instructions to %s\n", file_name.c_str());
+	return true;
+}
+
+void Instruction_trace::stop() {
+	if (!is_running()) {
+		return;
+	}
+
+	running.store(false);
+	writer.join();
+
+	fclose(output);
+	output = nullptr;
+
+	printf("[SB] Stopped instruction trace after %llu records\n", (unsigned long long)head.load());
+}
+
+const bool Instruction_trace::is_running() const {
+	return running.load(std::memory_order_relaxed);
+}
+
+const uint64_t Instruction_trace::get_record_count() const {
+	return head.load(std::memory_order_relaxed);
+}
+
+int Instruction_trace::format_doctor_line(const instruction_trace_record& trace_record, char* buffer, const size_t& buffer_size) {
+	return snprintf(buffer, buffer_size, "A:%02X F:%02X B:%02X C:%02X D:%02X E:%02X H:%02X L:%02X SP:%04X PC:%04X PCMEM:%02X,%02X,%02X,%02X\n",
+		trace_record.af >> 8, trace_record.af & 0xff, trace_record.bc >> 8, trace_record.bc & 0xff,
+		trace_record.de >> 8, trace_record.de & 0xff, trace_record.hl >> 8, trace_record.hl & 0xff,
+		trace_record.sp, trace_record.pc,
+		trace_record.pc_bytes[0], trace_record.pc_bytes[1], trace_record.pc_bytes[2], trace_record.pc_bytes[3]);
+}
+
+bool Instruction_trace::convert_to_doctor_log(const std::string& trace_file_name, const std::string& output_file_name) {
+	FILE* input = fopen(trace_file_name.c_str(), "rb");
+	if (input == nullptr) {
+		printf("[SB] Failed to open %s\n", trace_file_name.c_str());
+		return false;
+	}
+
+	char magic[sizeof(INSTRUCTION_TRACE_MAGIC)] = {};
+	if (fread(magic, 1, sizeof(magic), input) != sizeof(magic) || !std::equal(magic, magic + sizeof(magic), INSTRUCTION_TRACE_MAGIC)) {
+		printf("[SB] %s is not a Sharpboy++ instruction trace\n", trace_file_name.c_str());
+		fclose(input);
+		return false;
+	}
+
+	FILE* log = fopen(output_file_name.c_str(), "w");
+	if (log == nullptr) {
+		printf("[SB] Failed to open %s for writing\n", output_file_name.c_str());
+		fclose(input);
+		return false;
+	}
+
+	std::vector<instruction_trace_record> records = std::vector<instruction_trace_record>(4096);
+	char line[128];
+	uint64_t converted = 0;
+
+	size_t count = 0;
+	while ((count = fread(records.data(), sizeof(instruction_trace_record), records.size(), input)) > 0) {
+		for (size_t i = 0; i < count; i++) {
+			int length = format_doctor_line(records[i], line, sizeof(line));
+			fwrite(line, 1, length, log);
+		}
+		converted += count;
+	}
+
+	fclose(log);
+	fclose(input);
+
+	printf("[SB] Converted %llu records to %s\n", (unsigned long long)converted, output_file_name.c_str());
+	return true;
+}
+
+//privates
+void Instruction_trace::writer_loop() {
+	while (running.load(std::memory_order_relaxed)) {
+		uint64_t end = head.load(std::memory_order_acquire);
+		if (end == tail.load(std::memory_order_relaxed)) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+
+		write_pending(end);
+	}
+
+	//the cpu has stopped recording by now, flush whatever is left
+	write_pending(head.load(std::memory_order_acquire));
+}
+
+void Instruction_trace::write_pending(const uint64_t& end) {
+	uint64_t position = tail.load(std::memory_order_relaxed);
+
+	//at most two contiguous runs, up to the end of the ring and then from the start
+	while (position < end) {
+		size_t index = (size_t)(position & (INSTRUCTION_TRACE_RING_SIZE - 1));
+		size_t count = (size_t)std::min<uint64_t>(end - position, INSTRUCTION_TRACE_RING_SIZE - index);
+
+		fwrite(&ring[index], sizeof(instruction_trace_record), count, output);
+		position += count;
+		tail.store(position, std::memory_order_release);
+	}
+}
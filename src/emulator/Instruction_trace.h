@@ -0,0 +1,72 @@
+#pragma once
+
+#include "_definitions.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+//binary per instruction trace, records go into a ring in memory and a writer thread streams them to disk
+//file layout: INSTRUCTION_TRACE_MAGIC followed by packed instruction_trace_record structs (little endian)
+
+const char INSTRUCTION_TRACE_MAGIC[8] = { 'S', 'B', 'T', 'R', 'A', 'C', 'E', '1' };
+
+//records in the ring, must be a power of 2 (24MiB)
+const int INSTRUCTION_TRACE_RING_SIZE = 1 << 20;
+
+//cpu state before the instruction at pc runs
+#pragma pack(push, 1)
+struct instruction_trace_record {
+	uint64_t cycle = 0;
+	ushort af = 0x0000;
+	ushort bc = 0x0000;
+	ushort de = 0x0000;
+	ushort hl = 0x0000;
+	ushort sp = 0x0000;
+	ushort pc = 0x0000;
+	byte pc_bytes[4] = {};
+};
+#pragma pack(pop)
+
+static_assert(sizeof(instruction_trace_record) == 24, "trace records are written to disk as is");
+
+class Instruction_trace {
+public:
+	Instruction_trace();
+	~Instruction_trace();
+
+	bool start(const std::string& file_name);
+	void stop();
+	const bool is_running() const;
+	const uint64_t get_record_count() const;
+
+	//called by the cpu for every instruction, only blocks when the writer has fallen a whole ring behind
+	inline void record(const instruction_trace_record& trace_record) {
+		uint64_t position = head.load(std::memory_order_relaxed);
+		while (position - tail.load(std::memory_order_acquire) >= INSTRUCTION_TRACE_RING_SIZE) {
+			std::this_thread::yield();
+		}
+
+		ring[position & (INSTRUCTION_TRACE_RING_SIZE - 1)] = trace_record;
+		head.store(position + 1, std::memory_order_release);
+	}
+
+	//gameboy-doctor line, "A:01 F:B0 B:00 C:13 D:00 E:D8 H:01 L:4D SP:FFFE PC:0100 PCMEM:00,C3,13,02"
+	static int format_doctor_line(const instruction_trace_record& trace_record, char* buffer, const size_t& buffer_size);
+	static bool convert_to_doctor_log(const std::string& trace_file_name, const std::string& output_file_name);
+
+private:
+	void writer_loop();
+	void write_pending(const uint64_t& end);
+
+private:
+	std::vector<instruction_trace_record> ring = std::vector<instruction_trace_record>();
+	std::atomic<uint64_t> head = 0;
+	std::atomic<uint64_t> tail = 0;
+
+	FILE* output = nullptr;
+	std::thread writer;
+	std::atomic<bool> running = false;
+};
@@ -0,0 +1,120 @@
+#include "Joypad.h"
+#include "Emulator.h"
+#include <cstdio>
+
+//without a vblank (lcd off) the poll still comes around once a frame's worth of cycles
+const uint64_t JOYPAD_POLL_CYCLES = 70224;
+
+Joypad::Joypad(std::shared_ptr<Emulator> emulator_ptr) {
+	this->emulator_ptr = emulator_ptr;
+}
+
+Joypad::~Joypad() {
+	this->emulator_ptr.reset();
+	this->emulator_ptr = nullptr;
+
+	printf("[SB] Shutting down JOYPAD object\n");
+}
+
+void Joypad::set_host_buttons(const byte& buttons) {
+	host_buttons.store(buttons, std::memory_order_release);
+}
+
+void Joypad::set_input_poller(input_poller poller, void* context) {
+	this->poller = poller;
+	this->poller_context = context;
+}
+
+byte Joypad::read_joyp(const byte& select) {
+	uint64_t cycles = emulator_ptr->get_elapsed_cycles();
+	if (poller != nullptr && (!polled_this_frame || cycles - last_poll_cycle >= JOYPAD_POLL_CYCLES)) {
+		poller(poller_context);
+		polled_this_frame = true;
+		last_poll_cycle = cycles;
+	}
+
+	sync_input(select);
+
+	byte selected = get_selected_buttons(select, buttons);
+	if (selected != button_NONE) {
+		read_buttons.fetch_or(selected, std::memory_order_release);
+	}
+
+	return peek_joyp(select);
+}
+
+byte Joypad::take_read_buttons() {
+	return read_buttons.exchange(button_NONE, std::memory_order_acq_rel);
+}
+
+byte Joypad::peek_joyp(const byte& select) const {
+	return 0xc0 | (select & 0x30) | get_lines(select, buttons);
+}
+
+void Joypad::write_joyp(const byte& old_select, const byte& new_select) {
+	//picking a row with a button already held pulls its line low too
+	if ((get_lines(old_select, buttons) & ~get_lines(new_select, buttons)) != 0) {
+		emulator_ptr->trigger_interrupt(int_JOYPAD);
+	}
+}
+
+void Joypad::sync_input(const byte& select) {
+	byte held = host_buttons.load(std::memory_order_acquire);
+	if (held == buttons) {
+		return;
+	}
+
+	if ((get_lines(select, buttons) & ~get_lines(select, held)) != 0) {
+		emulator_ptr->trigger_interrupt(int_JOYPAD);
+	}
+	buttons = held;
+}
+
+void Joypad::start_frame() {
+	polled_this_frame = false;
+}
+
+void Joypad::save_state(joypad_snapshot& snapshot) {
+	snapshot.buttons = buttons;
+	snapshot.polled_this_frame = polled_this_frame;
+	snapshot.last_poll_cycle = last_poll_cycle;
+}
+
+void Joypad::load_state(const joypad_snapshot& snapshot) {
+	buttons = snapshot.buttons;
+	polled_this_frame = snapshot.polled_this_frame;
+	last_poll_cycle = snapshot.last_poll_cycle;
+}
+
+uint64_t Joypad::get_state_hash(const uint64_t& hash) {
+	uint64_t state_hash = hash_state_value(hash, buttons);
+	state_hash = hash_state_value(state_hash, polled_this_frame);
+	return hash_state_value(state_hash, last_poll_cycle);
+}
+
+//privates
+//the low nibble, active low
+byte Joypad::get_lines(const byte& select, const byte& buttons) const {
+	byte lines = 0x0f;
+	if ((select & 0x10) == 0) {
+		lines &= ~(buttons & 0x0f);
+	}
+	if ((select & 0x20) == 0) {
+		lines &= ~(buttons >> 4);
+	}
+
+	return lines & 0x0f;
+}
+
+//the held buttons in the rows select picks, as joypad_buttons
+byte Joypad::get_selected_buttons(const byte& select, const byte& buttons) const {
+	byte selected = button_NONE;
+	if ((select & 0x10) == 0) {
+		selected |= buttons & 0x0f;
+	}
+	if ((select & 0x20) == 0) {
+		selected |= buttons & 0xf0;
+	}
+
+	return selected;
+}
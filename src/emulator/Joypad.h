@@ -0,0 +1,62 @@
+#pragma once
+
+#include "_definitions.h"
+#include <atomic>
+#include <memory>
+
+class Emulator;
+
+//dmg joypad, the host stores held buttons into an atomic from wherever it reads input and the guest latches them on the emulation thread
+//the host is asked for fresh input right before the guest's first JOYP read each frame rather than once per host loop,
+//so what the game reads is as new as it can be (see set_input_poller)
+
+typedef void (*input_poller)(void* context);
+
+//guest side latch, the host buttons and poller stay with the running joypad
+struct joypad_snapshot {
+	byte buttons = button_NONE;
+	bool polled_this_frame = false;
+	uint64_t last_poll_cycle = 0;
+};
+
+class Joypad {
+public:
+	Joypad(std::shared_ptr<Emulator> emulator_ptr);
+	~Joypad();
+
+	//host side, buttons are joypad_buttons held
+	void set_host_buttons(const byte& buttons);
+	void set_input_poller(input_poller poller, void* context);
+
+	//guest side, select is JOYP as last written (bit 4 low picks directions, bit 5 low picks actions)
+	byte read_joyp(const byte& select);
+	byte peek_joyp(const byte& select) const;
+	void write_joyp(const byte& old_select, const byte& new_select);
+
+	//held buttons the guest has actually seen in a JOYP read since the last take, for latency measurement
+	byte take_read_buttons();
+
+	//takes the host buttons, a line going low raises the joypad interrupt
+	void sync_input(const byte& select);
+	void start_frame();
+
+	void save_state(joypad_snapshot& snapshot);
+	void load_state(const joypad_snapshot& snapshot);
+	uint64_t get_state_hash(const uint64_t& hash);
+
+private:
+	byte get_lines(const byte& select, const byte& buttons) const;
+	byte get_selected_buttons(const byte& select, const byte& buttons) const;
+
+private:
+	std::shared_ptr<Emulator> emulator_ptr;
+
+	std::atomic<byte> host_buttons = button_NONE;
+	byte buttons = button_NONE;
+	std::atomic<byte> read_buttons = button_NONE;
+
+	input_poller poller = nullptr;
+	void* poller_context = nullptr;
+	bool polled_this_frame = false;
+	uint64_t last_poll_cycle = 0;
+};
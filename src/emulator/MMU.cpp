@@ -1,5 +1,6 @@
 #include "MMU.h"
 #include "Emulator.h"
+#include <algorithm>
 
 MMU::MMU(std::shared_ptr<Emulator> emulator_ptr) {
 	this->emulator_ptr = emulator_ptr;
@@ -45,6 +46,64 @@ void MMU::reset_mmu(const rom_header& header, const std::vector<byte>& rom, cons
 
 //read/write with blocking of oam when dma or when ppu is active
 byte MMU::read_from_memory(const ushort& address) {
+#ifdef SHARPBOY_HEATMAP
+	emulator_ptr->heatmap_read(address);
+#endif
+	return guest_read(address);
+}
+
+//read_from_memory plus the watchpoint test, only used while a read watchpoint is set (see Emulator::refresh_debug_hooks)
+byte MMU::watched_read_from_memory(const ushort& address) {
+	byte value = read_from_memory(address);
+	if (page_flags[address >> 8] & page_WATCH_READ) {
+		emulator_ptr->check_watchpoint(address, value, watch_READ);
+	}
+
+	return value;
+}
+
+//fetch_from_memory's map, but io goes through read_io_guest so a JOYP read can poll the host
+byte MMU::guest_read(const ushort& address) {
+	if (address == 0xffff) {
+		return memory.IE;
+	}
+	else if (address >= 0x0000 && address < 0x8000) {
+		return memory.cartridge[address];
+	}
+	else if (address >= 0x8000 && address < 0xa000) {
+		return memory.vram[(ushort)(address - 0x8000)];
+	}
+	else if (address >= 0xa000 && address < 0xc000) {
+		return 0xff;
+	}
+	else if (address >= 0xc000 && address < 0xe000) {
+		return memory.wram[(ushort)(address - 0xc000)];
+	}
+	else if (address >= 0xe000 && address < 0xfe00) {
+		return guest_read((ushort)(address - 0x2000));
+	}
+	else if (address >= 0xfe00 && address < 0xfea0) {
+		if (dma_active) {
+			return 0xff;
+		}
+
+		return memory.oam[(ushort)(address - 0xfe00)];
+	}
+	else if (address >= 0xfea0 && address < 0xff00) {
+		return 0xff; //not usable
+	}
+	else if (address >= 0xff00 && address < 0xff80) {
+		return read_io_guest((byte)(address & 0xff));
+	}
+	else if (address >= 0xff80 && address < 0xffff) {
+		return memory.hram[(byte)(address - 0xff80)];
+	}
+
+	return 0xff;
+}
+
+//same view of memory as read_from_memory but not a data access, used for instruction fetches, block decoding and debug reads
+byte MMU::fetch_from_memory(const ushort& address) {
 	//printf("[SB] MMU read at %04X\n", address);
 	
 	if (address == 0xffff) {
@@ -71,7 +130,7 @@ byte MMU::read_from_memory(const ushort& address) {
 		return memory.wram[(ushort)(address - 0xc000)];
 	}
 	else if (address >= 0xe000 && address < 0xfe00) {
-		return read_from_memory((ushort)(address - 0x2000));
+		return fetch_from_memory((ushort)(address - 0x2000));
 	}
 	else if (address >= 0xfe00 && address < 0xfea0) {
 		if (dma_active) {
@@ -96,6 +155,9 @@ byte MMU::read_from_memory(const ushort& address) {
 
 void MMU::write_to_memory(const ushort& address, const byte& value) {
 	//printf("[SB] MMU write at %04X with value %02X\n", address, value);
+#ifdef SHARPBOY_HEATMAP
+	emulator_ptr->heatmap_write(address);
+#endif
 
 	//TESTING FOR BLARGGS
 	if (address == 0xff02 && value == 0x81) {
@@ -105,11 +167,17 @@ void MMU::write_to_memory(const ushort& address, const byte& value) {
 		return;
 	}
 
+	//cached code and watchpoints share one page flag test, unflagged pages never look further
+	if (page_flags[address >> 8] != page_NONE) {
+		handle_flagged_write(address, value);
+	}
+
 	if (address == 0xffff) {
 		memory.IE = value;
 		return;
 	}
 	else if (address >= 0x0000 && address < 0x8000) {
+		//no mbc yet so rom writes land in the cartridge
 		memory.cartridge[address] = value;
 		return;
 	}
@@ -118,6 +186,7 @@ void MMU::write_to_memory(const ushort& address, const byte& value) {
 		//ppu_modes ppu_state = emulator_ptr->get_current_ppu_mode();
 		//if (ppu_state == ppu_VBLANK || ppu_state == ppu_HBLANK) {
 			memory.vram[(ushort)(address - 0x8000)] = value;
+			emulator_ptr->vram_written(address);
 			return;
 		//}
 
@@ -142,6 +211,7 @@ void MMU::write_to_memory(const ushort& address, const byte& value) {
 		}
 
 		memory.oam[(ushort)(address - 0xfe00)] = value;
+		emulator_ptr->oam_written();
 		return;
 	}
 	else if (address >= 0xfea0 && address < 0xff00) {
@@ -160,6 +230,32 @@ void MMU::write_to_memory(const ushort& address, const byte& value) {
 	return;
 }
 
+//writes to pages holding cached code, disassembly or watchpoints
+void MMU::handle_flagged_write(const ushort& address, const byte& value) {
+	byte flags = page_flags[address >> 8];
+
+	if (flags & page_WATCH_WRITE) {
+		emulator_ptr->check_watchpoint(address, value, watch_WRITE);
+	}
+
+	drop_cached_page(address);
+}
+
+//drops code/disassembly cached from the page, for cpu writes and memory viewer edits alike
+void MMU::drop_cached_page(const ushort& address) {
+	byte flags = page_flags[address >> 8];
+
+	if (flags & page_DISASSEMBLED) {
+		emulator_ptr->invalidate_disassembly_page((byte)(address >> 8));
+	}
+
+	//drop any code cached from the page, io and ie share hram's page but never hold code
+	bool code_region = address < 0xff00 || (address >= 0xff80 && address < 0xffff);
+	if ((flags & page_CODE) && code_region) {
+		emulator_ptr->invalidate_code_page((byte)(address >> 8));
+	}
+}
+
 //read/write without blocking of oam when dma or when ppu is active
 byte MMU::unblocked_read(const ushort& address) {
 	//printf("[SB] MMU read at %04X\n", address);
@@ -180,7 +276,7 @@ byte MMU::unblocked_read(const ushort& address) {
 		return memory.wram[(ushort)(address - 0xc000)];
 	}
 	else if (address >= 0xe000 && address < 0xfe00) {
-		return read_from_memory((ushort)(address - 0x2000));
+		return unblocked_read((ushort)(address - 0x2000));
 	}
 	else if (address >= 0xfe00 && address < 0xfea0) {
 		return memory.oam[(ushort)(address - 0xfe00)];
@@ -218,6 +314,7 @@ void MMU::unblocked_write(const ushort& address, const byte& value) {
 	}
 	else if (address >= 0x8000 && address < 0xa000) {
 		memory.vram[(ushort)(address - 0x8000)] = value;
+		emulator_ptr->vram_written(address);
 		return;
 	}
 	else if (address >= 0xa000 && address < 0xc000) {
@@ -230,11 +327,12 @@ void MMU::unblocked_write(const ushort& address, const byte& value) {
 	}
 	else if (address >= 0xe000 && address < 0xfe00) {
 		//echo (mirror of 0xc000-0xddff)
-		write_to_memory((ushort)(address - 0x2000), value);
+		unblocked_write((ushort)(address - 0x2000), value);
 		return;
 	}
 	else if (address >= 0xfe00 && address < 0xfea0) {
 		memory.oam[(ushort)(address - 0xfe00)] = value;
+		emulator_ptr->oam_written();
 		return;
 	}
 	else if (address >= 0xfea0 && address < 0xff00) {
@@ -253,6 +351,43 @@ void MMU::unblocked_write(const ushort& address, const byte& value) {
 	return;
 }
 
+//edits from the memory viewer, no watchpoints fire but anything cached from the page is stale
+void MMU::edit_memory(const ushort& address, const byte& value) {
+	ushort target = (address >= 0xe000 && address < 0xfe00) ? (ushort)(address - 0x2000) : address;
+	if (page_flags[target >> 8] != page_NONE) {
+		drop_cached_page(target);
+	}
+
+	unblocked_write(target, value);
+}
+
+//the whole bus as unblocked_read sees it, copied region by region so a viewer can take it every frame
+void MMU::copy_address_space(std::array<byte, 0x10000>& bus) {
+	size_t rom_bytes = std::min<size_t>(memory.cartridge.size(), 0x8000);
+	std::copy(memory.cartridge.begin(), memory.cartridge.begin() + rom_bytes, bus.begin());
+	std::fill(bus.begin() + rom_bytes, bus.begin() + 0x8000, 0xff);
+
+	std::copy(memory.vram.begin(), memory.vram.end(), bus.begin() + 0x8000);
+	size_t eram_bytes = std::min<size_t>(memory.eram.size(), 0x2000);
+	std::copy(memory.eram.begin(), memory.eram.begin() + eram_bytes, bus.begin() + 0xa000);
+	std::fill(bus.begin() + 0xa000 + eram_bytes, bus.begin() + 0xc000, 0xff);
+	std::copy(memory.wram.begin(), memory.wram.end(), bus.begin() + 0xc000);
+	std::copy(memory.wram.begin(), memory.wram.begin() + 0x1e00, bus.begin() + 0xe000);
+	std::copy(memory.oam.begin(), memory.oam.end(), bus.begin() + 0xfe00);
+	std::fill(bus.begin() + 0xfea0, bus.begin() + 0xff00, 0xff);
+
+	for (int io = 0; io < IO_SIZE; io++) {
+		bus[0xff00 + io] = read_io((byte)io);
+	}
+
+	std::copy(memory.hram.begin(), memory.hram.end(), bus.begin() + 0xff80);
+	bus[0xffff] = memory.IE;
+}
+
+const std::array<byte, OAM_SIZE>& MMU::get_oam() const {
+	return memory.oam;
+}
+
 byte MMU::read_io(const byte& io_target) {
 	//should the io be for timer/ppu, redirect the read
 	if (io_target >= io_DIV && io_target <= io_TAC) {
@@ -263,7 +398,7 @@ byte MMU::read_io(const byte& io_target) {
 	}
 	else {
 		switch (io_target) {
-		case io_JOYP: return 0xff;
+		case io_JOYP: return emulator_ptr->peek_joypad(memory.io.JOYP);
 		case io_SB: return memory.io.SB;
 		case io_SC: return memory.io.SC;
 		case io_IF: return memory.io.IF;
@@ -274,6 +409,15 @@ byte MMU::read_io(const byte& io_target) {
 	}	
 }
 
+//only the guest's own joypad reads ask the host for fresh input, fetches and debug reads see what is latched
+byte MMU::read_io_guest(const byte& io_target) {
+	if (io_target == io_JOYP) {
+		return emulator_ptr->read_joypad(memory.io.JOYP);
+	}
+
+	return read_io(io_target);
+}
+
 void MMU::write_io(const byte& io_target, const byte& value) {
 	//should our io be for the timer/ppu, redirect the write
 	if (io_target >= io_DIV && io_target <= io_TAC) {
@@ -286,7 +430,10 @@ void MMU::write_io(const byte& io_target, const byte& value) {
 	}
 	else {
 		switch (io_target) {
-		case io_JOYP: return;
+		case io_JOYP:
+			emulator_ptr->write_joypad(memory.io.JOYP, value);
+			memory.io.JOYP = 0xcf | (value & 0x30);
+			return;
 		case io_SB: memory.io.SB = value; return;
 		case io_SC: memory.io.SC = value; return;
 		case io_IF: memory.io.IF = value | 0xe0; return;
@@ -326,6 +473,32 @@ void MMU::swap_cartridge_and_boot_roms() {
 		memory.cartridge[x] = memory.boot_rom[x];
 		memory.boot_rom[x] = first_bytes[x];
 	}
+
+	//the boot rom fills page 0 exactly, any code cached from it is no longer mapped
+	if (page_flags[0x00] & page_CODE) {
+		emulator_ptr->invalidate_code_page(0x00);
+	}
+}
+
+int MMU::get_memory_bank(const ushort& address) {
+	//no mbc support yet, bank 1 is always mapped at 0x4000-0x7fff
+	if (address >= 0x4000 && address < 0x8000) {
+		return 1;
+	}
+
+	return 0;
+}
+
+void MMU::set_page_flag(const byte& page, const memory_page_flags& flag) {
+	page_flags[page] |= flag;
+}
+
+void MMU::set_read_watch_armed(const bool& armed) {
+	read_watch_armed = armed;
+}
+
+void MMU::clear_page_flag(const byte& page, const memory_page_flags& flag) {
+	page_flags[page] &= ~flag;
 }
 
 void MMU::dma_tick() {
@@ -358,12 +531,13 @@ void MMU::dma_tick() {
 			dma_cycles++;
 
 			//read the value and put into oam
-			byte dma_value = read_from_memory(dma_address++);
+			byte dma_value = read_watch_armed ? watched_read_from_memory(dma_address++) : read_from_memory(dma_address++);
 			memory.oam[dma_cycles - 1] = dma_value;
 		}
 
 		//if our total dma cycles is the total amount for a cycle, turn off dma and reset it
 		if (dma_cycles == DMA_TOTAL_TICKS) {
+			emulator_ptr->oam_written();
 			dma_active = false;
 			dma_address = 0x0000;
 			dma_cycles = 0;
@@ -373,3 +547,20 @@ void MMU::dma_tick() {
 		}
 	}
 }
+
+//cartridge/boot rom are left out, they only change when a rom is loaded
+uint64_t MMU::get_state_hash(const uint64_t& hash) {
+	uint64_t state_hash = hash_state_bytes(hash, memory.vram.data(), memory.vram.size());
+	state_hash = hash_state_bytes(state_hash, memory.wram.data(), memory.wram.size());
+	state_hash = hash_state_bytes(state_hash, memory.oam.data(), memory.oam.size());
+	state_hash = hash_state_bytes(state_hash, memory.hram.data(), memory.hram.size());
+	state_hash = hash_state_value(state_hash, memory.io);
+	state_hash = hash_state_value(state_hash, memory.IE);
+
+	state_hash = hash_state_value(state_hash, dma_address);
+	state_hash = hash_state_value(state_hash, start_new_dma);
+	state_hash = hash_state_value(state_hash, dma_active);
+	state_hash = hash_state_value(state_hash, dma_delay);
+	state_hash = hash_state_value(state_hash, dma_ticks_this_cycles);
+	return hash_state_value(state_hash, dma_cycles);
+}
@@ -62,24 +62,49 @@ public:
 	void reset_mmu(const rom_header& header, const std::vector<byte>& rom, const std::array<byte, 0x100>& boot_rom);
 
 	byte read_from_memory(const ushort& address);
+	byte watched_read_from_memory(const ushort& address);
+	byte fetch_from_memory(const ushort& address);
 	void write_to_memory(const ushort& address, const byte& value);
 
 	byte unblocked_read(const ushort& address);
 	void unblocked_write(const ushort& address, const byte& value);
 
+	//memory viewer access, side effect free apart from dropping cached code on edits
+	void edit_memory(const ushort& address, const byte& value);
+	void copy_address_space(std::array<byte, 0x10000>& bus);
+	const std::array<byte, OAM_SIZE>& get_oam() const;
+
 	byte read_io(const byte& io_target);
 	void write_io(const byte& io_target, const byte& value);
 
 	void swap_cartridge_and_boot_roms();
 
+	//bank currently mapped at an address, used to key cached code
+	int get_memory_bank(const ushort& address);
+
+	//per 256 byte page flags (see memory_page_flags)
+	void set_page_flag(const byte& page, const memory_page_flags& flag);
+	void clear_page_flag(const byte& page, const memory_page_flags& flag);
+	void set_read_watch_armed(const bool& armed);
+
 	void dma_tick();
 
+	uint64_t get_state_hash(const uint64_t& hash);
+
+private:
+	byte guest_read(const ushort& address);
+	byte read_io_guest(const byte& io_target);
+	void handle_flagged_write(const ushort& address, const byte& value);
+	void drop_cached_page(const ushort& address);
+
 private:
 	std::shared_ptr<Emulator> emulator_ptr;
 
 	bool initialised = false;
 	bool using_boot_rom = false;
 	memory_map memory;
+	std::array<byte, 0x100> page_flags = std::array<byte, 0x100>();
+	bool read_watch_armed = false;
 
 	ushort dma_address = 0x0000;
 	bool start_new_dma = false;
@@ -89,7 +114,7 @@ private:
 	int dma_ticks_this_cycles = 0;
 	int dma_cycles = 0;
 
-	const int DEFAULT_DMA_DELAY = 8;
-	const int DMA_TOTAL_TICKS = 160;
+	static constexpr int DEFAULT_DMA_DELAY = 8;
+	static constexpr int DMA_TOTAL_TICKS = 160;
 	int total_dma_ticks = 0;
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "Memory_view.h"
+#include "Emulator.h"
+#include <cstdio>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHARPBOY_SSE2_DIFF
+#endif
+
+Memory_view::Memory_view(std::shared_ptr<Emulator> emulator_ptr) {
+	this->emulator_ptr = emulator_ptr;
+}
+
+Memory_view::~Memory_view() {
+	this->emulator_ptr.reset();
+	this->emulator_ptr = nullptr;
+
+	printf("[SB] Shutting down MEMORY VIEW object\n");
+}
+
+void Memory_view::refresh() {
+	uint64_t cycle = emulator_ptr->get_elapsed_cycles();
+	if (has_copy && cycle == refreshed_at_cycle) {
+		return;
+	}
+
+	shadow = bytes;
+	emulator_ptr->copy_address_space(bytes);
+	if (has_copy) {
+		diff_with_shadow();
+	}
+
+	refreshed_at_cycle = cycle;
+	has_copy = true;
+}
+
+//after an edit, so the new value shows (and highlights) straight away
+void Memory_view::force_refresh() {
+	refreshed_at_cycle = ~0ull;
+}
+
+const std::array<byte, 0x10000>& Memory_view::get_bytes() const {
+	return bytes;
+}
+
+bool Memory_view::has_changed(const ushort& address) const {
+	return changed[address] != 0;
+}
+
+int Memory_view::get_changed_count() const {
+	return changed_count;
+}
+
+//privates
+void Memory_view::diff_with_shadow() {
+	int count = 0;
+
+#ifdef SHARPBOY_SSE2_DIFF
+	//16 bytes per compare, the mask is stored inverted so changed bytes read 0xff
+	const __m128i ones = _mm_set1_epi8((char)0xff);
+	for (size_t i = 0; i < bytes.size(); i += 16) {
+		__m128i current = _mm_loadu_si128((const __m128i*)(bytes.data() + i));
+		__m128i previous = _mm_loadu_si128((const __m128i*)(shadow.data() + i));
+		__m128i equal = _mm_cmpeq_epi8(current, previous);
+		_mm_storeu_si128((__m128i*)(changed.data() + i), _mm_xor_si128(equal, ones));
+		count += std::popcount((unsigned int)(~_mm_movemask_epi8(equal) & 0xffff));
+	}
+#else
+	for (size_t i = 0; i < bytes.size(); i++) {
+		changed[i] = bytes[i] != shadow[i] ? 0xff : 0x00;
+		count += bytes[i] != shadow[i];
+	}
+#endif
+
+	changed_count = count;
+}
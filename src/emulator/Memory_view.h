@@ -0,0 +1,37 @@
+#pragma once
+
+#include "_definitions.h"
+#include <memory>
+#include <array>
+
+class Emulator;
+
+//backing data for the memory viewer window, a copy of the whole bus plus which bytes changed
+//the copy is only retaken when the emulator has run since the last refresh, so a paused rom keeps its highlights
+
+class Memory_view {
+public:
+	Memory_view(std::shared_ptr<Emulator> emulator_ptr);
+	~Memory_view();
+
+	void refresh();
+	void force_refresh();
+
+	const std::array<byte, 0x10000>& get_bytes() const;
+	bool has_changed(const ushort& address) const;
+	int get_changed_count() const;
+
+private:
+	void diff_with_shadow();
+
+private:
+	std::shared_ptr<Emulator> emulator_ptr;
+
+	std::array<byte, 0x10000> bytes = std::array<byte, 0x10000>();
+	std::array<byte, 0x10000> shadow = std::array<byte, 0x10000>();
+	std::array<byte, 0x10000> changed = std::array<byte, 0x10000>(); //0xff where bytes differs from shadow
+	int changed_count = 0;
+
+	uint64_t refreshed_at_cycle = 0;
+	bool has_copy = false;
+};
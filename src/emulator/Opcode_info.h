@@ -0,0 +1,594 @@
+#pragma once
+
+#include "_definitions.h"
+#include <array>
+
+//instruction lengths in bytes for each base opcode, 0 marks an invalid opcode
+//STOP is 1 as the interpreter does not consume its padding byte
+inline constexpr std::array<byte, 0x100> instruction_lengths = {
+	//0x00->0x0f
+	1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1,
+	//0x10->0x1f
+	1, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+	//0x20->0x2f
+	2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+	//0x30->0x3f
+	2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+	//0x40->0xbf
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	//0xc0->0xcf
+	1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1,
+	//0xd0->0xdf
+	1, 1, 3, 0, 3, 1, 2, 1, 1, 1, 3, 0, 3, 0, 2, 1,
+	//0xe0->0xef
+	2, 1, 1, 0, 0, 1, 2, 1, 2, 1, 3, 0, 0, 0, 2, 1,
+	//0xf0->0xff
+	2, 1, 1, 1, 0, 1, 2, 1, 2, 1, 3, 1, 0, 0, 2, 1,
+};
+
+//mnemonic, operand text, immediate type, length and cycles for every opcode, one row per cpu_instructions/cpu_cb_instructions entry
+//# in the operand text is where the immediate goes, cycles are t-cycles with conditional branches not taken, branch_cycles when taken
+struct opcode_info {
+	const char* mnemonic;
+	const char* operands;
+	opcode_operands operand;
+	byte length;
+	byte cycles;
+	byte branch_cycles;
+};
+
+inline constexpr std::array<opcode_info, 0x100> opcode_table = { {
+	{ "NOP", "", opnd_NONE, 1, 4, 0 }, //inst_NOOP
+	{ "LD", "BC, #", opnd_N16, 3, 12, 0 }, //inst_LD_BC_N16
+	{ "LD", "(BC), A", opnd_NONE, 1, 8, 0 }, //inst_LD_BC_A
+	{ "INC", "BC", opnd_NONE, 1, 8, 0 }, //inst_INC_BC
+	{ "INC", "B", opnd_NONE, 1, 4, 0 }, //inst_INC_B
+	{ "DEC", "B", opnd_NONE, 1, 4, 0 }, //inst_DEC_B
+	{ "LD", "B, #", opnd_N8, 2, 8, 0 }, //inst_LD_B_N8
+	{ "RLCA", "", opnd_NONE, 1, 4, 0 }, //inst_RLCA
+	{ "LD", "(#), SP", opnd_A16, 3, 20, 0 }, //inst_LD_N16_SP
+	{ "ADD", "HL, BC", opnd_NONE, 1, 8, 0 }, //inst_ADD_HL_BC
+	{ "LD", "A, (BC)", opnd_NONE, 1, 8, 0 }, //inst_LD_A_BC
+	{ "DEC", "BC", opnd_NONE, 1, 8, 0 }, //inst_DEC_BC
+	{ "INC", "C", opnd_NONE, 1, 4, 0 }, //inst_INC_C
+	{ "DEC", "C", opnd_NONE, 1, 4, 0 }, //inst_DEC_C
+	{ "LD", "C, #", opnd_N8, 2, 8, 0 }, //inst_LD_C_N8
+	{ "RRCA", "", opnd_NONE, 1, 4, 0 }, //inst_RRCA
+	{ "STOP", "", opnd_NONE, 1, 4, 0 }, //inst_STOP_N8
+	{ "LD", "DE, #", opnd_N16, 3, 12, 0 }, //inst_LD_DE_N16
+	{ "LD", "(DE), A", opnd_NONE, 1, 8, 0 }, //inst_LD_DE_A
+	{ "INC", "DE", opnd_NONE, 1, 8, 0 }, //inst_INC_DE
+	{ "INC", "D", opnd_NONE, 1, 4, 0 }, //inst_INC_D
+	{ "DEC", "D", opnd_NONE, 1, 4, 0 }, //inst_DEC_D
+	{ "LD", "D, #", opnd_N8, 2, 8, 0 }, //inst_LD_D_N8
+	{ "RLA", "", opnd_NONE, 1, 4, 0 }, //inst_RLA
+	{ "JR", "#", opnd_E8, 2, 12, 0 }, //inst_JR_E8
+	{ "ADD", "HL, DE", opnd_NONE, 1, 8, 0 }, //inst_ADD_HL_DE
+	{ "LD", "A, (DE)", opnd_NONE, 1, 8, 0 }, //inst_LD_A_DE
+	{ "DEC", "DE", opnd_NONE, 1, 8, 0 }, //inst_DEC_DE
+	{ "INC", "E", opnd_NONE, 1, 4, 0 }, //inst_INC_E
+	{ "DEC", "E", opnd_NONE, 1, 4, 0 }, //inst_DEC_E
+	{ "LD", "E, #", opnd_N8, 2, 8, 0 }, //inst_LD_E_N8
+	{ "RRA", "", opnd_NONE, 1, 4, 0 }, //inst_RRA
+	{ "JR", "NZ, #", opnd_E8, 2, 8, 12 }, //inst_JR_NZ_E8
+	{ "LD", "HL, #", opnd_N16, 3, 12, 0 }, //inst_LD_HL_N16
+	{ "LD", "(HL+), A", opnd_NONE, 1, 8, 0 }, //inst_LDI_HL_A
+	{ "INC", "HL", opnd_NONE, 1, 8, 0 }, //inst_INC_HL
+	{ "INC", "H", opnd_NONE, 1, 4, 0 }, //inst_INC_H
+	{ "DEC", "H", opnd_NONE, 1, 4, 0 }, //inst_DEC_H
+	{ "LD", "H, #", opnd_N8, 2, 8, 0 }, //inst_LD_H_N8
+	{ "DAA", "", opnd_NONE, 1, 4, 0 }, //inst_DAA
+	{ "JR", "Z, #", opnd_E8, 2, 8, 12 }, //inst_JR_Z_E8
+	{ "ADD", "HL, HL", opnd_NONE, 1, 8, 0 }, //inst_ADD_HL_HL
+	{ "LD", "A, (HL+)", opnd_NONE, 1, 8, 0 }, //inst_LD_A_HLI
+	{ "DEC", "HL", opnd_NONE, 1, 8, 0 }, //inst_DEC_HL
+	{ "INC", "L", opnd_NONE, 1, 4, 0 }, //inst_INC_L
+	{ "DEC", "L", opnd_NONE, 1, 4, 0 }, //inst_DEC_L
+	{ "LD", "L, #", opnd_N8, 2, 8, 0 }, //inst_LD_L_N8
+	{ "CPL", "", opnd_NONE, 1, 4, 0 }, //inst_CPL
+	{ "JR", "NC, #", opnd_E8, 2, 8, 12 }, //inst_JR_NC_E8
+	{ "LD", "SP, #", opnd_N16, 3, 12, 0 }, //inst_LD_SP_N16
+	{ "LD", "(HL-), A", opnd_NONE, 1, 8, 0 }, //inst_LDD_HL_A
+	{ "INC", "SP", opnd_NONE, 1, 8, 0 }, //inst_INC_SP
+	{ "INC", "(HL)", opnd_NONE, 1, 12, 0 }, //inst_INC_memHL
+	{ "DEC", "(HL)", opnd_NONE, 1, 12, 0 }, //inst_DEC_memHL
+	{ "LD", "(HL), #", opnd_N8, 2, 12, 0 }, //inst_LD_HL_N8
+	{ "SCF", "", opnd_NONE, 1, 4, 0 }, //inst_SCF
+	{ "JR", "C, #", opnd_E8, 2, 8, 12 }, //inst_JR_C_E8
+	{ "ADD", "HL, SP", opnd_NONE, 1, 8, 0 }, //inst_ADD_HL_SP
+	{ "LD", "A, (HL-)", opnd_NONE, 1, 8, 0 }, //inst_LD_A_HLD
+	{ "DEC", "SP", opnd_NONE, 1, 8, 0 }, //inst_DEC_SP
+	{ "INC", "A", opnd_NONE, 1, 4, 0 }, //inst_INC_A
+	{ "DEC", "A", opnd_NONE, 1, 4, 0 }, //inst_DEC_A
+	{ "LD", "A, #", opnd_N8, 2, 8, 0 }, //inst_LD_A_N8
+	{ "CCF", "", opnd_NONE, 1, 4, 0 }, //inst_CCF
+	{ "LD", "B, B", opnd_NONE, 1, 4, 0 }, //inst_LD_B_B
+	{ "LD", "B, C", opnd_NONE, 1, 4, 0 }, //inst_LD_B_C
+	{ "LD", "B, D", opnd_NONE, 1, 4, 0 }, //inst_LD_B_D
+	{ "LD", "B, E", opnd_NONE, 1, 4, 0 }, //inst_LD_B_E
+	{ "LD", "B, H", opnd_NONE, 1, 4, 0 }, //inst_LD_B_H
+	{ "LD", "B, L", opnd_NONE, 1, 4, 0 }, //inst_LD_B_L
+	{ "LD", "B, (HL)", opnd_NONE, 1, 8, 0 }, //inst_LD_B_HL
+	{ "LD", "B, A", opnd_NONE, 1, 4, 0 }, //inst_LD_B_A
+	{ "LD", "C, B", opnd_NONE, 1, 4, 0 }, //inst_LD_C_B
+	{ "LD", "C, C", opnd_NONE, 1, 4, 0 }, //inst_LD_C_C
+	{ "LD", "C, D", opnd_NONE, 1, 4, 0 }, //inst_LD_C_D
+	{ "LD", "C, E", opnd_NONE, 1, 4, 0 }, //inst_LD_C_E
+	{ "LD", "C, H", opnd_NONE, 1, 4, 0 }, //inst_LD_C_H
+	{ "LD", "C, L", opnd_NONE, 1, 4, 0 }, //inst_LD_C_L
+	{ "LD", "C, (HL)", opnd_NONE, 1, 8, 0 }, //inst_LD_C_HL
+	{ "LD", "C, A", opnd_NONE, 1, 4, 0 }, //inst_LD_C_A
+	{ "LD", "D, B", opnd_NONE, 1, 4, 0 }, //inst_LD_D_B
+	{ "LD", "D, C", opnd_NONE, 1, 4, 0 }, //inst_LD_D_C
+	{ "LD", "D, D", opnd_NONE, 1, 4, 0 }, //inst_LD_D_D
+	{ "LD", "D, E", opnd_NONE, 1, 4, 0 }, //inst_LD_D_E
+	{ "LD", "D, H", opnd_NONE, 1, 4, 0 }, //inst_LD_D_H
+	{ "LD", "D, L", opnd_NONE, 1, 4, 0 }, //inst_LD_D_L
+	{ "LD", "D, (HL)", opnd_NONE, 1, 8, 0 }, //inst_LD_D_HL
+	{ "LD", "D, A", opnd_NONE, 1, 4, 0 }, //inst_LD_D_A
+	{ "LD", "E, B", opnd_NONE, 1, 4, 0 }, //inst_LD_E_B
+	{ "LD", "E, C", opnd_NONE, 1, 4, 0 }, //inst_LD_E_C
+	{ "LD", "E, D", opnd_NONE, 1, 4, 0 }, //inst_LD_E_D
+	{ "LD", "E, E", opnd_NONE, 1, 4, 0 }, //inst_LD_E_E
+	{ "LD", "E, H", opnd_NONE, 1, 4, 0 }, //inst_LD_E_H
+	{ "LD", "E, L", opnd_NONE, 1, 4, 0 }, //inst_LD_E_L
+	{ "LD", "E, (HL)", opnd_NONE, 1, 8, 0 }, //inst_LD_E_HL
+	{ "LD", "E, A", opnd_NONE, 1, 4, 0 }, //inst_LD_E_A
+	{ "LD", "H, B", opnd_NONE, 1, 4, 0 }, //inst_LD_H_B
+	{ "LD", "H, C", opnd_NONE, 1, 4, 0 }, //inst_LD_H_C
+	{ "LD", "H, D", opnd_NONE, 1, 4, 0 }, //inst_LD_H_D
+	{ "LD", "H, E", opnd_NONE, 1, 4, 0 }, //inst_LD_H_E
+	{ "LD", "H, H", opnd_NONE, 1, 4, 0 }, //inst_LD_H_H
+	{ "LD", "H, L", opnd_NONE, 1, 4, 0 }, //inst_LD_H_L
+	{ "LD", "H, (HL)", opnd_NONE, 1, 8, 0 }, //inst_LD_H_HL
+	{ "LD", "H, A", opnd_NONE, 1, 4, 0 }, //inst_LD_H_A
+	{ "LD", "L, B", opnd_NONE, 1, 4, 0 }, //inst_LD_L_B
+	{ "LD", "L, C", opnd_NONE, 1, 4, 0 }, //inst_LD_L_C
+	{ "LD", "L, D", opnd_NONE, 1, 4, 0 }, //inst_LD_L_D
+	{ "LD", "L, E", opnd_NONE, 1, 4, 0 }, //inst_LD_L_E
+	{ "LD", "L, H", opnd_NONE, 1, 4, 0 }, //inst_LD_L_H
+	{ "LD", "L, L", opnd_NONE, 1, 4, 0 }, //inst_LD_L_L
+	{ "LD", "L, (HL)", opnd_NONE, 1, 8, 0 }, //inst_LD_L_HL
+	{ "LD", "L, A", opnd_NONE, 1, 4, 0 }, //inst_LD_L_A
+	{ "LD", "(HL), B", opnd_NONE, 1, 8, 0 }, //inst_LD_HL_B
+	{ "LD", "(HL), C", opnd_NONE, 1, 8, 0 }, //inst_LD_HL_C
+	{ "LD", "(HL), D", opnd_NONE, 1, 8, 0 }, //inst_LD_HL_D
+	{ "LD", "(HL), E", opnd_NONE, 1, 8, 0 }, //inst_LD_HL_E
+	{ "LD", "(HL), H", opnd_NONE, 1, 8, 0 }, //inst_LD_HL_H
+	{ "LD", "(HL), L", opnd_NONE, 1, 8, 0 }, //inst_LD_HL_L
+	{ "HALT", "", opnd_NONE, 1, 4, 0 }, //inst_HALT
+	{ "LD", "(HL), A", opnd_NONE, 1, 8, 0 }, //inst_LD_HL_A
+	{ "LD", "A, B", opnd_NONE, 1, 4, 0 }, //inst_LD_A_B
+	{ "LD", "A, C", opnd_NONE, 1, 4, 0 }, //inst_LD_A_C
+	{ "LD", "A, D", opnd_NONE, 1, 4, 0 }, //inst_LD_A_D
+	{ "LD", "A, E", opnd_NONE, 1, 4, 0 }, //inst_LD_A_E
+	{ "LD", "A, H", opnd_NONE, 1, 4, 0 }, //inst_LD_A_H
+	{ "LD", "A, L", opnd_NONE, 1, 4, 0 }, //inst_LD_A_L
+	{ "LD", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_LD_A_HL
+	{ "LD", "A, A", opnd_NONE, 1, 4, 0 }, //inst_LD_A_A
+	{ "ADD", "A, B", opnd_NONE, 1, 4, 0 }, //inst_ADD_A_B
+	{ "ADD", "A, C", opnd_NONE, 1, 4, 0 }, //inst_ADD_A_C
+	{ "ADD", "A, D", opnd_NONE, 1, 4, 0 }, //inst_ADD_A_D
+	{ "ADD", "A, E", opnd_NONE, 1, 4, 0 }, //inst_ADD_A_E
+	{ "ADD", "A, H", opnd_NONE, 1, 4, 0 }, //inst_ADD_A_H
+	{ "ADD", "A, L", opnd_NONE, 1, 4, 0 }, //inst_ADD_A_L
+	{ "ADD", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_ADD_A_HL
+	{ "ADD", "A, A", opnd_NONE, 1, 4, 0 }, //inst_ADD_A_A
+	{ "ADC", "A, B", opnd_NONE, 1, 4, 0 }, //inst_ADC_A_B
+	{ "ADC", "A, C", opnd_NONE, 1, 4, 0 }, //inst_ADC_A_C
+	{ "ADC", "A, D", opnd_NONE, 1, 4, 0 }, //inst_ADC_A_D
+	{ "ADC", "A, E", opnd_NONE, 1, 4, 0 }, //inst_ADC_A_E
+	{ "ADC", "A, H", opnd_NONE, 1, 4, 0 }, //inst_ADC_A_H
+	{ "ADC", "A, L", opnd_NONE, 1, 4, 0 }, //inst_ADC_A_L
+	{ "ADC", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_ADC_A_HL
+	{ "ADC", "A, A", opnd_NONE, 1, 4, 0 }, //inst_ADC_A_A
+	{ "SUB", "A, B", opnd_NONE, 1, 4, 0 }, //inst_SUB_A_B
+	{ "SUB", "A, C", opnd_NONE, 1, 4, 0 }, //inst_SUB_A_C
+	{ "SUB", "A, D", opnd_NONE, 1, 4, 0 }, //inst_SUB_A_D
+	{ "SUB", "A, E", opnd_NONE, 1, 4, 0 }, //inst_SUB_A_E
+	{ "SUB", "A, H", opnd_NONE, 1, 4, 0 }, //inst_SUB_A_H
+	{ "SUB", "A, L", opnd_NONE, 1, 4, 0 }, //inst_SUB_A_L
+	{ "SUB", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_SUB_A_HL
+	{ "SUB", "A, A", opnd_NONE, 1, 4, 0 }, //inst_SUB_A_A
+	{ "SBC", "A, B", opnd_NONE, 1, 4, 0 }, //inst_SBC_A_B
+	{ "SBC", "A, C", opnd_NONE, 1, 4, 0 }, //inst_SBC_A_C
+	{ "SBC", "A, D", opnd_NONE, 1, 4, 0 }, //inst_SBC_A_D
+	{ "SBC", "A, E", opnd_NONE, 1, 4, 0 }, //inst_SBC_A_E
+	{ "SBC", "A, H", opnd_NONE, 1, 4, 0 }, //inst_SBC_A_H
+	{ "SBC", "A, L", opnd_NONE, 1, 4, 0 }, //inst_SBC_A_L
+	{ "SBC", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_SBC_A_HL
+	{ "SBC", "A, A", opnd_NONE, 1, 4, 0 }, //inst_SBC_A_A
+	{ "AND", "A, B", opnd_NONE, 1, 4, 0 }, //inst_AND_A_B
+	{ "AND", "A, C", opnd_NONE, 1, 4, 0 }, //inst_AND_A_C
+	{ "AND", "A, D", opnd_NONE, 1, 4, 0 }, //inst_AND_A_D
+	{ "AND", "A, E", opnd_NONE, 1, 4, 0 }, //inst_AND_A_E
+	{ "AND", "A, H", opnd_NONE, 1, 4, 0 }, //inst_AND_A_H
+	{ "AND", "A, L", opnd_NONE, 1, 4, 0 }, //inst_AND_A_L
+	{ "AND", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_AND_A_HL
+	{ "AND", "A, A", opnd_NONE, 1, 4, 0 }, //inst_AND_A_A
+	{ "XOR", "A, B", opnd_NONE, 1, 4, 0 }, //inst_XOR_A_B
+	{ "XOR", "A, C", opnd_NONE, 1, 4, 0 }, //inst_XOR_A_C
+	{ "XOR", "A, D", opnd_NONE, 1, 4, 0 }, //inst_XOR_A_D
+	{ "XOR", "A, E", opnd_NONE, 1, 4, 0 }, //inst_XOR_A_E
+	{ "XOR", "A, H", opnd_NONE, 1, 4, 0 }, //inst_XOR_A_H
+	{ "XOR", "A, L", opnd_NONE, 1, 4, 0 }, //inst_XOR_A_L
+	{ "XOR", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_XOR_A_HL
+	{ "XOR", "A, A", opnd_NONE, 1, 4, 0 }, //inst_XOR_A_A
+	{ "OR", "A, B", opnd_NONE, 1, 4, 0 }, //inst_OR_A_B
+	{ "OR", "A, C", opnd_NONE, 1, 4, 0 }, //inst_OR_A_C
+	{ "OR", "A, D", opnd_NONE, 1, 4, 0 }, //inst_OR_A_D
+	{ "OR", "A, E", opnd_NONE, 1, 4, 0 }, //inst_OR_A_E
+	{ "OR", "A, H", opnd_NONE, 1, 4, 0 }, //inst_OR_A_H
+	{ "OR", "A, L", opnd_NONE, 1, 4, 0 }, //inst_OR_A_L
+	{ "OR", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_OR_A_HL
+	{ "OR", "A, A", opnd_NONE, 1, 4, 0 }, //inst_OR_A_A
+	{ "CP", "A, B", opnd_NONE, 1, 4, 0 }, //inst_CP_A_B
+	{ "CP", "A, C", opnd_NONE, 1, 4, 0 }, //inst_CP_A_C
+	{ "CP", "A, D", opnd_NONE, 1, 4, 0 }, //inst_CP_A_D
+	{ "CP", "A, E", opnd_NONE, 1, 4, 0 }, //inst_CP_A_E
+	{ "CP", "A, H", opnd_NONE, 1, 4, 0 }, //inst_CP_A_H
+	{ "CP", "A, L", opnd_NONE, 1, 4, 0 }, //inst_CP_A_L
+	{ "CP", "A, (HL)", opnd_NONE, 1, 8, 0 }, //inst_CP_A_HL
+	{ "CP", "A, A", opnd_NONE, 1, 4, 0 }, //inst_CP_A_A
+	{ "RET", "NZ", opnd_NONE, 1, 8, 20 }, //inst_RET_NZ
+	{ "POP", "BC", opnd_NONE, 1, 12, 0 }, //inst_POP_BC
+	{ "JP", "NZ, #", opnd_A16, 3, 12, 16 }, //inst_JP_NZ_N16
+	{ "JP", "#", opnd_A16, 3, 16, 0 }, //inst_JP_N16
+	{ "CALL", "NZ, #", opnd_A16, 3, 12, 24 }, //inst_CALL_NZ_N16
+	{ "PUSH", "BC", opnd_NONE, 1, 16, 0 }, //inst_PUSH_BC
+	{ "ADD", "A, #", opnd_N8, 2, 8, 0 }, //inst_ADD_A_N8
+	{ "RST", "00H", opnd_NONE, 1, 16, 0 }, //inst_RST_00
+	{ "RET", "Z", opnd_NONE, 1, 8, 20 }, //inst_RET_Z
+	{ "RET", "", opnd_NONE, 1, 16, 0 }, //inst_RET
+	{ "JP", "Z, #", opnd_A16, 3, 12, 16 }, //inst_JP_Z_N16
+	{ "PREFIX", "CB", opnd_NONE, 2, 4, 0 }, //inst_CB
+	{ "CALL", "Z, #", opnd_A16, 3, 12, 24 }, //inst_CALL_Z_N16
+	{ "CALL", "#", opnd_A16, 3, 24, 0 }, //inst_CALL_N16
+	{ "ADC", "A, #", opnd_N8, 2, 8, 0 }, //inst_ADC_A_N8
+	{ "RST", "08H", opnd_NONE, 1, 16, 0 }, //inst_RST_08
+	{ "RET", "NC", opnd_NONE, 1, 8, 20 }, //inst_RET_NC
+	{ "POP", "DE", opnd_NONE, 1, 12, 0 }, //inst_POP_DE
+	{ "JP", "NC, #", opnd_A16, 3, 12, 16 }, //inst_JP_NC_N16
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xd3 invalid
+	{ "CALL", "NC, #", opnd_A16, 3, 12, 24 }, //inst_CALL_NC_N16
+	{ "PUSH", "DE", opnd_NONE, 1, 16, 0 }, //inst_PUSH_DE
+	{ "SUB", "A, #", opnd_N8, 2, 8, 0 }, //inst_SUB_A_N8
+	{ "RST", "10H", opnd_NONE, 1, 16, 0 }, //inst_RST_10
+	{ "RET", "C", opnd_NONE, 1, 8, 20 }, //inst_RET_C
+	{ "RETI", "", opnd_NONE, 1, 16, 0 }, //inst_RETI
+	{ "JP", "C, #", opnd_A16, 3, 12, 16 }, //inst_JP_C_N16
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xdb invalid
+	{ "CALL", "C, #", opnd_A16, 3, 12, 24 }, //inst_CALL_C_N16
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xdd invalid
+	{ "SBC", "A, #", opnd_N8, 2, 8, 0 }, //inst_SBC_A_N8
+	{ "RST", "18H", opnd_NONE, 1, 16, 0 }, //inst_RST_18
+	{ "LDH", "(#), A", opnd_A8, 2, 12, 0 }, //inst_LDH_N8_A
+	{ "POP", "HL", opnd_NONE, 1, 12, 0 }, //inst_POP_HL
+	{ "LD", "(C), A", opnd_NONE, 1, 8, 0 }, //inst_LDH_C_A
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xe3 invalid
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xe4 invalid
+	{ "PUSH", "HL", opnd_NONE, 1, 16, 0 }, //inst_PUSH_HL
+	{ "AND", "A, #", opnd_N8, 2, 8, 0 }, //inst_AND_A_N8
+	{ "RST", "20H", opnd_NONE, 1, 16, 0 }, //inst_RST_20
+	{ "ADD", "SP, #", opnd_E8_SIGNED, 2, 16, 0 }, //inst_ADD_SP_E8
+	{ "JP", "HL", opnd_NONE, 1, 4, 0 }, //inst_JP_HL
+	{ "LD", "(#), A", opnd_A16, 3, 16, 0 }, //inst_LD_N16_A
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xeb invalid
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xec invalid
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xed invalid
+	{ "XOR", "A, #", opnd_N8, 2, 8, 0 }, //inst_XOR_A_N8
+	{ "RST", "28H", opnd_NONE, 1, 16, 0 }, //inst_RST_28
+	{ "LDH", "A, (#)", opnd_A8, 2, 12, 0 }, //inst_LDH_A_N8
+	{ "POP", "AF", opnd_NONE, 1, 12, 0 }, //inst_POP_AF
+	{ "LD", "A, (C)", opnd_NONE, 1, 8, 0 }, //inst_LDH_A_C
+	{ "DI", "", opnd_NONE, 1, 4, 0 }, //inst_DI
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xf4 invalid
+	{ "PUSH", "AF", opnd_NONE, 1, 16, 0 }, //inst_PUSH_AF
+	{ "OR", "A, #", opnd_N8, 2, 8, 0 }, //inst_OR_A_N8
+	{ "RST", "30H", opnd_NONE, 1, 16, 0 }, //inst_RST_30
+	{ "LD", "HL, SP#", opnd_E8_SIGNED, 2, 12, 0 }, //inst_LD_HL_SP_E8
+	{ "LD", "SP, HL", opnd_NONE, 1, 8, 0 }, //inst_LD_SP_HL
+	{ "LD", "A, (#)", opnd_A16, 3, 16, 0 }, //inst_LD_A_N16
+	{ "EI", "", opnd_NONE, 1, 4, 0 }, //inst_EI
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xfc invalid
+	{ "???", "", opnd_NONE, 0, 0, 0 }, //0xfd invalid
+	{ "CP", "A, #", opnd_N8, 2, 8, 0 }, //inst_CP_A_N8
+	{ "RST", "38H", opnd_NONE, 1, 16, 0 }, //inst_RST_38
+} };
+
+//cycles include the 0xcb prefix
+inline constexpr std::array<opcode_info, 0x100> cb_opcode_table = { {
+	{ "RLC", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_RLC_B
+	{ "RLC", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_RLC_C
+	{ "RLC", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_RLC_D
+	{ "RLC", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_RLC_E
+	{ "RLC", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_RLC_H
+	{ "RLC", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_RLC_L
+	{ "RLC", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RLC_HL
+	{ "RLC", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_RLC_A
+	{ "RRC", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_RRC_B
+	{ "RRC", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_RRC_C
+	{ "RRC", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_RRC_D
+	{ "RRC", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_RRC_E
+	{ "RRC", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_RRC_H
+	{ "RRC", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_RRC_L
+	{ "RRC", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RRC_HL
+	{ "RRC", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_RRC_A
+	{ "RL", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_RL_B
+	{ "RL", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_RL_C
+	{ "RL", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_RL_D
+	{ "RL", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_RL_E
+	{ "RL", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_RL_H
+	{ "RL", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_RL_L
+	{ "RL", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RL_HL
+	{ "RL", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_RL_A
+	{ "RR", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_RR_B
+	{ "RR", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_RR_C
+	{ "RR", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_RR_D
+	{ "RR", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_RR_E
+	{ "RR", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_RR_H
+	{ "RR", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_RR_L
+	{ "RR", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RR_HL
+	{ "RR", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_RR_A
+	{ "SLA", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_SLA_B
+	{ "SLA", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_SLA_C
+	{ "SLA", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_SLA_D
+	{ "SLA", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_SLA_E
+	{ "SLA", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_SLA_H
+	{ "SLA", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_SLA_L
+	{ "SLA", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SLA_HL
+	{ "SLA", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_SLA_A
+	{ "SRA", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_SRA_B
+	{ "SRA", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_SRA_C
+	{ "SRA", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_SRA_D
+	{ "SRA", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_SRA_E
+	{ "SRA", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_SRA_H
+	{ "SRA", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_SRA_L
+	{ "SRA", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SRA_HL
+	{ "SRA", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_SRA_A
+	{ "SWAP", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_SWAP_B
+	{ "SWAP", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_SWAP_C
+	{ "SWAP", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_SWAP_D
+	{ "SWAP", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_SWAP_E
+	{ "SWAP", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_SWAP_H
+	{ "SWAP", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_SWAP_L
+	{ "SWAP", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SWAP_HL
+	{ "SWAP", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_SWAP_A
+	{ "SRL", "B", opnd_NONE, 2, 8, 0 }, //inst_cb_SRL_B
+	{ "SRL", "C", opnd_NONE, 2, 8, 0 }, //inst_cb_SRL_C
+	{ "SRL", "D", opnd_NONE, 2, 8, 0 }, //inst_cb_SRL_D
+	{ "SRL", "E", opnd_NONE, 2, 8, 0 }, //inst_cb_SRL_E
+	{ "SRL", "H", opnd_NONE, 2, 8, 0 }, //inst_cb_SRL_H
+	{ "SRL", "L", opnd_NONE, 2, 8, 0 }, //inst_cb_SRL_L
+	{ "SRL", "(HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SRL_HL
+	{ "SRL", "A", opnd_NONE, 2, 8, 0 }, //inst_cb_SRL_A
+	{ "BIT", "0, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_0_B
+	{ "BIT", "0, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_0_C
+	{ "BIT", "0, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_0_D
+	{ "BIT", "0, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_0_E
+	{ "BIT", "0, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_0_H
+	{ "BIT", "0, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_0_L
+	{ "BIT", "0, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_0_HL
+	{ "BIT", "0, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_0_A
+	{ "BIT", "1, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_1_B
+	{ "BIT", "1, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_1_C
+	{ "BIT", "1, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_1_D
+	{ "BIT", "1, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_1_E
+	{ "BIT", "1, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_1_H
+	{ "BIT", "1, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_1_L
+	{ "BIT", "1, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_1_HL
+	{ "BIT", "1, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_1_A
+	{ "BIT", "2, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_2_B
+	{ "BIT", "2, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_2_C
+	{ "BIT", "2, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_2_D
+	{ "BIT", "2, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_2_E
+	{ "BIT", "2, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_2_H
+	{ "BIT", "2, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_2_L
+	{ "BIT", "2, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_2_HL
+	{ "BIT", "2, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_2_A
+	{ "BIT", "3, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_3_B
+	{ "BIT", "3, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_3_C
+	{ "BIT", "3, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_3_D
+	{ "BIT", "3, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_3_E
+	{ "BIT", "3, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_3_H
+	{ "BIT", "3, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_3_L
+	{ "BIT", "3, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_3_HL
+	{ "BIT", "3, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_3_A
+	{ "BIT", "4, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_4_B
+	{ "BIT", "4, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_4_C
+	{ "BIT", "4, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_4_D
+	{ "BIT", "4, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_4_E
+	{ "BIT", "4, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_4_H
+	{ "BIT", "4, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_4_L
+	{ "BIT", "4, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_4_HL
+	{ "BIT", "4, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_4_A
+	{ "BIT", "5, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_5_B
+	{ "BIT", "5, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_5_C
+	{ "BIT", "5, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_5_D
+	{ "BIT", "5, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_5_E
+	{ "BIT", "5, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_5_H
+	{ "BIT", "5, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_5_L
+	{ "BIT", "5, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_5_HL
+	{ "BIT", "5, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_5_A
+	{ "BIT", "6, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_6_B
+	{ "BIT", "6, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_6_C
+	{ "BIT", "6, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_6_D
+	{ "BIT", "6, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_6_E
+	{ "BIT", "6, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_6_H
+	{ "BIT", "6, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_6_L
+	{ "BIT", "6, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_6_HL
+	{ "BIT", "6, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_6_A
+	{ "BIT", "7, B", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_7_B
+	{ "BIT", "7, C", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_7_C
+	{ "BIT", "7, D", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_7_D
+	{ "BIT", "7, E", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_7_E
+	{ "BIT", "7, H", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_7_H
+	{ "BIT", "7, L", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_7_L
+	{ "BIT", "7, (HL)", opnd_NONE, 2, 12, 0 }, //inst_cb_BIT_7_HL
+	{ "BIT", "7, A", opnd_NONE, 2, 8, 0 }, //inst_cb_BIT_7_A
+	{ "RES", "0, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_0_B
+	{ "RES", "0, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_0_C
+	{ "RES", "0, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_0_D
+	{ "RES", "0, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_0_E
+	{ "RES", "0, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_0_H
+	{ "RES", "0, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_0_L
+	{ "RES", "0, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_0_HL
+	{ "RES", "0, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_0_A
+	{ "RES", "1, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_1_B
+	{ "RES", "1, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_1_C
+	{ "RES", "1, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_1_D
+	{ "RES", "1, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_1_E
+	{ "RES", "1, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_1_H
+	{ "RES", "1, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_1_L
+	{ "RES", "1, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_1_HL
+	{ "RES", "1, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_1_A
+	{ "RES", "2, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_2_B
+	{ "RES", "2, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_2_C
+	{ "RES", "2, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_2_D
+	{ "RES", "2, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_2_E
+	{ "RES", "2, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_2_H
+	{ "RES", "2, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_2_L
+	{ "RES", "2, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_2_HL
+	{ "RES", "2, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_2_A
+	{ "RES", "3, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_3_B
+	{ "RES", "3, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_3_C
+	{ "RES", "3, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_3_D
+	{ "RES", "3, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_3_E
+	{ "RES", "3, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_3_H
+	{ "RES", "3, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_3_L
+	{ "RES", "3, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_3_HL
+	{ "RES", "3, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_3_A
+	{ "RES", "4, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_4_B
+	{ "RES", "4, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_4_C
+	{ "RES", "4, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_4_D
+	{ "RES", "4, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_4_E
+	{ "RES", "4, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_4_H
+	{ "RES", "4, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_4_L
+	{ "RES", "4, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_4_HL
+	{ "RES", "4, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_4_A
+	{ "RES", "5, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_5_B
+	{ "RES", "5, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_5_C
+	{ "RES", "5, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_5_D
+	{ "RES", "5, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_5_E
+	{ "RES", "5, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_5_H
+	{ "RES", "5, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_5_L
+	{ "RES", "5, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_5_HL
+	{ "RES", "5, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_5_A
+	{ "RES", "6, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_6_B
+	{ "RES", "6, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_6_C
+	{ "RES", "6, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_6_D
+	{ "RES", "6, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_6_E
+	{ "RES", "6, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_6_H
+	{ "RES", "6, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_6_L
+	{ "RES", "6, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_6_HL
+	{ "RES", "6, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_6_A
+	{ "RES", "7, B", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_7_B
+	{ "RES", "7, C", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_7_C
+	{ "RES", "7, D", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_7_D
+	{ "RES", "7, E", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_7_E
+	{ "RES", "7, H", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_7_H
+	{ "RES", "7, L", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_7_L
+	{ "RES", "7, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_RES_7_HL
+	{ "RES", "7, A", opnd_NONE, 2, 8, 0 }, //inst_cb_RES_7_A
+	{ "SET", "0, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_0_B
+	{ "SET", "0, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_0_C
+	{ "SET", "0, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_0_D
+	{ "SET", "0, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_0_E
+	{ "SET", "0, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_0_H
+	{ "SET", "0, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_0_L
+	{ "SET", "0, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_0_HL
+	{ "SET", "0, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_0_A
+	{ "SET", "1, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_1_B
+	{ "SET", "1, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_1_C
+	{ "SET", "1, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_1_D
+	{ "SET", "1, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_1_E
+	{ "SET", "1, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_1_H
+	{ "SET", "1, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_1_L
+	{ "SET", "1, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_1_HL
+	{ "SET", "1, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_1_A
+	{ "SET", "2, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_2_B
+	{ "SET", "2, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_2_C
+	{ "SET", "2, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_2_D
+	{ "SET", "2, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_2_E
+	{ "SET", "2, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_2_H
+	{ "SET", "2, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_2_L
+	{ "SET", "2, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_2_HL
+	{ "SET", "2, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_2_A
+	{ "SET", "3, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_3_B
+	{ "SET", "3, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_3_C
+	{ "SET", "3, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_3_D
+	{ "SET", "3, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_3_E
+	{ "SET", "3, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_3_H
+	{ "SET", "3, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_3_L
+	{ "SET", "3, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_3_HL
+	{ "SET", "3, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_3_A
+	{ "SET", "4, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_4_B
+	{ "SET", "4, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_4_C
+	{ "SET", "4, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_4_D
+	{ "SET", "4, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_4_E
+	{ "SET", "4, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_4_H
+	{ "SET", "4, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_4_L
+	{ "SET", "4, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_4_HL
+	{ "SET", "4, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_4_A
+	{ "SET", "5, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_5_B
+	{ "SET", "5, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_5_C
+	{ "SET", "5, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_5_D
+	{ "SET", "5, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_5_E
+	{ "SET", "5, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_5_H
+	{ "SET", "5, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_5_L
+	{ "SET", "5, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_5_HL
+	{ "SET", "5, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_5_A
+	{ "SET", "6, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_6_B
+	{ "SET", "6, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_6_C
+	{ "SET", "6, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_6_D
+	{ "SET", "6, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_6_E
+	{ "SET", "6, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_6_H
+	{ "SET", "6, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_6_L
+	{ "SET", "6, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_6_HL
+	{ "SET", "6, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_6_A
+	{ "SET", "7, B", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_7_B
+	{ "SET", "7, C", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_7_C
+	{ "SET", "7, D", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_7_D
+	{ "SET", "7, E", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_7_E
+	{ "SET", "7, H", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_7_H
+	{ "SET", "7, L", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_7_L
+	{ "SET", "7, (HL)", opnd_NONE, 2, 16, 0 }, //inst_cb_SET_7_HL
+	{ "SET", "7, A", opnd_NONE, 2, 8, 0 }, //inst_cb_SET_7_A
+} };
+
+constexpr bool opcode_table_matches_lengths() {
+	for (int i = 0; i < 0x100; i++) {
+		if (opcode_table[i].length != instruction_lengths[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static_assert(opcode_table_matches_lengths(), "opcode_table and instruction_lengths disagree");
+
+//instructions that leave straight line execution, they close a cached block
+inline bool ends_cached_block(const byte& opcode) {
+	switch (opcode) {
+	case inst_STOP_N8:
+	case inst_HALT:
+	case inst_JR_E8: case inst_JR_NZ_E8: case inst_JR_Z_E8: case inst_JR_NC_E8: case inst_JR_C_E8:
+	case inst_JP_N16: case inst_JP_NZ_N16: case inst_JP_Z_N16: case inst_JP_NC_N16: case inst_JP_C_N16: case inst_JP_HL:
+	case inst_CALL_N16: case inst_CALL_NZ_N16: case inst_CALL_Z_N16: case inst_CALL_NC_N16: case inst_CALL_C_N16:
+	case inst_RET: case inst_RET_NZ: case inst_RET_Z: case inst_RET_NC: case inst_RET_C: case inst_RETI:
+	case inst_RST_00: case inst_RST_08: case inst_RST_10: case inst_RST_18:
+	case inst_RST_20: case inst_RST_28: case inst_RST_30: case inst_RST_38:
+		return true;
+
+	default:
+		return false;
+	}
+}
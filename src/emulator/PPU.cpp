@@ -1,14 +1,10 @@
 #include "PPU.h"
 #include "Emulator.h"
+#include "Timeline_trace.h"
+#include <algorithm>
+#include <cstring>
 
 PPU::PPU(std::shared_ptr<Emulator> emulator_ptr) {
-    gb_colors = std::array<uint32_t, 4>{
-            0xffffffff,
-            0xd3d3d3ff,
-            0x222222ff,
-            0x000000ff
-    };
-        
 	this->emulator_ptr = emulator_ptr;
 	if (this->emulator_ptr != nullptr) {
 		initialised = true;
@@ -28,6 +24,8 @@ PPU::~PPU() {
 
 void PPU::reset_ppu() {
     bool using_boot_rom = emulator_ptr->is_using_boot_rom();
+    invalidate_tile_cache();
+    mark_frame_dirty();
 
     lcdc = 0x00;
     stat = 0x00;
@@ -57,6 +55,26 @@ bool PPU::is_ppu_initialised() {
 }
 
 void PPU::ppu_tick() {
+    ppu_modes previous_mode = current_mode;
+    update_ppu();
+
+    if (current_mode != previous_mode && timeline_is_recording()) {
+        trace_mode_change();
+    }
+}
+
+//guest side markers on the timeline's guest track, one per mode entered with the line it was entered on
+void PPU::trace_mode_change() {
+    switch (current_mode) {
+    case ppu_OAM_SEARCH: timeline_add_guest_instant("OAM Search", "ppu", "ly", ly); return;
+    case ppu_DRAW_MODE: timeline_add_guest_instant("Draw", "ppu", "ly", ly); return;
+    case ppu_HBLANK: timeline_add_guest_instant("HBlank", "ppu", "ly", ly); return;
+    case ppu_VBLANK: timeline_add_guest_instant("VBlank", "ppu", "ly", ly); return;
+    default: return;
+    }
+}
+
+void PPU::update_ppu() {
     internal_cycles++;
 
     // Handle LCD enable/disable
@@ -72,6 +90,8 @@ void PPU::ppu_tick() {
         if (!lcd_previously_off) {
             // LCD just turned off - reset state
             ly = 0;
+            window_line = 0;
+            window_y_reached = false;
             current_mode = ppu_HBLANK;
             stat = (stat & 0xFC) | current_mode;
             blocked_vram = true;
@@ -95,22 +115,34 @@ void PPU::ppu_tick() {
     switch (current_mode) {
     case ppu_OAM_SEARCH:
         if (internal_cycles == 80) {
+            scan_oam();
             current_mode = ppu_DRAW_MODE;
 
+            //every line starts a fresh fetch, a half done one from the last line would carry its tile over
             clear_fifo(bg_fifo_queue);
+            current_bg_fifo_state = fifo_FETCH_TILE_NUMBER;
+            fifo_ticks = 0;
             onscreen_x = 0;
             bg_fifo_x = 0;
             primed_fifo = false;
+            setup_window_line();
 
             stat = (stat & 0xFC) | current_mode;
         }
         return;
 
     case ppu_DRAW_MODE:
-        bg_fetcher_tick();
-        output_bg_pixel();        
+        //sprites stall the fetcher, here the dots they cost are spent once the line is out
+        if (onscreen_x < SCREEN_WIDTH) {
+            bg_fetcher_tick();
+            output_bg_pixel();
+        }
+        else if (draw_penalty > 0) {
+            draw_penalty--;
+        }
 
-        if (onscreen_x >= SCREEN_WIDTH) {
+        if (onscreen_x >= SCREEN_WIDTH && draw_penalty == 0) {
+            finish_line();
             current_mode = ppu_HBLANK; 
         }
 
@@ -121,6 +153,12 @@ void PPU::ppu_tick() {
             internal_cycles -= 456;
             ly++;
 
+            //the window's own line counter only moves on lines that drew it
+            if (fetching_window) {
+                window_line++;
+                fetching_window = false;
+            }
+
             if (ly == 144) {
                 current_mode = ppu_VBLANK;
 
@@ -153,6 +191,8 @@ void PPU::ppu_tick() {
 
             if (ly == 154) { 
                 ly = 0;
+                window_line = 0;
+                window_y_reached = false;
 
                 current_mode = ppu_OAM_SEARCH;
 
@@ -187,6 +227,12 @@ byte PPU::read_ppu_io(const byte& ppu_io) {
 }
 
 void PPU::io_instant_write(const byte& ppu_io, const byte& value) {
+    //the debug views draw through lcdc and the palettes
+    bool view_register = ppu_io == io_LCDC || ppu_io == io_BGP || ppu_io == io_OBP0 || ppu_io == io_OBP1;
+    if (view_register && read_ppu_io(ppu_io) != value) {
+        add_view_changes(view_REGISTERS);
+    }
+
     switch (ppu_io) {
     case io_LY: ly = value; return;
     case io_LYC: lyc = value; return;
@@ -207,6 +253,22 @@ ppu_modes PPU::get_current_mode() {
 	return current_mode;
 }
 
+//registers and timing, the frame buffer follows from these so it is left out
+uint64_t PPU::get_state_hash(const uint64_t& hash) {
+	const byte registers[] = { ly, stat, lyc, lcdc, scx, scy, bgp, obp0, obp1, wx, wy };
+	uint64_t state_hash = hash_state_bytes(hash, registers, sizeof(registers));
+	state_hash = hash_state_value(state_hash, internal_cycles);
+	state_hash = hash_state_value(state_hash, current_mode);
+	state_hash = hash_state_value(state_hash, current_bg_fifo_state);
+	state_hash = hash_state_value(state_hash, fifo_ticks);
+	state_hash = hash_state_value(state_hash, onscreen_x);
+	state_hash = hash_state_value(state_hash, line_sprite_count);
+	state_hash = hash_state_value(state_hash, draw_penalty);
+	state_hash = hash_state_value(state_hash, window_line);
+	state_hash = hash_state_value(state_hash, fetching_window);
+	return hash_state_value(state_hash, (ushort)bg_fifo_queue.size());
+}
+
 bool PPU::is_draw_ready() {
     return draw_ready;
 }
@@ -215,33 +277,133 @@ void PPU::reset_draw_ready() {
     draw_ready = false;
 }
 
-std::array<uint32_t, 160 * 144> PPU::get_bg_frame_buffer() {
-    return background_pixel_buffer;
+const std::array<byte, 160 * 144>& PPU::get_shade_buffer() const {
+    return shade_buffer;
+}
+
+bool PPU::take_dirty_lines(int& first_line, int& last_line) {
+    if (dirty_first_line > dirty_last_line) {
+        return false;
+    }
+
+    first_line = dirty_first_line;
+    last_line = dirty_last_line;
+    dirty_first_line = SCREEN_HEIGHT;
+    dirty_last_line = -1;
+    return true;
 }
 
-std::array<uint32_t, 64> PPU::get_next_tile(const int& index) {
-    std::array<uint32_t, 64> tile = std::array<uint32_t, 64>();
-    ushort tile_address = 0x8000 + (index * 16);
+void PPU::mark_frame_dirty() {
+    dirty_first_line = 0;
+    dirty_last_line = SCREEN_HEIGHT - 1;
+}
 
-    int count = 0;
-    for (int row = 0; row < 16; row += 2) {
-        byte low = emulator_ptr->bus_read(tile_address + row);
-        byte high = emulator_ptr->bus_read(tile_address + row + 1);
+void PPU::mark_vram_written(const ushort& address) {
+    if (address >= 0x9800) {
+        add_view_changes(address < 0x9c00 ? view_MAP_9800 : view_MAP_9C00);
+        return;
+    }
 
-        for (int bit = 7; bit >= 0; bit--) {
-            byte low_bit = (low >> bit) & 0x1;
-            byte high_bit = (high >> bit) & 0x1;
+    int index = (address - 0x8000) / 16;
+    tile_dirty[index] = true;
+    viewer_tile_dirty[index] = true;
+    viewer_tiles_pending = true;
+    add_view_changes(view_TILE_DATA);
+}
 
-            byte colour = (high_bit << 1) | low_bit;
+void PPU::mark_oam_written() {
+    add_view_changes(view_OAM);
+}
 
-            int palette_shift = colour * 2;
+void PPU::invalidate_tile_cache() {
+    tile_dirty.fill(true);
+    viewer_tile_dirty.fill(true);
+    viewer_tiles_pending = true;
+    add_view_changes(view_ALL);
+}
+
+const std::array<byte, 64>& PPU::get_decoded_tile(const int& index) {
+    if (tile_dirty[index]) {
+        decode_tile(index);
+    }
+
+    return decoded_tiles[index];
+}
+
+bool PPU::take_viewer_dirty_tiles(std::array<bool, TILE_CACHE_TILES>& dirty_tiles) {
+    //the viewer draws through bgp, a new palette changes every tile
+    if (bgp != viewer_palette) {
+        viewer_tile_dirty.fill(true);
+        viewer_tiles_pending = true;
+        viewer_palette = bgp;
+    }
+
+    if (!viewer_tiles_pending) {
+        return false;
+    }
+
+    dirty_tiles = viewer_tile_dirty;
+    viewer_tile_dirty.fill(false);
+    viewer_tiles_pending = false;
+    return true;
+}
+
+//one tile through the background palette into pixels, pitch is in pixels
+void PPU::fill_tile_pixels(const int& index, uint32_t* pixels, const int& pitch) {
+    const std::array<byte, 64>& tile = get_decoded_tile(index);
+
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            int palette_shift = tile[y * 8 + x] * 2;
             int palette_colour = (bgp >> palette_shift) & 0x03;
 
-            tile[count++] = gb_colors[palette_colour];
+            pixels[y * pitch + x] = gb_colors[palette_colour];
         }
     }
+}
+
+byte PPU::take_view_changes(const ppu_viewers& viewer) {
+    byte changes = view_changes[viewer];
+    view_changes[viewer] = view_NONE;
+    return changes;
+}
 
-    return tile;
+//256x256, map 0 at 0x9800 and map 1 at 0x9c00, tile ids read with the addressing lcdc currently selects
+void PPU::fill_map_pixels(const int& map, uint32_t* pixels) {
+    ushort map_base = map == 0 ? 0x9800 : 0x9c00;
+
+    for (int i = 0; i < 32 * 32; i++) {
+        byte tile_id = emulator_ptr->memory_instant_read((ushort)(map_base + i));
+        int index = (lcdc & 0x10) != 0 ? tile_id : 256 + (sbyte)tile_id;
+
+        fill_tile_pixels(index, pixels + (i / 32) * 8 * 256 + (i % 32) * 8, 256);
+    }
+}
+
+//one oam entry as 8x16 (lower half clear for 8x8 sprites), colour 0 is transparent
+void PPU::fill_sprite_pixels(const byte& tile, const byte& attributes, uint32_t* pixels, const int& pitch) {
+    bool tall = (lcdc & 0x04) != 0;
+    bool flip_x = (attributes & 0x20) != 0;
+    bool flip_y = (attributes & 0x40) != 0;
+    byte palette = (attributes & 0x10) != 0 ? obp1 : obp0;
+    int height = tall ? 16 : 8;
+
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 8; x++) {
+            pixels[y * pitch + x] = 0x00000000;
+            if (y >= height) {
+                continue;
+            }
+
+            int sprite_y = flip_y ? height - 1 - y : y;
+            int sprite_x = flip_x ? 7 - x : x;
+            int index = tall ? ((tile & 0xfe) + sprite_y / 8) : tile;
+            byte colour = get_decoded_tile(index)[(sprite_y % 8) * 8 + sprite_x];
+            if (colour != 0) {
+                pixels[y * pitch + x] = gb_colors[(palette >> (colour * 2)) & 0x03];
+            }
+        }
+    }
 }
 
 ushort PPU::get_tile_address_from_id(const byte& tile_id)  {
@@ -259,6 +421,31 @@ ushort PPU::get_tile_address_from_id(const byte& tile_id)  {
     return tile_address;
 }
 
+void PPU::decode_tile(const int& index) {
+    ushort tile_address = (ushort)(0x8000 + index * 16);
+    std::array<byte, 64>& tile = decoded_tiles[index];
+
+    for (int row = 0; row < 8; row++) {
+        byte low = emulator_ptr->memory_instant_read(tile_address + row * 2);
+        byte high = emulator_ptr->memory_instant_read(tile_address + row * 2 + 1);
+
+        for (int bit = 7; bit >= 0; bit--) {
+            byte low_bit = (low >> bit) & 0x1;
+            byte high_bit = (high >> bit) & 0x1;
+
+            tile[row * 8 + (7 - bit)] = (high_bit << 1) | low_bit;
+        }
+    }
+
+    tile_dirty[index] = false;
+}
+
+void PPU::add_view_changes(const byte& changes) {
+    for (byte& viewer_changes : view_changes) {
+        viewer_changes |= changes;
+    }
+}
+
 byte PPU::read_vram(const ushort& address) {
     if (address >= 0x8000 && address < 0xa000) {
         if (blocked_vram) {
@@ -269,6 +456,134 @@ byte PPU::read_vram(const ushort& address) {
     }
 }
 
+//wy only has to match ly on some line this frame, wx then gives where the window starts on every line after
+void PPU::setup_window_line() {
+    fetching_window = false;
+    window_start_x = -1;
+    fifo_discard = scx & 7;
+
+    if (ly == wy) {
+        window_y_reached = true;
+    }
+
+    if ((lcdc & 0x20) == 0 || !window_y_reached || wx > 166) {
+        return;
+    }
+
+    //wx below 7 starts the window off the left edge, the hidden pixels are dropped like scx's
+    window_start_x = std::max(0, wx - 7);
+    if (window_start_x == 0) {
+        start_window_fetch();
+        primed_fifo = false;
+        fifo_discard = 7 - std::min<int>(wx, 7);
+    }
+}
+
+void PPU::start_window_fetch() {
+    clear_fifo(bg_fifo_queue);
+    fetching_window = true;
+    bg_fifo_x = 0;
+    fifo_ticks = 0;
+    current_bg_fifo_state = fifo_FETCH_TILE_NUMBER;
+}
+
+//first 10 entries on this line in oam order, then ordered by x (oam order on ties) which is dmg drawing priority
+void PPU::scan_oam() {
+    line_sprite_count = 0;
+    draw_penalty = 0;
+    if ((lcdc & 0x02) == 0) {
+        return;
+    }
+
+    const std::array<byte, OAM_SIZE>& oam = emulator_ptr->get_oam();
+    int height = (lcdc & 0x04) != 0 ? 16 : 8;
+    for (int i = 0; i < 40 && line_sprite_count < MAX_LINE_SPRITES; i++) {
+        int top = oam[i * 4] - 16;
+        if (ly < top || ly >= top + height) {
+            continue;
+        }
+
+        line_sprite sprite = { oam[i * 4], oam[i * 4 + 1], oam[i * 4 + 2], oam[i * 4 + 3] };
+
+        //insertion keeps earlier oam entries first among equal x
+        int slot = line_sprite_count++;
+        while (slot > 0 && line_sprites[slot - 1].x > sprite.x) {
+            line_sprites[slot] = line_sprites[slot - 1];
+            slot--;
+        }
+        line_sprites[slot] = sprite;
+    }
+
+    if (line_sprite_count > 0) {
+        render_sprite_line();
+        draw_penalty = get_sprite_penalty();
+    }
+}
+
+//highest priority sprite first, a pixel already taken by an opaque sprite pixel stays
+void PPU::render_sprite_line() {
+    sprite_line.fill(fifo_pixel());
+
+    bool tall = (lcdc & 0x04) != 0;
+    int height = tall ? 16 : 8;
+    for (int i = 0; i < line_sprite_count; i++) {
+        const line_sprite& sprite = line_sprites[i];
+
+        int row = ly - (sprite.y - 16);
+        if ((sprite.attributes & 0x40) != 0) {
+            row = height - 1 - row;
+        }
+
+        int index = tall ? ((sprite.tile & 0xfe) + row / 8) : sprite.tile;
+        const std::array<byte, 64>& tile = get_decoded_tile(index);
+
+        for (int column = 0; column < 8; column++) {
+            int screen_x = sprite.x - 8 + column;
+            if (screen_x < 0 || screen_x >= SCREEN_WIDTH || sprite_line[screen_x].sprite) {
+                continue;
+            }
+
+            int tile_x = (sprite.attributes & 0x20) != 0 ? 7 - column : column;
+            byte colour = tile[(row % 8) * 8 + tile_x];
+            if (colour == 0) {
+                continue;
+            }
+
+            fifo_pixel& pixel = sprite_line[screen_x];
+            pixel.colour = colour;
+            pixel.priority = (sprite.attributes & 0x80) != 0;
+            pixel.sprite = true;
+            pixel.sprite_pallete = (sprite.attributes & 0x10) != 0;
+        }
+    }
+}
+
+//mode 3 penalty following pan docs, 6 dots per sprite plus up to 5 for the first sprite landing in each bg tile
+int PPU::get_sprite_penalty() {
+    int penalty = 0;
+    int last_tile = -1;
+    for (int i = 0; i < line_sprite_count; i++) {
+        const line_sprite& sprite = line_sprites[i];
+        if (sprite.x >= 168) {
+            continue;
+        }
+
+        if (sprite.x == 0) {
+            penalty += 11;
+            continue;
+        }
+
+        penalty += 6;
+        int tile = (sprite.x + (scx & 7)) / 8;
+        if (tile != last_tile) {
+            penalty += std::max(0, 5 - ((sprite.x + scx) & 7));
+            last_tile = tile;
+        }
+    }
+
+    return penalty;
+}
+
 void PPU::bg_fetcher_tick() {
     fifo_ticks++;
 
@@ -306,6 +621,17 @@ void PPU::bg_fetcher_tick() {
 
 void PPU::fetcher_get_tile_number() {
     ushort tile_map_base = 0x9800;
+    if (fetching_window) {
+        if ((lcdc & 0x40) != 0) {
+            tile_map_base = 0x9c00;
+        }
+
+        tile_map_base += bg_fifo_x & 0x1f;
+        tile_map_base += 32 * (window_line / 8);
+        current_pixel_id = read_vram(tile_map_base);
+        return;
+    }
+
     if ((lcdc & 0x8) != 0) {
         tile_map_base = 0x9c00;
     }
@@ -316,29 +642,40 @@ void PPU::fetcher_get_tile_number() {
     current_pixel_id = read_vram((ushort)(tile_map_base));
 }
 
+//both planes come out of the decoded tile cache, still taken on their own slots so a vram write between them lands like it would on hardware
 void PPU::fetcher_get_tile_low() {
-    ushort tile_data_address = get_tile_address_from_id(current_pixel_id);
-    tile_data_address += (2 * ((ly + scy) % 8));
-
-    current_pixel_low = read_vram(tile_data_address);
+    const byte* row = get_fetcher_tile_row();
+    for (int x = 0; x < 8; x++) {
+        current_tile_row[x] = row[x] & 0x01;
+    }
 }
 
 void PPU::fetcher_get_tile_high() {
+    const byte* row = get_fetcher_tile_row();
+    for (int x = 0; x < 8; x++) {
+        current_tile_row[x] |= row[x] & 0x02;
+    }
+}
+
+//colour 3 everywhere while vram is blocked, same as both bytes reading back 0xff
+const byte* PPU::get_fetcher_tile_row() {
+    static const byte blocked_row[8] = { 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03 };
+    if (blocked_vram) {
+        return blocked_row;
+    }
+
     ushort tile_data_address = get_tile_address_from_id(current_pixel_id);
-    tile_data_address += 2 * ((ly + scy) % 8);
-    current_pixel_high = read_vram(tile_data_address + 1);
+    const std::array<byte, 64>& tile = get_decoded_tile((tile_data_address - 0x8000) / 16);
+    int row = fetching_window ? window_line % 8 : (ly + scy) % 8;
+    return tile.data() + row * 8;
 }
 
 void PPU::fetcher_push_row() {
     if (bg_fifo_queue.size() < 8) {
         //loop from left to right
-        for (int bit = 7; bit >= 0; bit--) {
-            byte low_bit = (current_pixel_low >> bit) & 0x1;
-            byte high_bit = (current_pixel_high >> bit) & 0x1;
-            byte colour = (high_bit << 0x1) | low_bit;
-
+        for (int x = 0; x < 8; x++) {
             fifo_pixel new_pixel = {
-                .colour = colour,
+                .colour = current_tile_row[x],
                 .pallete = bgp,
                 .priority = 0x00,
                 .sprite = 0x00,
@@ -351,34 +688,41 @@ void PPU::fetcher_push_row() {
     }
 }
 
-void PPU::push_pixel(std::queue<fifo_pixel>& fifo, const fifo_pixel& pixel) {
-    if (fifo.size() < 16) {
-        fifo.push(pixel);
+void PPU::push_pixel(pixel_fifo& fifo, const fifo_pixel& pixel) {
+    if (fifo.count < PIXEL_FIFO_SIZE) {
+        fifo.pixels[(fifo.head + fifo.count) % PIXEL_FIFO_SIZE] = pixel;
+        fifo.count++;
     }
 }
 
-fifo_pixel PPU::pop_pixel(std::queue<fifo_pixel>& fifo) {
+fifo_pixel PPU::pop_pixel(pixel_fifo& fifo) {
     if (!fifo.empty()) {
-        fifo_pixel pixel = fifo.front();
-        fifo.pop();
+        fifo_pixel pixel = fifo.pixels[fifo.head];
+        fifo.head = (fifo.head + 1) % PIXEL_FIFO_SIZE;
+        fifo.count--;
         return pixel;
     }
     
     return {};
 }
 
-void PPU::clear_fifo(std::queue<fifo_pixel>& fifo) {
-    while (!fifo.empty()) {
-        fifo.pop();
-    }
+void PPU::clear_fifo(pixel_fifo& fifo) {
+    fifo.head = 0;
+    fifo.count = 0;
 }
 
 void PPU::output_bg_pixel() {
+    //the trigger x is worked out once per line, reaching it restarts the fetcher on the window map
+    if (onscreen_x == window_start_x && !fetching_window) {
+        start_window_fetch();
+        return;
+    }
+
     if (!bg_fifo_queue.empty()) {
         if (!primed_fifo) {
             if (bg_fifo_queue.size() >= 8) {
-                for (int i = 0; i < (scx & 7); i++) {
-                    bg_fifo_queue.pop();
+                for (int i = 0; i < fifo_discard; i++) {
+                    pop_pixel(bg_fifo_queue);
                 }
                 primed_fifo = true;
                 return;
@@ -391,9 +735,29 @@ void PPU::output_bg_pixel() {
             int palette_shift = pixel.colour * 2;
             int palette_colour = (bgp >> palette_shift) & 0x03;
 
-            background_pixel_buffer[ly * SCREEN_WIDTH + onscreen_x] = gb_colors[palette_colour];
+            //sprite over the background unless it asked to sit behind bg colours 1-3
+            if (line_sprite_count > 0) {
+                const fifo_pixel& sprite = sprite_line[onscreen_x];
+                if (sprite.sprite && (!sprite.priority || pixel.colour == 0)) {
+                    byte sprite_palette = sprite.sprite_pallete ? obp1 : obp0;
+                    palette_colour = (sprite_palette >> (sprite.colour * 2)) & 0x03;
+                }
+            }
+
+            line_shades[onscreen_x] = (byte)palette_colour;
 
             onscreen_x++;
         }
     }
+}
+
+void PPU::finish_line() {
+    byte* line = &shade_buffer[ly * SCREEN_WIDTH];
+    if (std::memcmp(line, line_shades.data(), line_shades.size()) == 0) {
+        return;
+    }
+
+    std::memcpy(line, line_shades.data(), line_shades.size());
+    dirty_first_line = std::min(dirty_first_line, (int)ly);
+    dirty_last_line = std::max(dirty_last_line, (int)ly);
 }
\ No newline at end of file
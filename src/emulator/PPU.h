@@ -1,10 +1,10 @@
 #pragma once
 
 #include "_definitions.h"
+#include "Shades.h"
 #include <memory>
 #include <SDL3/SDL.h>
 #include <array>
-#include <queue>
 
 class Emulator;
 
@@ -16,6 +16,31 @@ struct fifo_pixel {
 	byte sprite_pallete = 0x00;
 };
 
+//fixed size ring so pushing/popping pixels never touches the heap, the fifos hold at most 16 pixels
+const int PIXEL_FIFO_SIZE = 16;
+
+struct pixel_fifo {
+	std::array<fifo_pixel, PIXEL_FIFO_SIZE> pixels = std::array<fifo_pixel, PIXEL_FIFO_SIZE>();
+	int head = 0;
+	int count = 0;
+
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+};
+
+//one oam entry picked for the current line by the mode 2 scan, x/y are as stored in oam (+8/+16)
+struct line_sprite {
+	byte y = 0x00;
+	byte x = 0x00;
+	byte tile = 0x00;
+	byte attributes = 0x00;
+};
+
+const int MAX_LINE_SPRITES = 10;
+
+//tile data at 0x8000-0x97ff decoded to 2 bit colour indices, row major, 8x8 per tile
+const int TILE_CACHE_TILES = 384;
+
 enum fifo_state {
 	fifo_NONE,
 	fifo_PUSHING,
@@ -37,13 +62,32 @@ public:
 	void io_instant_write(const byte& ppu_io, const byte& value);
     ppu_modes get_current_mode();
 
+	uint64_t get_state_hash(const uint64_t& hash);
+
 	bool is_draw_ready();
 	void reset_draw_ready();
 
-	std::array<uint32_t, 160 * 144> get_bg_frame_buffer();
+	//shades 0-3 after bgp/obp, expanded to colours by whoever presents them (see Shades.h)
+	const std::array<byte, 160 * 144>& get_shade_buffer() const;
 
-	//debug methods for showing tilemaps etc 
-	std::array<uint32_t, 64> get_next_tile(const int& index);
+	//lines whose shades changed since the last take, so an unchanged frame costs the frontend nothing
+	bool take_dirty_lines(int& first_line, int& last_line);
+	void mark_frame_dirty();
+
+	//decoded tile cache, the mmu marks tiles dirty on vram writes and they are decoded again on next use
+	void mark_vram_written(const ushort& address);
+	void mark_oam_written();
+	void invalidate_tile_cache();
+	const std::array<byte, 64>& get_decoded_tile(const int& index);
+
+	//debug methods for showing tilemaps etc, tiles changed since the last call (or all after a bgp change) are set in dirty_tiles
+	bool take_viewer_dirty_tiles(std::array<bool, TILE_CACHE_TILES>& dirty_tiles);
+	void fill_tile_pixels(const int& index, uint32_t* pixels, const int& pitch);
+
+	//bg map/oam views, only redrawn when take_view_changes says something they show changed
+	byte take_view_changes(const ppu_viewers& viewer);
+	void fill_map_pixels(const int& map, uint32_t* pixels);
+	void fill_sprite_pixels(const byte& tile, const byte& attributes, uint32_t* pixels, const int& pitch);
 
 private:
 	std::shared_ptr<Emulator> emulator_ptr = nullptr;
@@ -67,8 +111,8 @@ private:
 
 	ppu_modes current_mode = ppu_NONE;
 	
-	const int SCREEN_WIDTH = 160;
-	const int SCREEN_HEIGHT = 144;
+	static constexpr int SCREEN_WIDTH = 160;
+	static constexpr int SCREEN_HEIGHT = 144;
 
 	bool render_line = false;
 	bool render_frame = false;
@@ -77,10 +121,13 @@ private:
 
 	bool draw_ready = false;
 
-	std::array<uint32_t, 160 * 144> background_pixel_buffer = std::array<uint32_t, 160 * 144>();
-	std::array<uint32_t, 4> gb_colors = std::array<uint32_t, 4>();
+	std::array<byte, 160 * 144> shade_buffer = std::array<byte, 160 * 144>();
+	std::array<byte, 160> line_shades = std::array<byte, 160>();
+	int dirty_first_line = 0;
+	int dirty_last_line = 143;
+	std::array<uint32_t, 4> gb_colors = colour_scheme_table[scheme_GREY].colours; //debug views only
 
-	std::queue<fifo_pixel> bg_fifo_queue = std::queue<fifo_pixel>();
+	pixel_fifo bg_fifo_queue = pixel_fifo();
 	fifo_state current_bg_fifo_state = fifo_FETCH_TILE_NUMBER;
 	
 	int fifo_ticks = 0;
@@ -90,29 +137,62 @@ private:
 	
 	bool start_of_fifo_scanline = false;
 	bool primed_fifo = false;
+	int fifo_discard = 0;
+
+	//window, window_line is the window's own line counter and window_start_x the line's trigger x (-1 for none)
+	byte window_line = 0x00;
+	bool window_y_reached = false;
+	bool fetching_window = false;
+	int window_start_x = -1;
 
 	byte current_pixel_id = 0x00;
 	ushort current_pixel_address = 0x0000;
-	byte current_pixel_low = 0x00;
-	byte current_pixel_high = 0x00;
+	std::array<byte, 8> current_tile_row = std::array<byte, 8>();
+
+	std::array<std::array<byte, 64>, TILE_CACHE_TILES> decoded_tiles = std::array<std::array<byte, 64>, TILE_CACHE_TILES>();
+	std::array<bool, TILE_CACHE_TILES> tile_dirty = std::array<bool, TILE_CACHE_TILES>();
+	std::array<bool, TILE_CACHE_TILES> viewer_tile_dirty = std::array<bool, TILE_CACHE_TILES>();
+	bool viewer_tiles_pending = false;
+	int viewer_palette = -1;
+	std::array<byte, viewer_COUNT> view_changes = std::array<byte, viewer_COUNT>();
+
+	//sprites on the current line sorted by drawing priority, and the line they make, built once per line by scan_oam
+	std::array<line_sprite, MAX_LINE_SPRITES> line_sprites = std::array<line_sprite, MAX_LINE_SPRITES>();
+	int line_sprite_count = 0;
+	std::array<fifo_pixel, 160> sprite_line = std::array<fifo_pixel, 160>();
+	int draw_penalty = 0;
 
 private:
+	void update_ppu();
+	void trace_mode_change();
+
 	ushort get_tile_address_from_id(const byte& tile_id);
 	byte read_vram(const ushort& address);
+	void decode_tile(const int& index);
+	void add_view_changes(const byte& changes);
+
+	void setup_window_line();
+	void start_window_fetch();
+	void scan_oam();
+	void render_sprite_line();
+	int get_sprite_penalty();
 
 	void bg_fetcher_tick();
 	void fetcher_get_tile_number();
 	void fetcher_get_tile_low();
 	void fetcher_get_tile_high();
+	const byte* get_fetcher_tile_row();
 	void fetcher_push_row();
 
 	//fifo helper methods for either fifo
-	void push_pixel(std::queue<fifo_pixel>& fifo, const fifo_pixel& pixel);
-	fifo_pixel pop_pixel(std::queue<fifo_pixel>& fifo) ;
-	void clear_fifo(std::queue<fifo_pixel>& fifo);
+	void push_pixel(pixel_fifo& fifo, const fifo_pixel& pixel);
+	fifo_pixel pop_pixel(pixel_fifo& fifo) ;
+	void clear_fifo(pixel_fifo& fifo);
 
-	//push pixel to the screen, todo modify to use either fifo
+	//push pixel to the screen, sprites are mixed in from sprite_line
 	void output_bg_pixel();
+	//copy the finished line into shade_buffer, only marking it dirty when it differs from last frame's
+	void finish_line();
 
 	//debug methods for showing tilemaps etc 
 };
\ No newline at end of file
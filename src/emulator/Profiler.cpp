@@ -0,0 +1,214 @@
+#include "Profiler.h"
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdio>
+
+Profiler::Profiler(const rom_header& header) {
+	//header rom size n means 32KiB << n, so 2 << n banks of 16KiB
+	if (header.cart_rom_size != rom_NONE) {
+		rom_bank_count = 2 << header.cart_rom_size;
+	}
+
+	reset();
+}
+
+Profiler::~Profiler() {
+	printf("[SB] Shutting down PROFILER object\n");
+}
+
+void Profiler::reset() {
+	pc_cycles.assign((size_t)rom_bank_count * 0x4000 + 0x8000, 0);
+	total_cycles = 0;
+
+	stack_nodes.clear();
+	stack_nodes.push_back(profiler_stack_node());
+	current_node = 0;
+	current_depth = 0;
+	overflow_depth = 0;
+}
+
+void Profiler::add_step(const int& bank, const ushort& pc, const int& cycles) {
+	pc_cycles[get_profile_index(bank, pc)] += cycles;
+	stack_nodes[current_node].cycles += cycles;
+	total_cycles += cycles;
+}
+
+void Profiler::enter_routine(const int& bank, const ushort& address) {
+	//past the depth limit only count calls so the matching returns line up again
+	if (current_depth >= PROFILER_MAX_STACK_DEPTH) {
+		overflow_depth++;
+		return;
+	}
+
+	uint32_t key = make_key(bank, address);
+	std::map<uint32_t, int>& children = stack_nodes[current_node].children;
+
+	auto child = children.find(key);
+	if (child != children.end()) {
+		current_node = child->second;
+	}
+	else {
+		profiler_stack_node node = profiler_stack_node();
+		node.parent = current_node;
+		node.routine = key;
+
+		int index = (int)stack_nodes.size();
+		stack_nodes.push_back(node);
+		stack_nodes[current_node].children[key] = index;
+		current_node = index;
+	}
+
+	current_depth++;
+}
+
+void Profiler::leave_routine() {
+	if (overflow_depth > 0) {
+		overflow_depth--;
+		return;
+	}
+
+	//code that pops its own return address can unbalance the stack, just stay at the root
+	if (stack_nodes[current_node].parent >= 0) {
+		current_node = stack_nodes[current_node].parent;
+		current_depth--;
+	}
+}
+
+bool Profiler::load_symbols(const std::string& file_name) {
+	std::ifstream sym_file(file_name);
+	if (!sym_file) {
+		return false;
+	}
+
+	symbols.clear();
+
+	std::string line;
+	while (std::getline(sym_file, line)) {
+		//strip comments, rgbds writes a header starting with ;
+		size_t comment = line.find(';');
+		if (comment != std::string::npos) {
+			line = line.substr(0, comment);
+		}
+
+		unsigned int bank = 0;
+		unsigned int address = 0;
+		char label[256] = {};
+		if (sscanf(line.c_str(), "%x:%x %255s", &bank, &address, label) == 3) {
+			//sym files use bank 1 for any rom bank mapped at 0x4000, keep what the file says
+			symbols[make_key((int)bank, (ushort)address)] = label;
+		}
+	}
+
+	printf("[SB] Loaded %d symbols from %s\n", (int)symbols.size(), file_name.c_str());
+	return true;
+}
+
+const bool Profiler::has_symbols() const {
+	return !symbols.empty();
+}
+
+const uint64_t& Profiler::get_total_cycles() const {
+	return total_cycles;
+}
+
+std::vector<profiler_entry> Profiler::get_top_routines(const int& count) {
+	std::unordered_map<std::string, uint64_t> routines = std::unordered_map<std::string, uint64_t>();
+
+	//walk the flat array back into (bank, pc)
+	for (size_t index = 0; index < pc_cycles.size(); index++) {
+		if (pc_cycles[index] == 0) {
+			continue;
+		}
+
+		int bank = 0;
+		ushort address = 0x0000;
+		if (index < (size_t)rom_bank_count * 0x4000) {
+			bank = (int)(index / 0x4000);
+			address = (ushort)((bank == 0 ? 0x0000 : 0x4000) + index % 0x4000);
+		}
+		else {
+			address = (ushort)(0x8000 + index - (size_t)rom_bank_count * 0x4000);
+		}
+
+		routines[get_symbol_name(make_key(bank, address), true)] += pc_cycles[index];
+	}
+
+	std::vector<profiler_entry> entries = std::vector<profiler_entry>();
+	entries.reserve(routines.size());
+	for (const auto& [name, cycles] : routines) {
+		entries.push_back({ name, cycles });
+	}
+
+	int top = std::min(count, (int)entries.size());
+	std::partial_sort(entries.begin(), entries.begin() + top, entries.end(), [](const profiler_entry& a, const profiler_entry& b) {
+		return a.cycles > b.cycles;
+	});
+	entries.resize(top);
+
+	return entries;
+}
+
+//one "root;caller;callee cycles" line per call path, the format flamegraph.pl/speedscope/inferno read
+bool Profiler::export_collapsed_stacks(const std::string& file_name) {
+	std::ofstream output(file_name);
+	if (!output) {
+		printf("[SB] Failed to open %s for writing\n", file_name.c_str());
+		return false;
+	}
+
+	for (int index = 0; index < (int)stack_nodes.size(); index++) {
+		if (stack_nodes[index].cycles == 0) {
+			continue;
+		}
+
+		std::vector<std::string> frames = std::vector<std::string>();
+		for (int node = index; node > 0; node = stack_nodes[node].parent) {
+			frames.push_back(get_symbol_name(stack_nodes[node].routine, false));
+		}
+		frames.push_back("entry");
+
+		std::reverse(frames.begin(), frames.end());
+		for (size_t i = 0; i < frames.size(); i++) {
+			output << (i == 0 ? "" : ";") << frames[i];
+		}
+		output << " " << stack_nodes[index].cycles << "\n";
+	}
+
+	printf("[SB] Wrote collapsed stacks to %s\n", file_name.c_str());
+	return true;
+}
+
+//privates
+int Profiler::get_profile_index(const int& bank, const ushort& address) {
+	if (address < 0x4000) {
+		return address;
+	}
+	else if (address < 0x8000) {
+		return std::min(bank, rom_bank_count - 1) * 0x4000 + (address - 0x4000);
+	}
+
+	return rom_bank_count * 0x4000 + (address - 0x8000);
+}
+
+//routine entries use their exact label, pcs take the closest label before them in the same bank/region
+std::string Profiler::get_symbol_name(const uint32_t& key, const bool& nearest) {
+	auto symbol = symbols.upper_bound(key);
+	if (symbol != symbols.begin()) {
+		symbol--;
+
+		bool same_bank = (symbol->first >> 16) == (key >> 16);
+		bool same_region = ((symbol->first & 0xffff) < 0x8000) == ((key & 0xffff) < 0x8000);
+		if (symbol->first == key || (nearest && same_bank && same_region)) {
+			return symbol->second;
+		}
+	}
+
+	char name[16];
+	snprintf(name, sizeof(name), "$%02X:%04X", key >> 16, key & 0xffff);
+	return std::string(name);
+}
+
+uint32_t Profiler::make_key(const int& bank, const ushort& address) {
+	return ((uint32_t)bank << 16) | address;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "_definitions.h"
+#include <vector>
+#include <string>
+#include <map>
+
+//guest code profiler, only built with -DSHARPBOY_PROFILER=ON (see CMakeLists.txt)
+//cycles are accumulated per (bank, pc) and per shadow call stack built from call/rst/interrupt/ret
+
+const int PROFILER_MAX_STACK_DEPTH = 64;
+
+struct profiler_entry {
+	std::string name = "";
+	uint64_t cycles = 0;
+};
+
+//one node per distinct call path, children keyed by the (bank, address) of the routine entered
+struct profiler_stack_node {
+	int parent = -1;
+	uint32_t routine = 0;
+	uint64_t cycles = 0;
+	std::map<uint32_t, int> children = std::map<uint32_t, int>();
+};
+
+class Profiler {
+public:
+	Profiler(const rom_header& header);
+	~Profiler();
+
+	void reset();
+
+	//called by the cpu through the emulator
+	void add_step(const int& bank, const ushort& pc, const int& cycles);
+	void enter_routine(const int& bank, const ushort& address);
+	void leave_routine();
+
+	//rgbds .sym files, "bank:address label" per line
+	bool load_symbols(const std::string& file_name);
+	const bool has_symbols() const;
+
+	//results
+	const uint64_t& get_total_cycles() const;
+	std::vector<profiler_entry> get_top_routines(const int& count);
+	bool export_collapsed_stacks(const std::string& file_name);
+
+private:
+	int get_profile_index(const int& bank, const ushort& address);
+	std::string get_symbol_name(const uint32_t& key, const bool& nearest);
+	static uint32_t make_key(const int& bank, const ushort& address);
+
+private:
+	int rom_bank_count = 2;
+	uint64_t total_cycles = 0;
+
+	//rom banks packed one after another followed by 0x8000->0xffff
+	std::vector<uint64_t> pc_cycles = std::vector<uint64_t>();
+
+	std::map<uint32_t, std::string> symbols = std::map<uint32_t, std::string>();
+
+	std::vector<profiler_stack_node> stack_nodes = std::vector<profiler_stack_node>();
+	int current_node = 0;
+	int current_depth = 0;
+	int overflow_depth = 0;
+};
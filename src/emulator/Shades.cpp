@@ -0,0 +1,98 @@
+#include "Shades.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHARPBOY_SSE2_EXPAND
+#endif
+
+int get_frame_format_bytes(const frame_formats& format) {
+	return format == frame_RGB565 ? 2 : 4;
+}
+
+std::array<uint32_t, 4> convert_colours(const std::array<uint32_t, 4>& rgba_colours, const frame_formats& format) {
+	std::array<uint32_t, 4> converted = std::array<uint32_t, 4>();
+	for (int i = 0; i < 4; i++) {
+		uint32_t r = (rgba_colours[i] >> 24) & 0xff;
+		uint32_t g = (rgba_colours[i] >> 16) & 0xff;
+		uint32_t b = (rgba_colours[i] >> 8) & 0xff;
+		uint32_t a = rgba_colours[i] & 0xff;
+
+		switch (format) {
+		case frame_RGBA8888: converted[i] = rgba_colours[i]; break;
+		case frame_ARGB8888: converted[i] = (a << 24) | (r << 16) | (g << 8) | b; break;
+		case frame_ABGR8888: converted[i] = (a << 24) | (b << 16) | (g << 8) | r; break;
+		case frame_XRGB8888: converted[i] = 0xff000000 | (r << 16) | (g << 8) | b; break;
+		case frame_RGB565: converted[i] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3); break;
+		default: converted[i] = rgba_colours[i]; break;
+		}
+	}
+
+	return converted;
+}
+
+void write_shades(const byte* shades, void* pixels, const size_t& count, const std::array<uint32_t, 4>& colours, const frame_formats& format) {
+	if (get_frame_format_bytes(format) == 2) {
+		expand_shades_16(shades, (uint16_t*)pixels, count, colours);
+	}
+	else {
+		expand_shades(shades, (uint32_t*)pixels, count, colours);
+	}
+}
+
+void expand_shades(const byte* shades, uint32_t* pixels, const size_t& count, const std::array<uint32_t, 4>& colours) {
+	size_t i = 0;
+
+#ifdef SHARPBOY_SSE2_EXPAND
+	//16 shades at a time, widened to 32 bits and each one picked out of the 4 colours with compare masks
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i shade_values[4] = { _mm_set1_epi32(0), _mm_set1_epi32(1), _mm_set1_epi32(2), _mm_set1_epi32(3) };
+	const __m128i colour_values[4] = { _mm_set1_epi32((int)colours[0]), _mm_set1_epi32((int)colours[1]), _mm_set1_epi32((int)colours[2]), _mm_set1_epi32((int)colours[3]) };
+
+	for (; i + 16 <= count; i += 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(shades + i));
+		__m128i low_words = _mm_unpacklo_epi8(bytes, zero);
+		__m128i high_words = _mm_unpackhi_epi8(bytes, zero);
+		__m128i dwords[4] = { _mm_unpacklo_epi16(low_words, zero), _mm_unpackhi_epi16(low_words, zero), _mm_unpacklo_epi16(high_words, zero), _mm_unpackhi_epi16(high_words, zero) };
+
+		for (int part = 0; part < 4; part++) {
+			__m128i result = _mm_and_si128(_mm_cmpeq_epi32(dwords[part], shade_values[0]), colour_values[0]);
+			for (int shade = 1; shade < 4; shade++) {
+				result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi32(dwords[part], shade_values[shade]), colour_values[shade]));
+			}
+			_mm_storeu_si128((__m128i*)(pixels + i + part * 4), result);
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		pixels[i] = colours[shades[i] & 0x03];
+	}
+}
+
+void expand_shades_16(const byte* shades, uint16_t* pixels, const size_t& count, const std::array<uint32_t, 4>& colours) {
+	size_t i = 0;
+
+#ifdef SHARPBOY_SSE2_EXPAND
+	//same select as above on 16 bit lanes, 8 pixels per register
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i shade_values[4] = { _mm_set1_epi16(0), _mm_set1_epi16(1), _mm_set1_epi16(2), _mm_set1_epi16(3) };
+	const __m128i colour_values[4] = { _mm_set1_epi16((short)colours[0]), _mm_set1_epi16((short)colours[1]), _mm_set1_epi16((short)colours[2]), _mm_set1_epi16((short)colours[3]) };
+
+	for (; i + 16 <= count; i += 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(shades + i));
+		__m128i words[2] = { _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero) };
+
+		for (int part = 0; part < 2; part++) {
+			__m128i result = _mm_and_si128(_mm_cmpeq_epi16(words[part], shade_values[0]), colour_values[0]);
+			for (int shade = 1; shade < 4; shade++) {
+				result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi16(words[part], shade_values[shade]), colour_values[shade]));
+			}
+			_mm_storeu_si128((__m128i*)(pixels + i + part * 8), result);
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		pixels[i] = (uint16_t)colours[shades[i] & 0x03];
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "_definitions.h"
+#include <array>
+
+//the ppu stores dmg shades 0-3 (palette already applied), these turn them into pixels once per frame when presented
+//scheme colours are written as rgba8888 and converted to the output format up front, so the per pixel pass is only a 4 way select
+
+struct colour_scheme {
+	const char* name;
+	std::array<uint32_t, 4> colours;
+};
+
+inline constexpr std::array<colour_scheme, scheme_COUNT> colour_scheme_table = { {
+	{ "Grey", { 0xffffffff, 0xd3d3d3ff, 0x222222ff, 0x000000ff } },
+	{ "DMG Green", { 0x9bbc0fff, 0x8bac0fff, 0x306230ff, 0x0f380fff } },
+	{ "Pocket", { 0xc4cfa1ff, 0x8b956dff, 0x4d533cff, 0x1f1f1fff } },
+} };
+
+int get_frame_format_bytes(const frame_formats& format);
+std::array<uint32_t, 4> convert_colours(const std::array<uint32_t, 4>& rgba_colours, const frame_formats& format);
+
+//count shades into count pixels of format, colours come from convert_colours, shades above 3 are not expected
+void write_shades(const byte* shades, void* pixels, const size_t& count, const std::array<uint32_t, 4>& colours, const frame_formats& format);
+void expand_shades(const byte* shades, uint32_t* pixels, const size_t& count, const std::array<uint32_t, 4>& colours);
+void expand_shades_16(const byte* shades, uint16_t* pixels, const size_t& count, const std::array<uint32_t, 4>& colours);
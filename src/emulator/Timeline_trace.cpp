@@ -0,0 +1,245 @@
+#include "Timeline_trace.h"
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+
+std::atomic<bool> timeline_recording = false;
+
+//single producer ring, only the owning thread writes and only the writer thread reads
+struct timeline_ring {
+	std::array<timeline_event, TIMELINE_RING_SIZE> events = std::array<timeline_event, TIMELINE_RING_SIZE>();
+	std::atomic<uint64_t> head = 0;
+	int thread_id = 0;
+	std::string thread_name = "";
+	timeline_ring* guest = nullptr; //the same thread's guest marker ring, once it has one
+};
+
+class Timeline_writer {
+public:
+	~Timeline_writer() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_one();
+
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	timeline_ring* register_thread() {
+		std::lock_guard<std::mutex> lock(rings_mutex);
+		rings.push_back(std::make_unique<timeline_ring>());
+		rings.back()->thread_id = (int)rings.size();
+		rings.back()->thread_name = "Thread " + std::to_string(rings.size());
+		return rings.back().get();
+	}
+
+	timeline_ring* register_guest_ring(timeline_ring* host) {
+		std::lock_guard<std::mutex> lock(rings_mutex);
+		rings.push_back(std::make_unique<timeline_ring>());
+		rings.back()->thread_id = (int)rings.size();
+		rings.back()->thread_name = host->thread_name + " Guest";
+		host->guest = rings.back().get();
+		return rings.back().get();
+	}
+
+	void request_export(const std::string& file_name) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pending_exports.push_back(file_name);
+			if (!thread.joinable()) {
+				thread = std::thread(&Timeline_writer::writer_loop, this);
+			}
+		}
+		wake.notify_one();
+	}
+
+	std::mutex rings_mutex;
+	std::vector<std::unique_ptr<timeline_ring>> rings = std::vector<std::unique_ptr<timeline_ring>>();
+
+private:
+	void writer_loop() {
+		while (true) {
+			std::string file_name = "";
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this] { return stopping || !pending_exports.empty(); });
+				if (pending_exports.empty()) {
+					return;
+				}
+
+				file_name = pending_exports.front();
+				pending_exports.erase(pending_exports.begin());
+			}
+
+			write_trace(file_name);
+		}
+	}
+
+	void write_trace(const std::string& file_name) {
+		FILE* output = fopen(file_name.c_str(), "w");
+		if (output == nullptr) {
+			printf("[SB] Failed to open %s for writing\n", file_name.c_str());
+			return;
+		}
+
+		fprintf(output, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+		fprintf(output, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Sharpboy++\"}}");
+
+		int event_count = 0;
+		std::vector<timeline_event> snapshot = std::vector<timeline_event>();
+
+		std::lock_guard<std::mutex> lock(rings_mutex);
+		for (const std::unique_ptr<timeline_ring>& ring : rings) {
+			fprintf(output, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", ring->thread_id, ring->thread_name.c_str());
+
+			//copy out while the owner keeps writing, then drop whatever it lapped during the copy
+			//the slot at head may be half written already, so it is never part of the valid window
+			uint64_t head = ring->head.load(std::memory_order_acquire);
+			uint64_t first = head >= TIMELINE_RING_SIZE ? head - TIMELINE_RING_SIZE + 1 : 0;
+
+			snapshot.clear();
+			for (uint64_t i = first; i < head; i++) {
+				snapshot.push_back(ring->events[i & (TIMELINE_RING_SIZE - 1)]);
+			}
+
+			uint64_t head_after = ring->head.load(std::memory_order_acquire);
+			uint64_t first_valid = head_after >= TIMELINE_RING_SIZE ? head_after - TIMELINE_RING_SIZE + 1 : 0;
+
+			for (uint64_t i = first; i < head; i++) {
+				if (i < first_valid) {
+					continue;
+				}
+
+				const timeline_event& event = snapshot[i - first];
+				if (event.type == timeline_SPAN) {
+					fprintf(output, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d", event.name, event.category, event.start_ns / 1000.0, event.duration_ns / 1000.0, ring->thread_id);
+				}
+				else {
+					fprintf(output, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", event.name, event.category, event.start_ns / 1000.0, ring->thread_id);
+				}
+
+				if (event.arg_name != nullptr) {
+					fprintf(output, ",\"args\":{\"%s\":%lld}", event.arg_name, (long long)event.arg_value);
+				}
+				fprintf(output, "}");
+				event_count++;
+			}
+		}
+
+		fprintf(output, "\n]}\n");
+		fclose(output);
+
+		printf("[SB] Wrote %d timeline events to %s\n", event_count, file_name.c_str());
+	}
+
+private:
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::vector<std::string> pending_exports = std::vector<std::string>();
+	bool stopping = false;
+};
+
+static Timeline_writer& get_timeline_writer() {
+	static Timeline_writer writer;
+	return writer;
+}
+
+static timeline_ring* get_thread_ring() {
+	thread_local timeline_ring* ring = get_timeline_writer().register_thread();
+	return ring;
+}
+
+static timeline_ring* get_guest_ring() {
+	thread_local timeline_ring* ring = get_timeline_writer().register_guest_ring(get_thread_ring());
+	return ring;
+}
+
+static void push_event(timeline_ring* ring, const timeline_event& event) {
+	uint64_t head = ring->head.load(std::memory_order_relaxed);
+	ring->events[head & (TIMELINE_RING_SIZE - 1)] = event;
+	ring->head.store(head + 1, std::memory_order_release);
+}
+
+void timeline_set_recording(const bool& recording) {
+	timeline_recording.store(recording, std::memory_order_relaxed);
+}
+
+//nanoseconds since the first call, keeps the trace timestamps small
+uint64_t timeline_now() {
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void timeline_set_thread_name(const char* name) {
+	timeline_ring* ring = get_thread_ring();
+
+	std::lock_guard<std::mutex> lock(get_timeline_writer().rings_mutex);
+	ring->thread_name = name;
+	if (ring->guest != nullptr) {
+		ring->guest->thread_name = ring->thread_name + " Guest";
+	}
+}
+
+void timeline_add_span(const char* name, const char* category, const uint64_t& start_ns, const uint64_t& end_ns, const char* arg_name, const int64_t& arg_value) {
+	timeline_event event = timeline_event();
+	event.name = name;
+	event.category = category;
+	event.arg_name = arg_name;
+	event.arg_value = arg_value;
+	event.start_ns = start_ns;
+	event.duration_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+	event.type = timeline_SPAN;
+	push_event(get_thread_ring(), event);
+}
+
+static timeline_event make_instant(const char* name, const char* category, const char* arg_name, const int64_t& arg_value) {
+	timeline_event event = timeline_event();
+	event.name = name;
+	event.category = category;
+	event.arg_name = arg_name;
+	event.arg_value = arg_value;
+	event.start_ns = timeline_now();
+	event.type = timeline_INSTANT;
+	return event;
+}
+
+void timeline_add_instant(const char* name, const char* category, const char* arg_name, const int64_t& arg_value) {
+	push_event(get_thread_ring(), make_instant(name, category, arg_name, arg_value));
+}
+
+void timeline_add_guest_instant(const char* name, const char* category, const char* arg_name, const int64_t& arg_value) {
+	push_event(get_guest_ring(), make_instant(name, category, arg_name, arg_value));
+}
+
+void timeline_request_export(const std::string& file_name) {
+	get_timeline_writer().request_export(file_name);
+}
+
+Timeline_scope::Timeline_scope(const char* name, const char* category) {
+	recording = timeline_is_recording();
+	if (recording) {
+		this->name = name;
+		this->category = category;
+		start_ns = timeline_now();
+	}
+}
+
+Timeline_scope::~Timeline_scope() {
+	if (recording) {
+		timeline_add_span(name, category, start_ns, timeline_now(), arg_name, arg_value);
+	}
+}
+
+void Timeline_scope::set_arg(const char* arg_name, const int64_t& arg_value) {
+	this->arg_name = arg_name;
+	this->arg_value = arg_value;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "_definitions.h"
+#include <atomic>
+#include <string>
+
+//timestamped spans/markers for a chrome trace (chrome://tracing, ui.perfetto.dev)
+//every thread records into its own ring, a background writer thread drains them when an export is requested
+//guest markers (ppu modes) get a second ring and track per thread, at tens of thousands a second they would push the host spans out
+
+//events per thread ring, must be a power of 2. older events are overwritten once it wraps
+const int TIMELINE_RING_SIZE = 1 << 16;
+
+enum timeline_event_types {
+	timeline_SPAN = 0,
+	timeline_INSTANT = 1,
+};
+
+//names, categories and arg names are stored by pointer so they have to be string literals
+struct timeline_event {
+	const char* name = nullptr;
+	const char* category = nullptr;
+	const char* arg_name = nullptr;
+	int64_t arg_value = 0;
+	uint64_t start_ns = 0;
+	uint64_t duration_ns = 0;
+	timeline_event_types type = timeline_SPAN;
+};
+
+extern std::atomic<bool> timeline_recording;
+
+//cheap enough to check on hot paths before building an event
+inline bool timeline_is_recording() {
+	return timeline_recording.load(std::memory_order_relaxed);
+}
+
+void timeline_set_recording(const bool& recording);
+uint64_t timeline_now();
+void timeline_set_thread_name(const char* name);
+
+void timeline_add_span(const char* name, const char* category, const uint64_t& start_ns, const uint64_t& end_ns, const char* arg_name = nullptr, const int64_t& arg_value = 0);
+void timeline_add_instant(const char* name, const char* category, const char* arg_name = nullptr, const int64_t& arg_value = 0);
+void timeline_add_guest_instant(const char* name, const char* category, const char* arg_name = nullptr, const int64_t& arg_value = 0);
+
+//hands the export to the writer thread, returns straight away
+void timeline_request_export(const std::string& file_name);
+
+//records a span from construction to destruction when recording was on at construction
+class Timeline_scope {
+public:
+	Timeline_scope(const char* name, const char* category);
+	~Timeline_scope();
+
+	void set_arg(const char* arg_name, const int64_t& arg_value);
+
+private:
+	const char* name = nullptr;
+	const char* category = nullptr;
+	const char* arg_name = nullptr;
+	int64_t arg_value = 0;
+	uint64_t start_ns = 0;
+	bool recording = false;
+};
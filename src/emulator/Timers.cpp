@@ -137,6 +137,17 @@ void Timers::io_instant_write(const byte& timer_io, const byte& value) {
 	}
 }
 
+uint64_t Timers::get_state_hash(const uint64_t& hash) {
+	uint64_t state_hash = hash_state_value(hash, internal_div);
+	state_hash = hash_state_value(state_hash, tac);
+	state_hash = hash_state_value(state_hash, tima);
+	state_hash = hash_state_value(state_hash, tma);
+	state_hash = hash_state_value(state_hash, previous_and_result);
+	state_hash = hash_state_value(state_hash, reload_tima);
+	state_hash = hash_state_value(state_hash, tima_delay);
+	return hash_state_value(state_hash, written_tima);
+}
+
 bool Timers::tac_enabled(const byte& tac) {
 	return tac & 0x04;
 }
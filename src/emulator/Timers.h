@@ -20,6 +20,8 @@ public:
 	byte read_timer_io(const byte& timer_io);
 	void io_instant_write(const byte& timer_io, const byte& value);
 
+	uint64_t get_state_hash(const uint64_t& hash);
+
 private:
 	std::shared_ptr<Emulator> emulator_ptr;
 	bool initialised;
@@ -34,7 +36,7 @@ private:
 	int tima_delay = 0;
 	bool written_tima = false;
 
-	const int DEFAULT_TIMA_DELAY = 8;
+	static constexpr int DEFAULT_TIMA_DELAY = 8;
 private:
 	bool tac_enabled(const byte& tac);
 	int timer_input_bit(const byte& tac);
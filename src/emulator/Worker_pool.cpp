@@ -0,0 +1,91 @@
+#include "Worker_pool.h"
+#include <algorithm>
+#include <cstdio>
+
+Worker_pool::Worker_pool(const int& threads) {
+	int count = threads;
+	if (count <= 0) {
+		count = std::min((int)std::thread::hardware_concurrency() - 1, MAX_POOL_WORKERS);
+	}
+
+	for (int i = 0; i < count; i++) {
+		workers.emplace_back(&Worker_pool::worker_loop, this, i + 1);
+	}
+}
+
+Worker_pool::~Worker_pool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+
+	printf("[SB] Shutting down WORKER_POOL object\n");
+}
+
+void Worker_pool::run(const int& rows, band_job job, void* context) {
+	if (workers.empty()) {
+		job(context, 0, rows - 1);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = job;
+		this->context = context;
+		this->rows = rows;
+		bands_left = (int)workers.size();
+		generation++;
+	}
+	wake.notify_all();
+
+	//band 0 is ours
+	run_band(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this]() { return bands_left == 0; });
+}
+
+int Worker_pool::get_band_count() const {
+	return (int)workers.size() + 1;
+}
+
+//privates
+void Worker_pool::worker_loop(const int& band) {
+	uint64_t seen_generation = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&]() { return stopping || generation != seen_generation; });
+			if (stopping) {
+				return;
+			}
+			seen_generation = generation;
+		}
+
+		run_band(band);
+
+		bool last = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			last = --bands_left == 0;
+		}
+		if (last) {
+			done.notify_one();
+		}
+	}
+}
+
+void Worker_pool::run_band(const int& band) {
+	int bands = get_band_count();
+	int first_row = rows * band / bands;
+	int last_row = rows * (band + 1) / bands - 1;
+	if (first_row <= last_row) {
+		job(context, first_row, last_row);
+	}
+}
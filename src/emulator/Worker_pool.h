@@ -0,0 +1,43 @@
+#pragma once
+
+#include "_definitions.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//a few threads kept parked for jobs split into row bands, the calling thread takes a band too
+//run() blocks until every band is done, so jobs can write straight into memory the caller owns
+
+typedef void (*band_job)(void* context, const int& first_row, const int& last_row);
+
+class Worker_pool {
+public:
+	//threads = 0 picks hardware threads - 1, capped at MAX_POOL_WORKERS
+	Worker_pool(const int& threads = 0);
+	~Worker_pool();
+
+	void run(const int& rows, band_job job, void* context);
+	int get_band_count() const;
+
+private:
+	void worker_loop(const int& band);
+	void run_band(const int& band);
+
+private:
+	static constexpr int MAX_POOL_WORKERS = 3;
+
+	std::vector<std::thread> workers = std::vector<std::thread>();
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	//the job being run, workers pick it up when generation moves on
+	band_job job = nullptr;
+	void* context = nullptr;
+	int rows = 0;
+	uint64_t generation = 0;
+	int bands_left = 0;
+	bool stopping = false;
+};
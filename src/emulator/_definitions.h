@@ -1,21 +1,25 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 typedef uint8_t byte;
 typedef uint16_t ushort;
 typedef int8_t sbyte;
 
+//register pairs share storage with their 8 bit halves, the low register comes first in memory on little endian hosts
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define SB_REGISTER_PAIR(high, low) union { struct { byte high; byte low; }; ushort high##low = 0x0000; }
+#else
+#define SB_REGISTER_PAIR(high, low) union { struct { byte low; byte high; }; ushort high##low = 0x0000; }
+#endif
+
 struct cpu_data {
-	byte a = 0x00;
-	byte f = 0x00;
-	byte b = 0x00;
-	byte c = 0x00;
-	byte d = 0x00;
-	byte e = 0x00;
-	byte h = 0x00;
-	byte l = 0x00;
+	SB_REGISTER_PAIR(a, f);
+	SB_REGISTER_PAIR(b, c);
+	SB_REGISTER_PAIR(d, e);
+	SB_REGISTER_PAIR(h, l);
 
 	ushort pc = 0x0000;
 	ushort sp = 0x0000;
@@ -40,6 +44,15 @@ enum cpu_flags {
 	flags_CARRY = 4
 };
 
+//last flag setting alu operation, flags are only worked out from it when read
+enum lazy_flag_ops {
+	lazy_NONE = 0,
+	lazy_ADD = 1,
+	lazy_SUB = 2,
+	lazy_AND = 3,
+	lazy_OR = 4,
+};
+
 enum cpu_instructions {
 	inst_NOOP = 0x00,
 	inst_LD_BC_N16 = 0x01,
@@ -640,6 +653,124 @@ enum io_addresses {
 	io_BANK = 0x50,
 };
 
+enum cpu_engines {
+	engine_INTERPRETER = 0,
+	engine_CACHED = 1,
+};
+
+//host time buckets for the performance counters
+enum perf_components {
+	perf_CPU = 0,
+	perf_PPU = 1,
+	perf_TIMERS = 2,
+	perf_DMA = 3,
+	perf_TEXTURE_UPLOAD = 4,
+	perf_IMGUI = 5,
+	perf_COMPONENT_COUNT = 6,
+};
+
+//counters for one emulated frame (vblank to vblank)
+struct perf_frame {
+	uint64_t host_ns[perf_COMPONENT_COUNT] = {};
+	uint64_t cycles = 0;
+	uint64_t instructions = 0;
+	uint64_t bus_reads = 0;
+	uint64_t bus_writes = 0;
+	//heap activity on the driving thread, only counted with SHARPBOY_ALLOC_TRACKING
+	uint64_t allocations = 0;
+	uint64_t allocated_bytes = 0;
+};
+
+struct perf_stats {
+	perf_frame last_frame = perf_frame();
+	uint64_t frame_count = 0;
+	double cycles_per_second = 0.0;
+	double frames_per_second = 0.0;
+};
+
+//frames from a host button press to the end of the first emulated frame whose JOYP reads returned it
+struct input_latency_stats {
+	int last_frames = -1;
+	uint64_t samples = 0;
+	uint64_t total_frames = 0;
+};
+
+//state hashing for the divergence finder, mixes 8 bytes at a time so whole ram blocks hash cheaply
+const uint64_t STATE_HASH_SEED = 0xcbf29ce484222325ull;
+
+inline uint64_t hash_state_bytes(uint64_t hash, const void* data, const size_t& size) {
+	const byte* bytes = static_cast<const byte*>(data);
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		uint64_t word = 0;
+		memcpy(&word, bytes + i, 8);
+		hash = (hash ^ word) * 0x100000001b3ull;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; i++) {
+		hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+template <typename T>
+inline uint64_t hash_state_value(const uint64_t& hash, const T& value) {
+	return hash_state_bytes(hash, &value, sizeof(T));
+}
+
+enum memory_page_flags {
+	page_NONE = 0x00,
+	page_CODE = 0x01,
+	page_WATCH_READ = 0x02,
+	page_WATCH_WRITE = 0x04,
+	page_DISASSEMBLED = 0x08,
+};
+
+//how an instruction's immediate bytes are shown by the disassembler (see Opcode_info.h)
+enum opcode_operands {
+	opnd_NONE = 0,
+	opnd_N8 = 1,
+	opnd_N16 = 2,
+	opnd_A8 = 3,
+	opnd_A16 = 4,
+	opnd_E8 = 5,
+	opnd_E8_SIGNED = 6,
+};
+
+//per instruction work in CPU::execute_hooked_step, which only runs in place of execute_step while the mask is not empty
+enum cpu_step_hooks {
+	hook_NONE = 0x00,
+	hook_TRACE = 0x01,
+	hook_BREAKPOINTS = 0x02,
+};
+
+//debugger
+enum watch_access {
+	watch_READ = 0x01,
+	watch_WRITE = 0x02,
+	watch_ACCESS = 0x03,
+};
+
+enum watch_conditions {
+	condition_ANY = 0,
+	condition_EQUAL = 1,
+	condition_NOT_EQUAL = 2,
+};
+
+enum debug_break_reasons {
+	break_NONE = 0,
+	break_BREAKPOINT = 1,
+	break_WATCH_READ = 2,
+	break_WATCH_WRITE = 3,
+};
+
+enum debug_step_modes {
+	step_INSTRUCTION = 0,
+	step_SCANLINE = 1,
+	step_FRAME = 2,
+};
+
 enum cartridge_types {
 	int_NONE = 0xff,
 	ROM_ONLY = 0x00,
@@ -690,6 +821,19 @@ struct rom_header {
 	byte checksum_byte = 0x00;
 };
 
+//joypad buttons as held on the host (1 = pressed), directions are JOYP's low nibble when bit 4 selects them, actions when bit 5 does
+enum joypad_buttons {
+	button_NONE = 0x00,
+	button_RIGHT = 0x01,
+	button_LEFT = 0x02,
+	button_UP = 0x04,
+	button_DOWN = 0x08,
+	button_A = 0x10,
+	button_B = 0x20,
+	button_SELECT = 0x40,
+	button_START = 0x80,
+};
+
 enum interrupt_types {
 	int_VBLANK = 0,
 	int_LCD = 1,
@@ -706,6 +850,52 @@ enum ppu_modes {
 	ppu_VBLANK = 1
 };
 
+//rgba colours for the 4 dmg shades when a frame is presented (see Shades.h)
+enum colour_schemes {
+	scheme_GREY = 0,
+	scheme_GREEN = 1,
+	scheme_POCKET = 2,
+	scheme_COUNT = 3,
+};
+
+//pixel layouts the shades can be expanded into, picked to match what the renderer takes natively
+enum frame_formats {
+	frame_RGBA8888 = 0,
+	frame_ARGB8888 = 1,
+	frame_ABGR8888 = 2,
+	frame_XRGB8888 = 3,
+	frame_RGB565 = 4,
+	frame_COUNT = 5,
+};
+
+//cpu side post processing between the shades and the screen texture (see Frame_filter.h)
+enum frame_filters {
+	filter_NONE = 0,
+	filter_SCALE2X = 1,
+	filter_SCALE3X = 2,
+	filter_SCALE2X_SMOOTH = 3,
+	filter_LCD_GRID = 4,
+	filter_GHOSTING = 5,
+	filter_COUNT = 6,
+};
+
+//what the ppu debug views have to redraw, every viewer collects its own set (see PPU::take_view_changes)
+enum ppu_view_changes {
+	view_NONE = 0x00,
+	view_TILE_DATA = 0x01,
+	view_MAP_9800 = 0x02,
+	view_MAP_9C00 = 0x04,
+	view_OAM = 0x08,
+	view_REGISTERS = 0x10, //lcdc + palettes
+	view_ALL = 0x1f,
+};
+
+enum ppu_viewers {
+	viewer_BG_MAPS = 0,
+	viewer_OAM = 1,
+	viewer_COUNT = 2,
+};
+
 enum ppu_mode_lengths {
 	ppu_OAM_LENGTH = 80,
 	ppu_DRAW_LENGTH_MIN = 172,
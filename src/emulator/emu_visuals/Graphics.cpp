@@ -1,5 +1,16 @@
 #include "Graphics.h"
 #include "../../Application.h"
+#include <algorithm>
+#include <vector>
+
+//sdl's name for each frame_formats entry
+static const SDL_PixelFormat frame_pixel_formats[frame_COUNT] = {
+	SDL_PIXELFORMAT_RGBA8888,
+	SDL_PIXELFORMAT_ARGB8888,
+	SDL_PIXELFORMAT_ABGR8888,
+	SDL_PIXELFORMAT_XRGB8888,
+	SDL_PIXELFORMAT_RGB565,
+};
 
 void initialise_ImGui_components(SDL_Window** window, SDL_Renderer** renderer) {
 	IMGUI_CHECKVERSION();
@@ -12,12 +23,12 @@ void initialise_ImGui_components(SDL_Window** window, SDL_Renderer** renderer) {
 	ImGui_ImplSDLRenderer3_Init(*renderer);
 }
 
-void init_main_SDL_components(bool& sdl_running, SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, SDL_Texture** debug_tilemap_texture){
+void init_main_SDL_components(bool& sdl_running, SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, SDL_Texture** debug_tilemap_texture, frame_formats& frame_format){
 	sdl_running = false;
 	printf("+----------------------------------------+\n");
 	printf("[SB] Starting SDL initialisation...\n");
 
-	if (!SDL_Init(SDL_INIT_VIDEO)) {
+	if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD)) {
 		printf("[SB] Failed SDL initialisation, error: %s\n", SDL_GetError());
 		sdl_running = false;
 		return;
@@ -43,7 +54,8 @@ void init_main_SDL_components(bool& sdl_running, SDL_Window** window, SDL_Render
 		return;
 	}
 
-	*texture = SDL_CreateTexture(*renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, 160, 144);
+	frame_format = choose_frame_format(renderer);
+	*texture = SDL_CreateTexture(*renderer, frame_pixel_formats[frame_format], SDL_TEXTUREACCESS_STREAMING, 160, 144);
 	if (*texture == nullptr) {
 		close_SDL(window, renderer, texture, debug_tilemap_texture);
 
@@ -71,9 +83,40 @@ void init_main_SDL_components(bool& sdl_running, SDL_Window** window, SDL_Render
 	sdl_running = true;
 }
 
-//take emu pointer to run function on key presses etc, called from emu run
-void poll_SDL_events(SDL_Event* event, std::shared_ptr<Application> app) {
+//the renderer lists its texture formats best first, take the first one the shade expander can write so sdl never converts on upload
+frame_formats choose_frame_format(SDL_Renderer** renderer) {
+	const SDL_PixelFormat* formats = (const SDL_PixelFormat*)SDL_GetPointerProperty(SDL_GetRendererProperties(*renderer), SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, nullptr);
+	if (formats != nullptr) {
+		for (; *formats != SDL_PIXELFORMAT_UNKNOWN; formats++) {
+			for (int i = 0; i < frame_COUNT; i++) {
+				if (frame_pixel_formats[i] == *formats) {
+					printf("[SB] Frame format: %s\n", SDL_GetPixelFormatName(*formats));
+					return (frame_formats)i;
+				}
+			}
+		}
+	}
+
+	printf("[SB] No native frame format found, falling back to RGBA8888\n");
+	return frame_RGBA8888;
+}
+
+float get_display_refresh_rate(SDL_Window** window) {
+	const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(*window));
+	if (mode == nullptr || mode->refresh_rate <= 0.0f) {
+		return 60.0f;
+	}
+
+	return mode->refresh_rate;
+}
+
+static std::vector<SDL_Gamepad*> open_gamepads = std::vector<SDL_Gamepad*>();
+
+//take emu pointer to run function on key presses etc, called from emu run, returns whether anything came in
+bool poll_SDL_events(SDL_Event* event, std::shared_ptr<Application> app) {
+	bool had_events = false;
 	while (SDL_PollEvent(event)) {
+		had_events = true;
 		ImGui_ImplSDL3_ProcessEvent(event);
 
 		switch (event->type) {
@@ -81,6 +124,12 @@ void poll_SDL_events(SDL_Event* event, std::shared_ptr<Application> app) {
 			app->close();
 			break;
 
+		case SDL_EVENT_WINDOW_EXPOSED:
+		case SDL_EVENT_WINDOW_RESIZED:
+		case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+			app->mark_window_dirty();
+			break;
+
 		case SDL_EVENT_KEY_DOWN:
 			switch (event->key.key) {
 			case SDLK_SPACE:
@@ -89,11 +138,71 @@ void poll_SDL_events(SDL_Event* event, std::shared_ptr<Application> app) {
 
 			default: break;
 			}
+			app->refresh_joypad(false);
+			break;
+
+		case SDL_EVENT_KEY_UP:
+		case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+		case SDL_EVENT_GAMEPAD_BUTTON_UP:
+			app->refresh_joypad(false);
+			break;
+
+		case SDL_EVENT_GAMEPAD_ADDED: {
+			SDL_Gamepad* gamepad = SDL_OpenGamepad(event->gdevice.which);
+			if (gamepad != nullptr) {
+				open_gamepads.push_back(gamepad);
+			}
+			break;
+		}
+
+		case SDL_EVENT_GAMEPAD_REMOVED:
+			for (auto it = open_gamepads.begin(); it != open_gamepads.end(); it++) {
+				if (SDL_GetGamepadID(*it) == event->gdevice.which) {
+					SDL_CloseGamepad(*it);
+					open_gamepads.erase(it);
+					break;
+				}
+			}
+			app->refresh_joypad(false);
 			break;
 
 		default: break;
 		}
 	}
+
+	return had_events;
+}
+
+//held buttons from the keyboard (arrows, X = A, Z = B, Enter = Start, Backspace/Right Shift = Select) and any gamepad
+//reads sdl's current state rather than events, so it is only as stale as the last pump
+byte read_host_buttons() {
+	byte buttons = button_NONE;
+
+	//typing into a debug window is not game input
+	if (!ImGui::GetIO().WantCaptureKeyboard) {
+		const bool* keys = SDL_GetKeyboardState(nullptr);
+		if (keys[SDL_SCANCODE_RIGHT]) buttons |= button_RIGHT;
+		if (keys[SDL_SCANCODE_LEFT]) buttons |= button_LEFT;
+		if (keys[SDL_SCANCODE_UP]) buttons |= button_UP;
+		if (keys[SDL_SCANCODE_DOWN]) buttons |= button_DOWN;
+		if (keys[SDL_SCANCODE_X]) buttons |= button_A;
+		if (keys[SDL_SCANCODE_Z]) buttons |= button_B;
+		if (keys[SDL_SCANCODE_BACKSPACE] || keys[SDL_SCANCODE_RSHIFT]) buttons |= button_SELECT;
+		if (keys[SDL_SCANCODE_RETURN]) buttons |= button_START;
+	}
+
+	for (SDL_Gamepad* gamepad : open_gamepads) {
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_DPAD_RIGHT)) buttons |= button_RIGHT;
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_DPAD_LEFT)) buttons |= button_LEFT;
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_DPAD_UP)) buttons |= button_UP;
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_DPAD_DOWN)) buttons |= button_DOWN;
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_EAST)) buttons |= button_A;
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_SOUTH)) buttons |= button_B;
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_BACK)) buttons |= button_SELECT;
+		if (SDL_GetGamepadButton(gamepad, SDL_GAMEPAD_BUTTON_START)) buttons |= button_START;
+	}
+
+	return buttons;
 }
 
 
@@ -107,14 +216,93 @@ void present_renderer(SDL_Renderer** renderer) {
 	SDL_RenderPresent(*renderer);
 }
 
-void update_gb_texture(SDL_Texture** texture, SDL_Renderer** renderer, std::shared_ptr<Application> app) {
-	if (*texture == nullptr) {
-		*texture = SDL_CreateTexture(*renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, 160, 144);
+//returns false when nothing changed, the texture is left alone and there is nothing new to present
+bool update_gb_texture(SDL_Texture** texture, SDL_Renderer** renderer, std::shared_ptr<Application> app) {
+	static int uploaded_scheme = -1;
+	static int uploaded_filter = filter_NONE;
+	static int ghost_frames_left = 0;
+
+	int first_line = 0;
+	int last_line = 0;
+	bool dirty = app->take_dirty_lines(first_line, last_line);
+
+	//the filters average 8 bit channels, a 16 bit renderer gets a 32 bit texture and converts it itself
+	const frame_filters filter = (frame_filters)app->frame_filter;
+	const int scale = frame_filter_table[filter].scale;
+	frame_formats format = app->frame_format;
+	if (filter != filter_NONE && get_frame_format_bytes(format) != 4) {
+		format = frame_XRGB8888;
 	}
 
-	const std::array<uint32_t, 160 * 144>& buffer = app->get_frame_buffer();
-	SDL_UpdateTexture(*texture, NULL, buffer.data(), 160 * sizeof(uint32_t));
+	//a new texture, filter or scheme needs every line, not just the ones the ppu changed
+	if (*texture == nullptr || filter != uploaded_filter || app->colour_scheme != uploaded_scheme) {
+		if (*texture != nullptr && filter != uploaded_filter) {
+			SDL_DestroyTexture(*texture);
+			*texture = nullptr;
+		}
+		if (*texture == nullptr) {
+			*texture = SDL_CreateTexture(*renderer, frame_pixel_formats[format], SDL_TEXTUREACCESS_STREAMING, 160 * scale, 144 * scale);
+		}
+		if (filter != filter_NONE) {
+			app->get_frame_filter()->reset_history();
+		}
 
+		uploaded_scheme = app->colour_scheme;
+		uploaded_filter = filter;
+		first_line = 0;
+		last_line = 143;
+		dirty = true;
+	}
+
+	//ghosting keeps fading towards a screen that stopped changing, it has settled after 8 halvings
+	if (filter == filter_GHOSTING) {
+		if (dirty) {
+			ghost_frames_left = 8;
+		}
+		else if (ghost_frames_left > 0) {
+			ghost_frames_left--;
+			dirty = true;
+		}
+	}
+
+	if (!dirty) {
+		return false;
+	}
+
+	const std::array<byte, 160 * 144>& shades = app->get_shade_buffer();
+	const std::array<uint32_t, 4> colours = convert_colours(colour_scheme_table[app->colour_scheme].colours, format);
+
+	//filtered frames are redone whole, the kernels read the lines around each one
+	if (filter != filter_NONE) {
+		const uint32_t alpha_mask = convert_colours({ 0x000000ff, 0x000000ff, 0x000000ff, 0x000000ff }, format)[0];
+		void* pixels = nullptr;
+		int pitch = 0;
+		if (SDL_LockTexture(*texture, nullptr, &pixels, &pitch)) {
+			app->get_frame_filter()->apply(filter, shades.data(), colours, alpha_mask, (uint32_t*)pixels, pitch);
+			SDL_UnlockTexture(*texture);
+		}
+		return true;
+	}
+
+	//shades go straight into the locked band in the texture's own format, one pass and no conversion inside sdl
+	const int row_bytes = 160 * get_frame_format_bytes(format);
+	const int line_count = last_line - first_line + 1;
+	const SDL_Rect band = { 0, first_line, 160, line_count };
+	void* pixels = nullptr;
+	int pitch = 0;
+	if (SDL_LockTexture(*texture, &band, &pixels, &pitch)) {
+		if (pitch == row_bytes) {
+			write_shades(shades.data() + first_line * 160, pixels, (size_t)line_count * 160, colours, format);
+		}
+		else {
+			for (int y = 0; y < line_count; y++) {
+				write_shades(shades.data() + (first_line + y) * 160, (byte*)pixels + y * pitch, 160, colours, format);
+			}
+		}
+		SDL_UnlockTexture(*texture);
+	}
+
+	return true;
 }
 
 void draw_gb_frame(SDL_Texture** texture, SDL_Renderer** renderer) {
@@ -179,9 +367,44 @@ void draw_current_rom_information_gui(std::shared_ptr<Application> app) {
 			printf("[SB] Saving not impl yet...\n");
 		}
 
+		ImGui::SeparatorText("CPU Engine");
+		int engine = (int)app->get_cpu_engine();
+		if (ImGui::RadioButton("Interpreter", &engine, engine_INTERPRETER)) {
+			app->set_cpu_engine(engine_INTERPRETER);
+		}
+		ImGui::SameLine();
+		if (ImGui::RadioButton("Cached Blocks", &engine, engine_CACHED)) {
+			app->set_cpu_engine(engine_CACHED);
+		}
+
+		ImGui::SeparatorText("Display");
+		const char* scheme_names[scheme_COUNT];
+		for (int i = 0; i < scheme_COUNT; i++) {
+			scheme_names[i] = colour_scheme_table[i].name;
+		}
+		ImGui::Combo("Colours", &app->colour_scheme, scheme_names, scheme_COUNT);
+
+		const char* filter_names[filter_COUNT];
+		for (int i = 0; i < filter_COUNT; i++) {
+			filter_names[i] = frame_filter_table[i].name;
+		}
+		ImGui::Combo("Filter", &app->frame_filter, filter_names, filter_COUNT);
+
 		ImGui::SeparatorText("Debug Options");
 		ImGui::Checkbox("Basic Debug Information", &app->basic_debug_shown);
 		ImGui::Checkbox("PPU Debug Information", &app->ppu_debug_shown);
+		ImGui::Checkbox("BG Map Viewer", &app->bg_map_viewer_shown);
+		ImGui::Checkbox("OAM Viewer", &app->oam_viewer_shown);
+		ImGui::Checkbox("Performance", &app->performance_shown);
+		ImGui::Checkbox("Debugger", &app->debugger_shown);
+		ImGui::Checkbox("Disassembly", &app->disassembly_shown);
+		ImGui::Checkbox("Memory Viewer", &app->memory_viewer_shown);
+#ifdef SHARPBOY_PROFILER
+		ImGui::Checkbox("Profiler", &app->profiler_shown);
+#endif
+#ifdef SHARPBOY_HEATMAP
+		ImGui::Checkbox("Memory Heatmap", &app->heatmap_shown);
+#endif
 	}
 	else {
 		ImGui::Text("Load a ROM to see this information!");
@@ -191,14 +414,33 @@ void draw_current_rom_information_gui(std::shared_ptr<Application> app) {
 void draw_ppu_tilemap(std::shared_ptr<Application> app, SDL_Texture** debug_tilemap_texture) {
 	if (app->emu_running) {
 		if (app->ppu_debug_shown) {
-			for (int i = 0; i < 384; i++) {
-				std::array<uint32_t, 64> tile{};
-				tile = app->get_tile_map_data(i);
-				int tx = (i % 16) * 8;
-				int ty = (i / 16) * 8;
-
-				SDL_Rect dst = { tx, ty, 8, 8 };
-				SDL_UpdateTexture(*debug_tilemap_texture, &dst, tile.data(), 8 * sizeof(uint32_t));
+			//16x24 tiles, only tiles written since the last upload (or all of them after a palette change) are redrawn
+			static std::array<uint32_t, 128 * 192> tile_pixels = std::array<uint32_t, 128 * 192>();
+			static std::array<bool, TILE_CACHE_TILES> dirty_tiles = std::array<bool, TILE_CACHE_TILES>();
+
+			if (app->take_viewer_dirty_tiles(dirty_tiles)) {
+				int first_row = 24;
+				int last_row = -1;
+				for (int i = 0; i < TILE_CACHE_TILES; i++) {
+					if (dirty_tiles[i]) {
+						app->fill_tile_pixels(i, &tile_pixels[(i / 16) * 8 * 128 + (i % 16) * 8], 128);
+						first_row = std::min(first_row, i / 16);
+						last_row = std::max(last_row, i / 16);
+					}
+				}
+
+				//locked pixels are write only, so the rows holding dirty tiles are copied over whole from tile_pixels
+				if (last_row >= 0) {
+					SDL_Rect rows = { 0, first_row * 8, 128, (last_row - first_row + 1) * 8 };
+					void* locked = nullptr;
+					int pitch = 0;
+					if (SDL_LockTexture(*debug_tilemap_texture, &rows, &locked, &pitch)) {
+						for (int y = 0; y < rows.h; y++) {
+							memcpy((byte*)locked + y * pitch, &tile_pixels[(rows.y + y) * 128], 128 * sizeof(uint32_t));
+						}
+						SDL_UnlockTexture(*debug_tilemap_texture);
+					}
+				}
 			}
 
 			ImGui::Begin("Sharpboy++ Debug | PPU Information");
@@ -211,6 +453,129 @@ void draw_ppu_tilemap(std::shared_ptr<Application> app, SDL_Texture** debug_tile
 	}
 }
 
+void draw_bg_map_viewer(std::shared_ptr<Application> app) {
+	if (app->emu_initialised) {
+		if (app->bg_map_viewer_shown) {
+			static SDL_Texture* map_texture = nullptr;
+			if (map_texture == nullptr) {
+				map_texture = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, 256, 256);
+				SDL_SetTextureScaleMode(map_texture, SDL_SCALEMODE_NEAREST);
+			}
+
+			//recomposited only when the shown map, tile data or lcdc/palettes changed, scrolling just moves the rectangle
+			static std::array<uint32_t, 256 * 256> map_pixels = std::array<uint32_t, 256 * 256>();
+			static int map = 0;
+			static bool redraw = true;
+
+			byte changes = app->take_ppu_view_changes(viewer_BG_MAPS);
+			byte map_change = map == 0 ? view_MAP_9800 : view_MAP_9C00;
+			if (redraw || (changes & (map_change | view_TILE_DATA | view_REGISTERS))) {
+				app->fill_map_pixels(map, map_pixels.data());
+				SDL_UpdateTexture(map_texture, nullptr, map_pixels.data(), 256 * sizeof(uint32_t));
+				redraw = false;
+			}
+
+			ImGui::Begin("Sharpboy++ Debug | BG Maps");
+			{
+				redraw |= ImGui::RadioButton("0x9800", &map, 0);
+				ImGui::SameLine();
+				redraw |= ImGui::RadioButton("0x9C00", &map, 1);
+
+				byte scx = app->read_io_register(io_SCX);
+				byte scy = app->read_io_register(io_SCY);
+				bool shown_by_bg = ((app->read_io_register(io_LCDC) & 0x08) != 0) == (map == 1);
+				ImGui::Text("SCX: %d SCY: %d%s", scx, scy, shown_by_bg ? " (background map)" : "");
+
+				const float scale = 2.0f;
+				ImVec2 origin = ImGui::GetCursorScreenPos();
+				ImGui::Image((ImTextureID)map_texture, ImVec2(256 * scale, 256 * scale));
+
+				//the 160x144 viewport wraps around the map edges, so draw it up to 4 times clipped to the image
+				if (shown_by_bg) {
+					ImDrawList* draw_list = ImGui::GetWindowDrawList();
+					draw_list->PushClipRect(origin, ImVec2(origin.x + 256 * scale, origin.y + 256 * scale), true);
+					for (int wrap_y = 0; wrap_y < 2; wrap_y++) {
+						for (int wrap_x = 0; wrap_x < 2; wrap_x++) {
+							float x = origin.x + (scx - wrap_x * 256) * scale;
+							float y = origin.y + (scy - wrap_y * 256) * scale;
+							draw_list->AddRect(ImVec2(x, y), ImVec2(x + 160 * scale, y + 144 * scale), IM_COL32(255, 60, 60, 255), 0.0f, 0, 2.0f);
+						}
+					}
+					draw_list->PopClipRect();
+				}
+			}
+			ImGui::End();
+		}
+	}
+}
+
+void draw_oam_viewer(std::shared_ptr<Application> app) {
+	if (app->emu_initialised) {
+		if (app->oam_viewer_shown) {
+			//40 sprites as 8x16 cells, 10 per row
+			static SDL_Texture* sprite_texture = nullptr;
+			if (sprite_texture == nullptr) {
+				sprite_texture = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, 80, 64);
+				SDL_SetTextureScaleMode(sprite_texture, SDL_SCALEMODE_NEAREST);
+				SDL_SetTextureBlendMode(sprite_texture, SDL_BLENDMODE_BLEND);
+			}
+
+			static std::array<uint32_t, 80 * 64> sprite_pixels = std::array<uint32_t, 80 * 64>();
+			static std::array<byte, OAM_SIZE> oam = std::array<byte, OAM_SIZE>();
+
+			//the table and sprite images only change with oam, tile data or lcdc/palettes
+			byte changes = app->take_ppu_view_changes(viewer_OAM);
+			if (changes & (view_OAM | view_TILE_DATA | view_REGISTERS)) {
+				oam = app->get_oam();
+				for (int i = 0; i < 40; i++) {
+					app->fill_sprite_pixels(oam[i * 4 + 2], oam[i * 4 + 3], &sprite_pixels[(i / 10) * 16 * 80 + (i % 10) * 8], 80);
+				}
+				SDL_UpdateTexture(sprite_texture, nullptr, sprite_pixels.data(), 80 * sizeof(uint32_t));
+			}
+
+			ImGui::Begin("Sharpboy++ Debug | OAM");
+			{
+				if (ImGui::BeginTable("##OamEntries", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+					ImGui::TableSetupColumn("#");
+					ImGui::TableSetupColumn("Sprite");
+					ImGui::TableSetupColumn("X");
+					ImGui::TableSetupColumn("Y");
+					ImGui::TableSetupColumn("Tile");
+					ImGui::TableSetupColumn("Flags");
+					ImGui::TableHeadersRow();
+
+					ImGuiListClipper clipper;
+					clipper.Begin(40);
+					while (clipper.Step()) {
+						for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+							byte attributes = oam[i * 4 + 3];
+							float u = (i % 10) * 8 / 80.0f;
+							float v = (i / 10) * 16 / 64.0f;
+
+							ImGui::TableNextRow();
+							ImGui::TableNextColumn();
+							ImGui::Text("%d", i);
+							ImGui::TableNextColumn();
+							ImGui::Image((ImTextureID)sprite_texture, ImVec2(16, 32), ImVec2(u, v), ImVec2(u + 8 / 80.0f, v + 16 / 64.0f));
+							ImGui::TableNextColumn();
+							ImGui::Text("%d", oam[i * 4 + 1] - 8);
+							ImGui::TableNextColumn();
+							ImGui::Text("%d", oam[i * 4] - 16);
+							ImGui::TableNextColumn();
+							ImGui::Text("%02X", oam[i * 4 + 2]);
+							ImGui::TableNextColumn();
+							ImGui::Text("%s%s%s OBP%d", (attributes & 0x80) ? "P" : "-", (attributes & 0x40) ? "Y" : "-", (attributes & 0x20) ? "X" : "-", (attributes & 0x10) ? 1 : 0);
+						}
+					}
+					clipper.End();
+					ImGui::EndTable();
+				}
+			}
+			ImGui::End();
+		}
+	}
+}
+
 void draw_cpu_debugger(std::shared_ptr<Application> app) {
 	if (app->emu_initialised) {
 		if (app->basic_debug_shown) {
@@ -218,10 +583,10 @@ void draw_cpu_debugger(std::shared_ptr<Application> app) {
 			ImGui::Begin("Sharpboy++ Debug | CPU Information");
 			{
 				ImGui::SeparatorText("Registers");
-				ImGui::Text("AF: 0x%02X%02X", data.a, data.f);
-				ImGui::Text("BC: 0x%02X%02X", data.b, data.c);
-				ImGui::Text("DE: 0x%02X%02X", data.d, data.e);
-				ImGui::Text("HL: 0x%02X%02X", data.h, data.l);
+				ImGui::Text("AF: 0x%04X", data.af);
+				ImGui::Text("BC: 0x%04X", data.bc);
+				ImGui::Text("DE: 0x%04X", data.de);
+				ImGui::Text("HL: 0x%04X", data.hl);
 
 				ImGui::Separator();
 				ImGui::Text("PC: 0x%04X", data.pc);
@@ -230,12 +595,524 @@ void draw_cpu_debugger(std::shared_ptr<Application> app) {
 				ImGui::Separator();
 				ImGui::Checkbox("Interrupt Master Enable", &data.ime);
 				ImGui::Checkbox("Halted", &data.halted);
+
+				ImGui::SeparatorText("Instruction Trace");
+				if (!app->is_instruction_trace_running()) {
+					if (ImGui::Button("Start Trace")) {
+						app->start_instruction_trace("trace.sbt");
+					}
+				}
+				else if (ImGui::Button("Stop Trace")) {
+					app->stop_instruction_trace();
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Export Doctor Log")) {
+					Instruction_trace::convert_to_doctor_log("trace.sbt", "trace.log");
+				}
 			}
 			ImGui::End();
 		}
 	}
 }
 
+void draw_debugger(std::shared_ptr<Application> app) {
+	if (app->emu_initialised) {
+		if (app->debugger_shown) {
+			const Debugger* debugger = app->get_debugger();
+
+			static char breakpoint_address[5] = "0100";
+			static int breakpoint_bank = -1;
+			static char watch_address[5] = "c000";
+			static int watch_access_index = 1;
+			static int watch_condition = condition_ANY;
+			static char watch_value[3] = "00";
+
+			ImGui::Begin("Sharpboy++ Debug | Debugger");
+			{
+				ImGui::SeparatorText("Execution");
+				const debug_break& last_break = debugger->get_last_break();
+				if (app->emu_running) {
+					ImGui::Text("Running");
+				}
+				else if (debugger->is_break_pending() && last_break.reason == break_BREAKPOINT) {
+					ImGui::Text("Stopped at breakpoint $%04X", last_break.address);
+				}
+				else if (debugger->is_break_pending()) {
+					ImGui::Text("Stopped on %s of $%04X (value $%02X)", last_break.reason == break_WATCH_READ ? "read" : "write", last_break.address, last_break.value);
+				}
+				else {
+					ImGui::Text("Paused");
+				}
+				ImGui::Text("PC: 0x%04X", app->get_cpu_data().pc);
+
+				if (ImGui::Button(app->emu_running ? "Pause" : "Continue")) {
+					app->emu_running = !app->emu_running;
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Step Instruction")) {
+					app->debug_step(step_INSTRUCTION);
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Step Scanline")) {
+					app->debug_step(step_SCANLINE);
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Step Frame")) {
+					app->debug_step(step_FRAME);
+				}
+
+				ImGui::SeparatorText("Breakpoints");
+				ImGui::PushItemWidth(80);
+				ImGui::InputText("Address##Breakpoint", breakpoint_address, sizeof(breakpoint_address), ImGuiInputTextFlags_CharsHexadecimal);
+				ImGui::SameLine();
+				ImGui::InputInt("Bank (-1 any)", &breakpoint_bank);
+				ImGui::PopItemWidth();
+				breakpoint_bank = std::clamp(breakpoint_bank, -1, 511);
+				ImGui::SameLine();
+				if (ImGui::Button("Add##Breakpoint")) {
+					app->add_breakpoint((ushort)strtoul(breakpoint_address, nullptr, 16), breakpoint_bank);
+				}
+
+				int remove_breakpoint = -1;
+				const std::vector<breakpoint>& breakpoints = debugger->get_breakpoints();
+				for (int i = 0; i < (int)breakpoints.size(); i++) {
+					ImGui::PushID(i);
+					if (breakpoints[i].bank < 0) {
+						ImGui::Text("--:%04X  hits: %llu", breakpoints[i].address, (unsigned long long)breakpoints[i].hits);
+					}
+					else {
+						ImGui::Text("%02X:%04X  hits: %llu", breakpoints[i].bank, breakpoints[i].address, (unsigned long long)breakpoints[i].hits);
+					}
+					ImGui::SameLine();
+					if (ImGui::SmallButton("Remove")) {
+						remove_breakpoint = i;
+					}
+					ImGui::PopID();
+				}
+				if (remove_breakpoint >= 0) {
+					app->remove_breakpoint(remove_breakpoint);
+				}
+
+				ImGui::SeparatorText("Watchpoints");
+				const char* access_names[] = { "Read", "Write", "Access" };
+				const char* condition_names[] = { "Any", "==", "!=" };
+				ImGui::PushItemWidth(80);
+				ImGui::InputText("Address##Watchpoint", watch_address, sizeof(watch_address), ImGuiInputTextFlags_CharsHexadecimal);
+				ImGui::SameLine();
+				ImGui::Combo("##WatchAccess", &watch_access_index, access_names, 3);
+				ImGui::SameLine();
+				ImGui::Combo("##WatchCondition", &watch_condition, condition_names, 3);
+				if (watch_condition != condition_ANY) {
+					ImGui::SameLine();
+					ImGui::InputText("Value##Watchpoint", watch_value, sizeof(watch_value), ImGuiInputTextFlags_CharsHexadecimal);
+				}
+				ImGui::PopItemWidth();
+				ImGui::SameLine();
+				if (ImGui::Button("Add##Watchpoint")) {
+					app->add_watchpoint((ushort)strtoul(watch_address, nullptr, 16), (watch_access)(watch_access_index + 1), (watch_conditions)watch_condition, (byte)strtoul(watch_value, nullptr, 16));
+				}
+
+				int remove_watchpoint = -1;
+				const std::vector<watchpoint>& watchpoints = debugger->get_watchpoints();
+				for (int i = 0; i < (int)watchpoints.size(); i++) {
+					const watchpoint& entry = watchpoints[i];
+					ImGui::PushID(1000 + i);
+					if (entry.condition == condition_ANY) {
+						ImGui::Text("%s $%04X  hits: %llu", access_names[entry.access - 1], entry.address, (unsigned long long)entry.hits);
+					}
+					else {
+						ImGui::Text("%s $%04X %s $%02X  hits: %llu", access_names[entry.access - 1], entry.address, condition_names[entry.condition], entry.value, (unsigned long long)entry.hits);
+					}
+					ImGui::SameLine();
+					if (ImGui::SmallButton("Remove")) {
+						remove_watchpoint = i;
+					}
+					ImGui::PopID();
+				}
+				if (remove_watchpoint >= 0) {
+					app->remove_watchpoint(remove_watchpoint);
+				}
+			}
+			ImGui::End();
+		}
+	}
+}
+
+void draw_disassembly(std::shared_ptr<Application> app) {
+	if (app->emu_initialised) {
+		if (app->disassembly_shown) {
+			static bool follow_pc = true;
+			static char view_address[5] = "0100";
+			static int lines_before = 8;
+			static int lines_after = 24;
+
+			ushort pc = app->get_cpu_data().pc;
+			ushort address = follow_pc ? pc : (ushort)strtoul(view_address, nullptr, 16);
+
+			ImGui::Begin("Sharpboy++ Debug | Disassembly");
+			{
+				ImGui::Checkbox("Follow PC", &follow_pc);
+				if (!follow_pc) {
+					ImGui::SameLine();
+					ImGui::PushItemWidth(80);
+					ImGui::InputText("Address##Disassembly", view_address, sizeof(view_address), ImGuiInputTextFlags_CharsHexadecimal);
+					ImGui::PopItemWidth();
+				}
+				ImGui::TextDisabled("Click a line to toggle a breakpoint");
+				ImGui::Separator();
+
+				//lines come from the disassembly cache, only redecoded after the memory under them is written
+				const std::vector<breakpoint>& breakpoints = app->get_debugger()->get_breakpoints();
+				const std::vector<disassembly_line>& lines = app->get_disassembly(address, lines_before, lines_after);
+				int toggle_address = -1;
+				int remove_index = -1;
+				for (const disassembly_line& line : lines) {
+					int breakpoint_index = -1;
+					for (int i = 0; i < (int)breakpoints.size(); i++) {
+						if (breakpoints[i].address == line.address) {
+							breakpoint_index = i;
+							break;
+						}
+					}
+
+					char bytes[12] = "";
+					for (int i = 0; i < line.length && i < 3; i++) {
+						snprintf(bytes + i * 3, sizeof(bytes) - i * 3, "%02X ", line.bytes[i]);
+					}
+
+					char label[80];
+					snprintf(label, sizeof(label), "%s%s %02X:%04X  %-9s %s##%04X", breakpoint_index >= 0 ? "*" : " ", line.address == pc ? ">" : " ", line.bank, line.address, bytes, line.text.data(), line.address);
+					if (ImGui::Selectable(label, line.address == pc)) {
+						toggle_address = line.address;
+						remove_index = breakpoint_index;
+					}
+				}
+
+				if (remove_index >= 0) {
+					app->remove_breakpoint(remove_index);
+				}
+				else if (toggle_address >= 0) {
+					app->add_breakpoint((ushort)toggle_address, -1);
+				}
+			}
+			ImGui::End();
+		}
+	}
+}
+
+void draw_memory_viewer(std::shared_ptr<Application> app) {
+	if (app->emu_initialised) {
+		if (app->memory_viewer_shown) {
+			static const char* region_names[] = { "ROM0 $0000", "ROM1 $4000", "VRAM $8000", "ERAM $A000", "WRAM $C000", "ECHO $E000", "OAM $FE00", "IO $FF00", "HRAM $FF80" };
+			static const ushort region_starts[] = { 0x0000, 0x4000, 0x8000, 0xa000, 0xc000, 0xe000, 0xfe00, 0xff00, 0xff80 };
+			static int region = 0;
+			static char goto_address[5] = "0000";
+			static int scroll_to_row = -1;
+			static int selected_address = -1;
+			static char edit_value[3] = "00";
+
+			const int BYTES_PER_ROW = 16;
+			const Memory_view& view = app->refresh_memory_view();
+			const std::array<byte, 0x10000>& bytes = view.get_bytes();
+
+			ImGui::Begin("Sharpboy++ Debug | Memory");
+			{
+				ImGui::PushItemWidth(120);
+				if (ImGui::Combo("Region", &region, region_names, 9)) {
+					scroll_to_row = region_starts[region] / BYTES_PER_ROW;
+				}
+				ImGui::PopItemWidth();
+
+				ImGui::SameLine();
+				ImGui::PushItemWidth(60);
+				if (ImGui::InputText("Go to", goto_address, sizeof(goto_address), ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue)) {
+					scroll_to_row = (int)strtoul(goto_address, nullptr, 16) / BYTES_PER_ROW;
+				}
+				ImGui::PopItemWidth();
+
+				//click a byte to pick it, then type the new value
+				if (selected_address >= 0) {
+					ImGui::Text("$%04X = %02X ->", selected_address, bytes[selected_address]);
+					ImGui::SameLine();
+					ImGui::PushItemWidth(40);
+					if (ImGui::InputText("##EditValue", edit_value, sizeof(edit_value), ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue)) {
+						app->edit_memory((ushort)selected_address, (byte)strtoul(edit_value, nullptr, 16));
+						selected_address = selected_address < 0xffff ? selected_address + 1 : -1;
+						if (selected_address >= 0) {
+							snprintf(edit_value, sizeof(edit_value), "%02X", bytes[selected_address]);
+							ImGui::SetKeyboardFocusHere(-1);
+						}
+					}
+					ImGui::PopItemWidth();
+				}
+				else {
+					ImGui::TextDisabled("Click a byte to edit it");
+				}
+				ImGui::Text("%d bytes changed since the last frame", view.get_changed_count());
+				ImGui::Separator();
+
+				ImGui::BeginChild("##MemoryRows", ImVec2(0, 0), ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar);
+				{
+					float row_height = ImGui::GetTextLineHeightWithSpacing();
+					if (scroll_to_row >= 0) {
+						ImGui::SetScrollY(scroll_to_row * row_height);
+						scroll_to_row = -1;
+					}
+
+					float byte_width = ImGui::CalcTextSize("FF").x;
+					const ImVec4 changed_colour = ImVec4(1.0f, 0.4f, 0.3f, 1.0f);
+
+					//4096 rows but only the ones on screen are submitted
+					ImGuiListClipper clipper;
+					clipper.Begin(0x10000 / BYTES_PER_ROW, row_height);
+					while (clipper.Step()) {
+						for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+							int row_address = row * BYTES_PER_ROW;
+							ImGui::Text("%04X:", row_address);
+
+							for (int column = 0; column < BYTES_PER_ROW; column++) {
+								int address = row_address + column;
+								ImGui::SameLine(0.0f, column == 8 ? byte_width : -1.0f);
+
+								bool changed = view.has_changed((ushort)address);
+								if (changed) {
+									ImGui::PushStyleColor(ImGuiCol_Text, changed_colour);
+								}
+
+								char label[16];
+								snprintf(label, sizeof(label), "%02X##%04X", bytes[address], address);
+								if (ImGui::Selectable(label, selected_address == address, 0, ImVec2(byte_width, 0))) {
+									selected_address = address;
+									snprintf(edit_value, sizeof(edit_value), "%02X", bytes[address]);
+								}
+
+								if (changed) {
+									ImGui::PopStyleColor();
+								}
+							}
+
+							//ascii column
+							char ascii[BYTES_PER_ROW + 1];
+							for (int column = 0; column < BYTES_PER_ROW; column++) {
+								byte value = bytes[row_address + column];
+								ascii[column] = (value >= 0x20 && value < 0x7f) ? (char)value : '.';
+							}
+							ascii[BYTES_PER_ROW] = '\0';
+							ImGui::SameLine(0.0f, byte_width);
+							ImGui::TextUnformatted(ascii);
+						}
+					}
+					clipper.End();
+				}
+				ImGui::EndChild();
+			}
+			ImGui::End();
+		}
+	}
+}
+
+void draw_performance_window(std::shared_ptr<Application> app) {
+	if (app->emu_initialised) {
+		if (app->performance_shown) {
+			const perf_stats& stats = app->get_perf_stats();
+			const perf_frame& frame = stats.last_frame;
+
+			//frame time history for the plot, one sample per emulated frame
+			static std::array<float, 120> frame_times = std::array<float, 120>();
+			static int frame_time_offset = 0;
+			static uint64_t last_frame_count = 0;
+			if (stats.frame_count != last_frame_count) {
+				uint64_t total_ns = 0;
+				for (const uint64_t& ns : frame.host_ns) {
+					total_ns += ns;
+				}
+
+				frame_times[frame_time_offset] = total_ns / 1000000.0f;
+				frame_time_offset = (frame_time_offset + 1) % (int)frame_times.size();
+				last_frame_count = stats.frame_count;
+			}
+
+			ImGui::Begin("Sharpboy++ Debug | Performance");
+			{
+				ImGui::SeparatorText("Rates");
+				ImGui::Text("Cycles/sec: %.0f (%.1f%%)", stats.cycles_per_second, (100.0 * stats.cycles_per_second) / 4194304.0);
+				ImGui::Text("Frames/sec: %.2f", stats.frames_per_second);
+
+				ImGui::SeparatorText("Host time per frame");
+				const char* component_names[perf_COMPONENT_COUNT] = { "CPU", "PPU", "Timers", "DMA", "Texture Upload", "ImGui" };
+				if (ImGui::BeginTable("##PerformanceComponents", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+					ImGui::TableSetupColumn("Component");
+					ImGui::TableSetupColumn("us");
+					ImGui::TableHeadersRow();
+
+					for (int i = 0; i < perf_COMPONENT_COUNT; i++) {
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(component_names[i]);
+						ImGui::TableNextColumn();
+						ImGui::Text("%.1f", frame.host_ns[i] / 1000.0);
+					}
+					ImGui::EndTable();
+				}
+				ImGui::PlotLines("##FrameTimes", frame_times.data(), (int)frame_times.size(), frame_time_offset, "frame ms", 0.0f, 20.0f, ImVec2(0, 60));
+
+				ImGui::SeparatorText("Counts per frame");
+				ImGui::Text("Instructions: %llu", (unsigned long long)frame.instructions);
+				ImGui::Text("Bus Reads: %llu", (unsigned long long)frame.bus_reads);
+				ImGui::Text("Bus Writes: %llu", (unsigned long long)frame.bus_writes);
+				ImGui::Text("Cycles: %llu", (unsigned long long)frame.cycles);
+#ifdef SHARPBOY_ALLOC_TRACKING
+				//counted on the main thread from one vblank to the next, so imgui's own allocations show up too
+				ImGui::Text("Allocations: %llu (%llu bytes)", (unsigned long long)frame.allocations, (unsigned long long)frame.allocated_bytes);
+#endif
+
+				ImGui::SeparatorText("Input latency (press to game read)");
+				const input_latency_stats& latency = app->get_input_latency();
+				if (latency.samples == 0) {
+					ImGui::TextDisabled("Press a button to measure");
+				}
+				else {
+					ImGui::Text("Last press: %d frames", latency.last_frames);
+					ImGui::Text("Average: %.2f frames over %llu presses", (double)latency.total_frames / latency.samples, (unsigned long long)latency.samples);
+				}
+
+				ImGui::SeparatorText("Timeline");
+				bool recording = timeline_is_recording();
+				if (ImGui::Checkbox("Record Timeline", &recording)) {
+					timeline_set_recording(recording);
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Export Chrome Trace")) {
+					timeline_request_export("timeline.json");
+				}
+			}
+			ImGui::End();
+		}
+	}
+}
+
+void draw_profiler(std::shared_ptr<Application> app) {
+#ifdef SHARPBOY_PROFILER
+	if (app->emu_initialised) {
+		if (app->profiler_shown) {
+			Profiler* profiler = app->get_profiler();
+
+			//aggregating every pc is too slow to redo each ui frame
+			static std::vector<profiler_entry> top_routines = std::vector<profiler_entry>();
+			static int top_count = 32;
+			if (ImGui::GetFrameCount() % 30 == 0 || top_routines.empty()) {
+				top_routines = profiler->get_top_routines(top_count);
+			}
+
+			ImGui::Begin("Sharpboy++ Debug | Profiler");
+			{
+				uint64_t total_cycles = profiler->get_total_cycles();
+				ImGui::Text("Cycles: %llu", (unsigned long long)total_cycles);
+				ImGui::Text("Symbols: %s", profiler->has_symbols() ? "loaded" : "none (place a .sym next to the rom)");
+
+				if (ImGui::Button("Reset")) {
+					profiler->reset();
+					top_routines.clear();
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Export Flamegraph")) {
+					profiler->export_collapsed_stacks("profile.folded");
+				}
+				ImGui::SameLine();
+				ImGui::PushItemWidth(80);
+				ImGui::InputInt("Top N", &top_count);
+				ImGui::PopItemWidth();
+				top_count = std::clamp(top_count, 1, 512);
+
+				if (ImGui::BeginTable("##ProfilerTopRoutines", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+					ImGui::TableSetupColumn("Routine");
+					ImGui::TableSetupColumn("Cycles");
+					ImGui::TableSetupColumn("%");
+					ImGui::TableHeadersRow();
+
+					for (const profiler_entry& entry : top_routines) {
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(entry.name.c_str());
+						ImGui::TableNextColumn();
+						ImGui::Text("%llu", (unsigned long long)entry.cycles);
+						ImGui::TableNextColumn();
+						ImGui::Text("%.2f", total_cycles == 0 ? 0.0 : (100.0 * entry.cycles) / total_cycles);
+					}
+					ImGui::EndTable();
+				}
+			}
+			ImGui::End();
+		}
+	}
+#endif
+}
+
+void draw_heatmap(std::shared_ptr<Application> app) {
+#ifdef SHARPBOY_HEATMAP
+	if (app->emu_initialised) {
+		if (app->heatmap_shown) {
+			Heatmap* heatmap = app->get_heatmap();
+
+			//created on first use, it goes away with the renderer
+			static SDL_Texture* heatmap_texture = nullptr;
+			if (heatmap_texture == nullptr) {
+				heatmap_texture = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, 256, 256);
+				SDL_SetTextureScaleMode(heatmap_texture, SDL_SCALEMODE_NEAREST);
+			}
+
+			//rebuilding the whole map every ui frame is wasted work, a few times a second is plenty
+			static std::array<uint32_t, 0x10000> pixels = std::array<uint32_t, 0x10000>();
+			static int view = heatmap_ALL;
+			static bool refresh_now = true;
+			if (refresh_now || ImGui::GetFrameCount() % 15 == 0) {
+				heatmap->fill_pixels(pixels, (heatmap_views)view);
+				SDL_UpdateTexture(heatmap_texture, nullptr, pixels.data(), 256 * sizeof(uint32_t));
+				refresh_now = false;
+			}
+
+			ImGui::Begin("Sharpboy++ Debug | Memory Heatmap");
+			{
+				refresh_now |= ImGui::RadioButton("All", &view, heatmap_ALL);
+				ImGui::SameLine();
+				refresh_now |= ImGui::RadioButton("Reads", &view, heatmap_READS);
+				ImGui::SameLine();
+				refresh_now |= ImGui::RadioButton("Writes", &view, heatmap_WRITES);
+				ImGui::SameLine();
+				refresh_now |= ImGui::RadioButton("Executes", &view, heatmap_EXECUTES);
+
+				if (ImGui::Button("Reset")) {
+					heatmap->reset();
+					refresh_now = true;
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Export Coverage")) {
+					heatmap->export_coverage("coverage.bin");
+				}
+
+				coverage_summary summary = heatmap->get_coverage_summary();
+				ImGui::Text("ROM coverage: %zu code bytes, %zu data bytes of %zu", summary.executed_bytes, summary.data_bytes, summary.rom_size);
+				ImGui::TextUnformatted("256 addresses per row, red writes, green reads, blue executes");
+
+				//one pixel per address, hovering shows which address and its counts
+				ImVec2 origin = ImGui::GetCursorScreenPos();
+				ImGui::Image((ImTextureID)heatmap_texture, ImVec2(256 * 2, 256 * 2));
+				if (ImGui::IsItemHovered()) {
+					ImVec2 mouse = ImGui::GetMousePos();
+					int x = std::clamp((int)((mouse.x - origin.x) / 2), 0, 255);
+					int y = std::clamp((int)((mouse.y - origin.y) / 2), 0, 255);
+					ushort address = (ushort)(y * 256 + x);
+
+					ImGui::SetTooltip("0x%04X\nReads: %u\nWrites: %u\nExecutes: %u", address,
+						heatmap->get_count(address, heatmap_READS), heatmap->get_count(address, heatmap_WRITES), heatmap->get_count(address, heatmap_EXECUTES));
+				}
+			}
+			ImGui::End();
+		}
+	}
+#endif
+}
+
 void draw_imgui(std::shared_ptr<Application> app, SDL_Texture** debug_tilemap_texture) {
 	ImGui_ImplSDLRenderer3_NewFrame();
 	ImGui_ImplSDL3_NewFrame();
@@ -251,7 +1128,15 @@ void draw_imgui(std::shared_ptr<Application> app, SDL_Texture** debug_tilemap_te
 
 	//debug information
 	draw_cpu_debugger(app);
+	draw_debugger(app);
+	draw_disassembly(app);
+	draw_memory_viewer(app);
+	draw_performance_window(app);
 	draw_ppu_tilemap(app, debug_tilemap_texture);
+	draw_bg_map_viewer(app);
+	draw_oam_viewer(app);
+	draw_profiler(app);
+	draw_heatmap(app);
 
 	ImGui::Render();
 }
@@ -289,6 +1174,11 @@ void close_SDL(SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** textu
 		*debug_tile_map_texture = nullptr;
 	}
 
+	for (SDL_Gamepad* gamepad : open_gamepads) {
+		SDL_CloseGamepad(gamepad);
+	}
+	open_gamepads.clear();
+
 	SDL_Quit();
 	printf("[SB] Quit SDL completed!\n");
 }
@@ -13,20 +13,31 @@ class Application;
 
 //initialisation
 void initialise_ImGui_components(SDL_Window** window, SDL_Renderer** renderer);
-void init_main_SDL_components(bool& sdl_running, SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, SDL_Texture** debug_tilemap_texture);
+void init_main_SDL_components(bool& sdl_running, SDL_Window** window, SDL_Renderer** renderer, SDL_Texture** texture, SDL_Texture** debug_tilemap_texture, frame_formats& frame_format);
+frame_formats choose_frame_format(SDL_Renderer** renderer);
+float get_display_refresh_rate(SDL_Window** window);
 
 //poll events
-void poll_SDL_events(SDL_Event* event, std::shared_ptr<Application> app);
+bool poll_SDL_events(SDL_Event* event, std::shared_ptr<Application> app);
+byte read_host_buttons();
 
 //sdl rendering
 void clear_background(SDL_Renderer** renderer, const int& r, const int& g, const int& b, const int& a);
 void present_renderer(SDL_Renderer** renderer);
-void update_gb_texture(SDL_Texture** texture, SDL_Renderer** renderer, std::shared_ptr<Application> app);
+bool update_gb_texture(SDL_Texture** texture, SDL_Renderer** renderer, std::shared_ptr<Application> app);
 void draw_gb_frame(SDL_Texture** texture, SDL_Renderer** renderer);
 
 //imgui
 void draw_ppu_tilemap(std::shared_ptr<Application> app, SDL_Texture** debug_tilemap_texture);
+void draw_bg_map_viewer(std::shared_ptr<Application> app);
+void draw_oam_viewer(std::shared_ptr<Application> app);
 void draw_cpu_debugger(std::shared_ptr<Application> app);
+void draw_debugger(std::shared_ptr<Application> app);
+void draw_disassembly(std::shared_ptr<Application> app);
+void draw_memory_viewer(std::shared_ptr<Application> app);
+void draw_performance_window(std::shared_ptr<Application> app);
+void draw_profiler(std::shared_ptr<Application> app);
+void draw_heatmap(std::shared_ptr<Application> app);
 void draw_imgui(std::shared_ptr<Application> app, SDL_Texture** debug_tilemap_texture);
 void render_imgui(SDL_Renderer** renderer);
 
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <initializer_list>
+#include <vector>
+
+//writes a 32k rom for the allocation test: a wram routine is rewritten and called in a loop so its block is built, invalidated
+//and recycled over and over, while a new rom routine gets hot every 256 passes so the cache keeps needing blocks it has not used yet
+//usage: sharpboy_smc_test_rom <output.gb>
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		printf("[SB] usage: sharpboy_smc_test_rom <output.gb>\n");
+		return -1;
+	}
+
+	std::vector<uint8_t> rom = std::vector<uint8_t>(0x8000, 0x00);
+	auto emit = [&rom](uint16_t& address, std::initializer_list<uint8_t> bytes) {
+		for (const uint8_t& value : bytes) {
+			rom[address++] = value;
+		}
+	};
+
+	//entry point: nop, jp $0150
+	uint16_t pc = 0x0100;
+	emit(pc, { 0x00, 0xc3, 0x50, 0x01 });
+
+	const char title[] = "SMC TEST";
+	for (int i = 0; title[i] != '\0'; i++) {
+		rom[0x134 + i] = (uint8_t)title[i];
+	}
+
+	//cartridge type, rom and ram size stay 0 (32k rom only), header checksum over $0134-$014c
+	uint8_t checksum = 0x00;
+	for (int address = 0x134; address <= 0x14c; address++) {
+		checksum = checksum - rom[address] - 1;
+	}
+	rom[0x14d] = checksum;
+
+	//rom routines at $4000 + 4 * n: inc a / ret
+	for (int n = 0; n < 0x100; n++) {
+		uint16_t address = (uint16_t)(0x4000 + n * 4);
+		emit(address, { 0x3c, 0xc9 });
+	}
+
+	pc = 0x0150;
+	emit(pc, { 0xf3 });                     //di
+	emit(pc, { 0x31, 0xf0, 0xdf });         //ld sp, $dff0
+
+	//wram routine at $c800: ld a, n / inc a / ret
+	emit(pc, { 0x3e, 0x3e, 0xea, 0x00, 0xc8 });
+	emit(pc, { 0x3e, 0x00, 0xea, 0x01, 0xc8 });
+	emit(pc, { 0x3e, 0x3c, 0xea, 0x02, 0xc8 });
+	emit(pc, { 0x3e, 0xc9, 0xea, 0x03, 0xc8 });
+
+	//16 bit pass counter at $c000
+	uint16_t loop_address = pc;
+	emit(pc, { 0xfa, 0x00, 0xc0 });         //ld a, ($c000)
+	emit(pc, { 0x3c });                     //inc a
+	emit(pc, { 0xea, 0x00, 0xc0 });         //ld ($c000), a
+	emit(pc, { 0x20, 0x04 });               //jr nz, +4
+	emit(pc, { 0x21, 0x01, 0xc0 });         //ld hl, $c001
+	emit(pc, { 0x34 });                     //inc (hl)
+
+	//patch the counter in as the routine's immediate and swap its inc a for dec a every other pass
+	emit(pc, { 0xea, 0x01, 0xc8 });         //ld ($c801), a
+	emit(pc, { 0xe6, 0x01 });               //and $01
+	emit(pc, { 0xc6, 0x3c });               //add $3c
+	emit(pc, { 0xea, 0x02, 0xc8 });         //ld ($c802), a
+
+	//called often enough to get hot and be cached before the next pass throws it away
+	for (int i = 0; i < 4; i++) {
+		emit(pc, { 0xcd, 0x00, 0xc8 });     //call $c800
+	}
+
+	//call rom routine n = counter high byte through a jp (hl)
+	emit(pc, { 0xfa, 0x01, 0xc0 });         //ld a, ($c001)
+	emit(pc, { 0x6f, 0x26, 0x00 });         //ld l, a / ld h, $00
+	emit(pc, { 0x29, 0x29 });               //add hl, hl / add hl, hl
+	emit(pc, { 0x7c, 0xc6, 0x40, 0x67 });   //ld a, h / add $40 / ld h, a
+	uint16_t trampoline_call = pc;
+	emit(pc, { 0xcd, 0x00, 0x00 });         //call trampoline, patched below
+	emit(pc, { 0xc3, (uint8_t)(loop_address & 0xff), (uint8_t)(loop_address >> 8) });
+
+	uint16_t trampoline_address = pc;
+	emit(pc, { 0xe9 });                     //jp (hl)
+	rom[trampoline_call + 1] = (uint8_t)(trampoline_address & 0xff);
+	rom[trampoline_call + 2] = (uint8_t)(trampoline_address >> 8);
+
+	std::ofstream output_file(argv[1], std::ios::binary);
+	if (!output_file) {
+		printf("[SB] Failed to open %s for writing\n", argv[1]);
+		return -2;
+	}
+
+	output_file.write((const char*)rom.data(), rom.size());
+	return 0;
+}
@@ -0,0 +1,254 @@
+#include "../src/emulator/Emulator.h"
+#include "../src/emulator/Instruction_trace.h"
+#include <vector>
+
+//finds the first instruction where two runs of a rom disagree
+//usage: sharpboy_divergence <rom.gb> [--engines <a> <b>] [--trace <reference.sbt>] [--interval <cycles>] [--max-cycles <cycles>]
+//two cores: both step in lockstep, state hashes are compared every interval cycles and a mismatch is
+//bisected from the last matching snapshot down to the instruction that caused it
+//trace: one core is checked against every record of a trace made by a known good build (see Instruction_trace.h)
+
+struct divergence_options {
+	std::string rom_file_name = "";
+	std::string trace_file_name = "";
+	cpu_engines engines[2] = { engine_INTERPRETER, engine_CACHED };
+	uint64_t interval = 4096;
+	uint64_t max_cycles = 4194304ull * 60;
+};
+
+static std::shared_ptr<Emulator> create_core(const std::string& rom_file_name, const cpu_engines& engine) {
+	std::shared_ptr<Emulator> core = std::make_shared<Emulator>();
+	core->set_emu_pointer(core);
+	if (core->initialise_emu_instance(rom_file_name, false) < 0) {
+		return nullptr;
+	}
+
+	core->set_cpu_engine(engine);
+	return core;
+}
+
+static std::vector<std::string> describe_state(std::shared_ptr<Emulator> core) {
+	std::vector<std::string> lines = std::vector<std::string>();
+	cpu_data data = core->get_cpu_data();
+	char line[96];
+
+	snprintf(line, sizeof(line), "cycle %llu", (unsigned long long)core->get_elapsed_cycles());
+	lines.push_back(line);
+	snprintf(line, sizeof(line), "AF:%04X BC:%04X DE:%04X HL:%04X", data.af, data.bc, data.de, data.hl);
+	lines.push_back(line);
+	snprintf(line, sizeof(line), "SP:%04X PC:%04X IME:%d HALT:%d", data.sp, data.pc, data.ime, data.halted);
+	lines.push_back(line);
+
+	for (int row = 0; row < 0x80; row += 0x10) {
+		int length = snprintf(line, sizeof(line), "FF%02X:", row);
+		for (int i = 0; i < 0x10; i++) {
+			length += snprintf(line + length, sizeof(line) - length, " %02X", core->memory_instant_read((ushort)(0xff00 + row + i)));
+		}
+		lines.push_back(line);
+	}
+
+	snprintf(line, sizeof(line), "IE:%02X", core->memory_instant_read(0xffff));
+	lines.push_back(line);
+	return lines;
+}
+
+//both states side by side, differing lines marked with *
+static void dump_states(std::shared_ptr<Emulator> core_a, std::shared_ptr<Emulator> core_b) {
+	std::vector<std::string> a = describe_state(core_a);
+	std::vector<std::string> b = describe_state(core_b);
+
+	for (size_t i = 0; i < a.size(); i++) {
+		printf("%c %-56s | %s\n", a[i] == b[i] ? ' ' : '*', a[i].c_str(), b[i].c_str());
+	}
+}
+
+static void run_steps(std::shared_ptr<Emulator> core_a, std::shared_ptr<Emulator> core_b, const uint64_t& steps) {
+	for (uint64_t i = 0; i < steps; i++) {
+		core_a->run_next_instruction();
+		core_b->run_next_instruction();
+	}
+}
+
+static int compare_cores(const divergence_options& options) {
+	std::shared_ptr<Emulator> core_a = create_core(options.rom_file_name, options.engines[0]);
+	std::shared_ptr<Emulator> core_b = create_core(options.rom_file_name, options.engines[1]);
+	if (core_a == nullptr || core_b == nullptr) {
+		return -2;
+	}
+
+	emulator_snapshot snapshot_a = emulator_snapshot();
+	emulator_snapshot snapshot_b = emulator_snapshot();
+	core_a->save_snapshot(snapshot_a);
+	core_b->save_snapshot(snapshot_b);
+	uint64_t steps_since_snapshot = 0;
+	uint64_t next_check = options.interval;
+
+	while (core_a->get_elapsed_cycles() < options.max_cycles) {
+		run_steps(core_a, core_b, 1);
+		steps_since_snapshot++;
+
+		if (core_a->get_elapsed_cycles() < next_check) {
+			continue;
+		}
+		next_check = core_a->get_elapsed_cycles() + options.interval;
+
+		if (core_a->get_state_hash() == core_b->get_state_hash()) {
+			core_a->save_snapshot(snapshot_a);
+			core_b->save_snapshot(snapshot_b);
+			steps_since_snapshot = 0;
+			continue;
+		}
+
+		//the snapshot matches and the current state does not, halve the steps in between until one is left
+		uint64_t good = 0;
+		uint64_t bad = steps_since_snapshot;
+		while (bad - good > 1) {
+			uint64_t middle = good + (bad - good) / 2;
+
+			core_a->load_snapshot(snapshot_a);
+			core_b->load_snapshot(snapshot_b);
+			run_steps(core_a, core_b, middle);
+
+			if (core_a->get_state_hash() == core_b->get_state_hash()) {
+				good = middle;
+			}
+			else {
+				bad = middle;
+			}
+		}
+
+		core_a->load_snapshot(snapshot_a);
+		core_b->load_snapshot(snapshot_b);
+		run_steps(core_a, core_b, good);
+
+		ushort pc = core_a->get_cpu_data().pc;
+		std::array<byte, 3> bytes = { core_a->memory_instant_read(pc), core_a->memory_instant_read((ushort)(pc + 1)), core_a->memory_instant_read((ushort)(pc + 2)) };
+		char instruction[32];
+		Disassembler::format_instruction(bytes, pc, instruction, sizeof(instruction));
+		printf("[SB] Divergence at cycle %llu, instruction at PC:%04X (%02X %02X %02X) %s\n", (unsigned long long)core_a->get_elapsed_cycles(), pc,
+			bytes[0], bytes[1], bytes[2], instruction);
+		printf("[SB] Before (engine %d | engine %d):\n", options.engines[0], options.engines[1]);
+		dump_states(core_a, core_b);
+
+		run_steps(core_a, core_b, 1);
+		printf("[SB] After:\n");
+		dump_states(core_a, core_b);
+		return 1;
+	}
+
+	printf("[SB] No divergence in %llu cycles\n", (unsigned long long)core_a->get_elapsed_cycles());
+	return 0;
+}
+
+static instruction_trace_record capture_record(std::shared_ptr<Emulator> core) {
+	cpu_data data = core->get_cpu_data();
+
+	instruction_trace_record trace_record = instruction_trace_record();
+	trace_record.cycle = core->get_elapsed_cycles();
+	trace_record.af = data.af;
+	trace_record.bc = data.bc;
+	trace_record.de = data.de;
+	trace_record.hl = data.hl;
+	trace_record.sp = data.sp;
+	trace_record.pc = data.pc;
+	for (int i = 0; i < 4; i++) {
+		trace_record.pc_bytes[i] = core->memory_instant_read((ushort)(data.pc + i));
+	}
+
+	return trace_record;
+}
+
+static int compare_with_trace(const divergence_options& options) {
+	FILE* input = fopen(options.trace_file_name.c_str(), "rb");
+	if (input == nullptr) {
+		printf("[SB] Failed to open %s\n", options.trace_file_name.c_str());
+		return -2;
+	}
+
+	char magic[sizeof(INSTRUCTION_TRACE_MAGIC)] = {};
+	if (fread(magic, 1, sizeof(magic), input) != sizeof(magic) || memcmp(magic, INSTRUCTION_TRACE_MAGIC, sizeof(magic)) != 0) {
+		printf("[SB] %s is not a Sharpboy++ instruction trace\n", options.trace_file_name.c_str());
+		fclose(input);
+		return -2;
+	}
+
+	std::shared_ptr<Emulator> core = create_core(options.rom_file_name, options.engines[0]);
+	if (core == nullptr) {
+		fclose(input);
+		return -2;
+	}
+
+	std::vector<instruction_trace_record> records = std::vector<instruction_trace_record>(4096);
+	uint64_t compared = 0;
+	size_t count = 0;
+
+	while ((count = fread(records.data(), sizeof(instruction_trace_record), records.size(), input)) > 0) {
+		for (size_t i = 0; i < count; i++) {
+			//halted steps are not traced
+			while (core->get_cpu_data().halted && core->get_elapsed_cycles() < records[i].cycle) {
+				core->run_next_instruction();
+			}
+
+			instruction_trace_record actual = capture_record(core);
+			if (memcmp(&actual, &records[i], sizeof(instruction_trace_record)) != 0) {
+				char line[128];
+				printf("[SB] Divergence at trace record %llu\n", (unsigned long long)(compared + i));
+				Instruction_trace::format_doctor_line(records[i], line, sizeof(line));
+				printf("[SB] Reference cycle %llu: %s", (unsigned long long)records[i].cycle, line);
+				Instruction_trace::format_doctor_line(actual, line, sizeof(line));
+				printf("[SB] Actual    cycle %llu: %s", (unsigned long long)actual.cycle, line);
+
+				for (const std::string& state_line : describe_state(core)) {
+					printf("  %s\n", state_line.c_str());
+				}
+
+				fclose(input);
+				return 1;
+			}
+
+			core->run_next_instruction();
+		}
+		compared += count;
+	}
+
+	fclose(input);
+	printf("[SB] No divergence in %llu trace records\n", (unsigned long long)compared);
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		printf("[SB] usage: sharpboy_divergence <rom.gb> [--engines <a> <b>] [--trace <reference.sbt>] [--interval <cycles>] [--max-cycles <cycles>]\n");
+		return -1;
+	}
+
+	divergence_options options = divergence_options();
+	options.rom_file_name = argv[1];
+
+	for (int i = 2; i < argc; i++) {
+		std::string option = argv[i];
+		if (option == "--engines" && i + 2 < argc) {
+			options.engines[0] = (cpu_engines)std::stoi(argv[++i]);
+			options.engines[1] = (cpu_engines)std::stoi(argv[++i]);
+		}
+		else if (option == "--trace" && i + 1 < argc) {
+			options.trace_file_name = argv[++i];
+		}
+		else if (option == "--interval" && i + 1 < argc) {
+			options.interval = std::max<uint64_t>(std::stoull(argv[++i]), 1);
+		}
+		else if (option == "--max-cycles" && i + 1 < argc) {
+			options.max_cycles = std::stoull(argv[++i]);
+		}
+		else {
+			printf("[SB] Unknown option %s\n", option.c_str());
+			return -1;
+		}
+	}
+
+	if (!options.trace_file_name.empty()) {
+		return compare_with_trace(options);
+	}
+
+	return compare_cores(options);
+}
@@ -0,0 +1,17 @@
+#include "../src/emulator/Instruction_trace.h"
+
+//turns a binary instruction trace into a gameboy-doctor log
+//usage: sharpboy_trace_to_doctor <trace.sbt> <output.log>
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		printf("[SB] usage: sharpboy_trace_to_doctor <trace.sbt> <output.log>\n");
+		return -1;
+	}
+
+	if (!Instruction_trace::convert_to_doctor_log(argv[1], argv[2])) {
+		return -2;
+	}
+
+	return 0;
+}